@@ -8,9 +8,9 @@ namespace CGEngine {
 		for (int i = 0; i < 100; i++) {
 			pose.push_back(glm::mat4(1.0f));
 		}
-		optional<id_t> animationId = assets.getId<Animation>(animationName);
+		optional<id_t> animationId = assets->getId<Animation>(animationName);
 		if (animationId.has_value()) {
-			currentAnimation = assets.get<Animation>(animationId.value());
+			currentAnimation = assets->get<Animation>(animationId.value());
 			currentTime = 0.0f;
 		}
 		else {
@@ -40,9 +40,9 @@ namespace CGEngine {
 	}
 
 	void Animator::playAnimation(const string& animationName) {
-		optional<id_t> animationId = assets.getId<Animation>(animationName);
+		optional<id_t> animationId = assets->getId<Animation>(animationName);
 		if (animationId.has_value()) {
-			currentAnimation = assets.get<Animation>(animationId.value());
+			currentAnimation = assets->get<Animation>(animationId.value());
 			currentTime = 0.0f;
 		}
 		else {
@@ -9,6 +9,11 @@ namespace CGEngine {
 	class AssetLoader {
 	public:
 		virtual unique_ptr<IResource> load(const filesystem::path& resourcePath) = 0;
+		//Read and decode the resource file without OpenGL or the engine systems, so it can be done on a worker thread. Returns null if the
+		//loader has nothing to prepare, in which case loadPrepared does all of the work.
+		virtual shared_ptr<void> prepare(const filesystem::path& /*resourcePath*/) { return nullptr; }
+		//Create the resource from what prepare returned
+		virtual unique_ptr<IResource> loadPrepared(const filesystem::path& resourcePath, shared_ptr<void> /*prepared*/) { return load(resourcePath); }
 	protected:
 		LogLevel logLevel = LogLevel::LogInfo;
 		void logMessage(LogLevel level, const string& msg) {
@@ -32,6 +37,26 @@ namespace CGEngine {
 			}
 			return nullptr;
 		}
+
+		shared_ptr<void> prepare(const filesystem::path& resourcePath) override {
+			//Decoding the image is most of the work, and only uploading it needs OpenGL
+			auto image = std::make_shared<Image>();
+			if (filesystem::exists(resourcePath) && image->loadFromFile(resourcePath)) {
+				return image;
+			}
+			return nullptr;
+		}
+
+		unique_ptr<IResource> loadPrepared(const filesystem::path& resourcePath, shared_ptr<void> prepared) override {
+			if (!prepared) return load(resourcePath);
+			auto resource = std::make_unique<TextureResource>();
+			auto texture = std::make_unique<Texture>();
+			if (texture->loadFromImage(*static_pointer_cast<Image>(prepared))) {
+				resource->setTexture(texture.release());
+				return resource;
+			}
+			return nullptr;
+		}
 	};
 
 	class FontLoader : public AssetLoader {
@@ -3,10 +3,12 @@
 #include <unordered_map>
 #include <memory>
 #include <typeindex>
+#include <shared_mutex>
 #include <filesystem>
 #include "../Engine/EngineSystem.h"
 #include "../Shader/Program.h"
 #include "AssetLoader.h"
+#include "../Mesh/Prefab.h"
 
 namespace CGEngine {
 	class VertexShaderResource : public IResource {
@@ -57,6 +59,7 @@ namespace CGEngine {
 			registerResourceType<VertexShaderResource>("vertexShaders", make_unique<VertexShaderLoader>());
 			registerResourceType<FragmentShaderResource>("fragmentShaders", make_unique<FragmentShaderLoader>());
 			registerResourceType<Model>("models", make_unique<ModelLoader>());
+			registerResourceType<Prefab>("prefabs");
 			registerResourceType<MeshData>("meshData");
 			registerResourceType<Program>("programs");
 			registerResourceType<Material>("materials");
@@ -67,7 +70,20 @@ namespace CGEngine {
 		}
 
 		// Add new initialization method
-		void initialize() {
+		void initialize(bool graphicsEnabled = true) {
+			//Without an OpenGL context (headless), only the default font is loaded
+			if (graphicsEnabled) {
+				initializeGraphics();
+			}
+
+			//Load default font
+			optional<id_t> defaultFontId = setDefaultId<FontResource>(load<FontResource>("fonts/defaultFont.ttf", defaultFontName));
+			if (!defaultFontId.has_value()) {
+				logMessage(LogError, "Failed to load default font!");
+			}
+		}
+
+		void initializeGraphics() {
 			//Load default texture
 			optional<id_t> defaultTextureId = setDefaultId<TextureResource>(load<TextureResource>("checkered_tile.png", defaultTextureName));
 			if(!defaultTextureId.has_value()){
@@ -87,12 +103,6 @@ namespace CGEngine {
 					logMessage(LogError, "Failed to create default material!");
 				}
 			}
-
-			//Load default font
-			optional<id_t> defaultFontId = setDefaultId<FontResource>(load<FontResource>("fonts/defaultFont.ttf", defaultFontName));
-			if (!defaultFontId.has_value()) {
-				logMessage(LogError, "Failed to load default font!");
-			}
 		}
 
 		~AssetManager() {
@@ -106,10 +116,13 @@ namespace CGEngine {
 		template<typename T>
 		void registerResourceType(const string& typeName, unique_ptr<AssetLoader> loader = nullptr) {
 			type_index typeId = type_index(typeid(T));
-			resourceContainers[typeId] = make_pair(typeName, ResourceContainer());
-			resourceDefaultIds[typeId] = nullopt;
-			if (loader) {
-				resourceLoaders[typeId] = move(loader);
+			{
+				unique_lock lock(assetMutex);
+				resourceContainers[typeId] = make_pair(typeName, ResourceContainer());
+				resourceDefaultIds[typeId] = nullopt;
+				if (loader) {
+					resourceLoaders[typeId] = move(loader);
+				}
 			}
 			string logMsg = string("Registered resource type: ").append(typeName);
 			logMessage(LogInfo, logMsg);
@@ -128,17 +141,16 @@ namespace CGEngine {
 		*/
 		template<typename T>
 		T* get(const string& resourceName) {
-			type_index typeId = type_index(typeid(T));
-			if (!hasResourceType<T>()) {
-				string logMsg = string("Attempted to get unregistered resource type: ").append(typeid(T).name());
-				logMessage(LogInfo, logMsg);
+			shared_lock lock(assetMutex);
+			const ResourceContainer* container = findContainer(type_index(typeid(T)));
+			if (!container) {
+				logUnregistered("get", typeid(T).name());
 				return nullptr;
 			}
 
-			auto& container = resourceContainers[typeId].second;
-			auto it = container.nameToId.find(resourceName);
-			if (it != container.nameToId.end()) {
-				return static_cast<T*>(container.resources.get(it->second).resource.get());
+			auto it = container->nameToId.find(resourceName);
+			if (it != container->nameToId.end()) {
+				return static_cast<T*>(container->resources.get(it->second).resource.get());
 			}
 
 			return nullptr;
@@ -151,33 +163,19 @@ namespace CGEngine {
 		*/
 		template<typename T>
 		T* get(id_t id) {
-			type_index typeId = type_index(typeid(T));
-			if (!hasResourceType<T>()) {
-				string logMsg = string("Attempted to get unregistered resource type: ").append(typeid(T).name());
-				logMessage(LogInfo, logMsg);
-				return nullptr;
-			}
-
-			auto& container = resourceContainers[typeId].second;
-			// Get the ResourceEntry directly, not as a pointer
-			ResourceEntry entry = container.resources.get(id);
-			// Check if it's valid (we could check if the resource pointer is not null)
-			if (entry.resource) {
-				return static_cast<T*>(entry.resource.get());
-			}
-			return nullptr;
+			return static_cast<T*>(get(type_index(typeid(T)), id));
 		}
 
 		IResource* get(type_index typeId, id_t id) {
-			if (!hasResourceType(typeId)) {
-				string logMsg = string("Attempted to get unregistered resource type: ").append(typeId.name());
-				logMessage(LogInfo, logMsg);
+			shared_lock lock(assetMutex);
+			const ResourceContainer* container = findContainer(typeId);
+			if (!container) {
+				logUnregistered("get", typeId.name());
 				return nullptr;
 			}
 
-			auto& container = resourceContainers[typeId].second;
 			// Get the ResourceEntry directly, not as a pointer
-			ResourceEntry entry = container.resources.get(id);
+			ResourceEntry entry = container->resources.get(id);
 			// Check if it's valid (we could check if the resource pointer is not null)
 			if (entry.resource) {
 				return static_cast<IResource*>(entry.resource.get());
@@ -185,6 +183,23 @@ namespace CGEngine {
 			return nullptr;
 		}
 
+		/**
+		* Get shared ownership of a resource of T type by id. Unlike get, the resource stays alive while the
+		* returned pointer is held, even if it is removed from the manager by another thread.
+		* @param id Id of the resource to retrieve
+		* @return Shared pointer to the resource or nullptr if not found
+		*/
+		template<typename T>
+		shared_ptr<T> getShared(id_t id) {
+			shared_lock lock(assetMutex);
+			const ResourceContainer* container = findContainer(type_index(typeid(T)));
+			if (!container) {
+				logUnregistered("get", typeid(T).name());
+				return nullptr;
+			}
+			return static_pointer_cast<T>(container->resources.get(id).resource);
+		}
+
 		string getResourceName(const filesystem::path& path, const string& providedName) {
 			return providedName.empty() ? path.filename().string() : providedName;
 		}
@@ -196,16 +211,15 @@ namespace CGEngine {
 		*/
 		template<typename T>
 		optional<id_t> getId(const string& resourceName) {
-			type_index typeId = type_index(typeid(T));
-			if (!hasResourceType<T>()) {
-				string logMsg = string("Attempted to get ID for unregistered resource type: ").append(typeid(T).name());
-				logMessage(LogInfo, logMsg);
+			shared_lock lock(assetMutex);
+			const ResourceContainer* container = findContainer(type_index(typeid(T)));
+			if (!container) {
+				logUnregistered("get ID for", typeid(T).name());
 				return nullopt; // Invalid resource type
 			}
 
-			auto& container = resourceContainers[typeId].second;
-			auto it = container.nameToId.find(resourceName);
-			if (it != container.nameToId.end()) {
+			auto it = container->nameToId.find(resourceName);
+			if (it != container->nameToId.end()) {
 				return it->second;
 			}
 
@@ -219,17 +233,16 @@ namespace CGEngine {
 		*/
 		template<typename T>
 		optional<id_t> getId(const T* resource) {
-			type_index typeId = type_index(typeid(T));
-			if (!hasResourceType<T>()) {
-				string logMsg = string("Attempted to get ID for unregistered resource type: ").append(typeid(T).name());
-				logMessage(LogInfo, logMsg);
+			shared_lock lock(assetMutex);
+			const ResourceContainer* container = findContainer(type_index(typeid(T)));
+			if (!container) {
+				logUnregistered("get ID for", typeid(T).name());
 				return nullopt; //Invalid resource type
 			}
 
-			auto& container = resourceContainers[typeId].second;
-			// Search through resources to find matching pointer
-			for (const auto& [id, entry] : container.resources) {
-				if (static_cast<T*>(entry.resource.get()) == resource) {
+			// Search through the name mapping to find matching pointer
+			for (const auto& [name, id] : container->nameToId) {
+				if (static_cast<T*>(container->resources.get(id).resource.get()) == resource) {
 					return id;
 				}
 			}
@@ -237,6 +250,43 @@ namespace CGEngine {
 			return nullopt; // Resource not found
 		}
 
+		/**
+		* Get the name of a resource of T type by id
+		* @param id Id of the resource
+		* @return Optional name of the resource. Nullopt if not found.
+		*/
+		template<typename T>
+		optional<string> getName(id_t id) {
+			shared_lock lock(assetMutex);
+			const ResourceContainer* container = findContainer(type_index(typeid(T)));
+			if (!container || !container->resources.has(id)) {
+				return nullopt;
+			}
+			return container->resources.get(id).name;
+		}
+
+		/**
+		* Find the name of the first resource of T type matching the predicate
+		* @param predicate Function returning true for the resource to find
+		* @return Optional name of the resource. Nullopt if not found.
+		*/
+		template<typename T>
+		optional<string> findName(function<bool(T*)> predicate) {
+			shared_lock lock(assetMutex);
+			const ResourceContainer* container = findContainer(type_index(typeid(T)));
+			if (!container) {
+				return nullopt;
+			}
+
+			optional<string> foundName = nullopt;
+			container->resources.forEach([&foundName, &predicate](ResourceEntry entry) {
+				if (!foundName.has_value() && entry.resource && predicate(static_cast<T*>(entry.resource.get()))) {
+					foundName = entry.name;
+				}
+			});
+			return foundName;
+		}
+
 		/**
 		 * Check if a resource exists
 		 * @param resourceName Name of the resource to check
@@ -244,23 +294,23 @@ namespace CGEngine {
 		 */
 		template<typename T>
 		bool has(const string& resourceName) {
-		std::type_index typeId = type_index(typeid(T));
-			if (!hasResourceType<T>()) {
+			shared_lock lock(assetMutex);
+			const ResourceContainer* container = findContainer(type_index(typeid(T)));
+			if (!container) {
 				return false;
 			}
 
-			auto& container = resourceContainers[typeId].second;
-			return container.nameToId.find(resourceName) != container.nameToId.end();
+			return container->nameToId.find(resourceName) != container->nameToId.end();
 		}
 
 		template<typename T>
 		size_t getResourceCount() {
-			type_index typeId = type_index(typeid(T));
-			if (!hasResourceType<T>()) {
+			shared_lock lock(assetMutex);
+			const ResourceContainer* container = findContainer(type_index(typeid(T)));
+			if (!container) {
 				return 0;
 			}
-			auto& container = resourceContainers[typeId].second;
-			return container.resources.size();
+			return container->resources.size();
 		}
 
 		/**
@@ -269,14 +319,20 @@ namespace CGEngine {
 		template<typename T>
 		void clearType() {
 			type_index typeId = type_index(typeid(T));
-			if (!hasResourceType<T>()) {
-				return;
+			vector<shared_ptr<IResource>> released;
+			string typeName;
+			{
+				unique_lock lock(assetMutex);
+				auto containerIterator = resourceContainers.find(typeId);
+				if (containerIterator == resourceContainers.end()) {
+					return;
+				}
+				typeName = containerIterator->second.first;
+				releaseAll(containerIterator->second.second, released);
 			}
-
-			auto& container = resourceContainers[typeId].second;
-			container.resources.clear();
-			container.nameToId.clear();
-			string logMsg = string("Cleared all resources of type: ").append(resourceContainers[typeId].first);
+			//Resources are destroyed outside the lock so their destructors can use the manager
+			released.clear();
+			string logMsg = string("Cleared all resources of type: ").append(typeName);
 			logMessage(LogInfo, logMsg);
 		}
 
@@ -284,10 +340,18 @@ namespace CGEngine {
 		* Clear all resources
 		*/
 		void clear() {
-			for (auto& [typeId, typePair] : resourceContainers) {
-				typePair.second.resources.clear();
-				typePair.second.nameToId.clear();
-				string logMsg = string("Cleared all resources of type : ").append(typePair.first);
+			vector<shared_ptr<IResource>> released;
+			vector<string> typeNames;
+			{
+				unique_lock lock(assetMutex);
+				for (auto& [typeId, typePair] : resourceContainers) {
+					releaseAll(typePair.second, released);
+					typeNames.push_back(typePair.first);
+				}
+			}
+			released.clear();
+			for (const string& typeName : typeNames) {
+				string logMsg = string("Cleared all resources of type : ").append(typeName);
 				logMessage(LogInfo, logMsg);
 			}
 		}
@@ -296,11 +360,11 @@ namespace CGEngine {
 		* Load a Texture, Font, or Shader resource from a file path
 		* @param resourcePath Path to the resource file
 		* @param resourceName Name to reference the resource (defaults to filename)
-		* @param args Arguments to decode for loading. Used to pass shaderType.
+		* @param prepared What the resource type's loader returned from prepare, if it was prepared ahead of time
 		* @return Optional id of loaded resource. Nullopt if loading failed.
 		*/
 		template<typename T>
-		optional<id_t> load(const filesystem::path& resourcePath, const string& resourceName = "") {
+		optional<id_t> load(const filesystem::path& resourcePath, const string& resourceName = "", shared_ptr<void> prepared = nullptr) {
 			//Require a resourcePath or resourceName
 			if (resourcePath.empty() && resourceName.empty()) return nullopt;
 			type_index resourceTypeId = type_index(typeid(T));
@@ -319,27 +383,27 @@ namespace CGEngine {
 				T* existingResource = get<T>(existingResourceId.value());
 				//Return if existingResource is valid or remove the container mapping if not
 				if (existingResource && existingResource->isValid()) {
-					logMessage(LogInfo, string("Found '").append(resourceContainers[resourceTypeId].first).append("' Resource '").append(resourceName).append("' with path '").append(resourcePath.filename().string()).append("'"));
+					logMessage(LogInfo, string("Found '").append(getTypeName(resourceTypeId)).append("' Resource '").append(resourceName).append("' with path '").append(resourcePath.filename().string()).append("'"));
 					return existingResourceId.value();
 				} else {
 					//Remove container mapping for invalid resource
-					auto& container = resourceContainers[resourceTypeId].second;
-					container.nameToId.erase(assetName);
-					container.resources.remove(existingResourceId.value());
+					removeMapping(resourceTypeId, assetName, existingResourceId.value());
 					logMessage(LogWarn, "Invalid resource mapping. Deleting '" + assetName+"'");
 				}
 			}
 
 			unique_ptr<IResource> resource = nullptr;
-			if (resourceLoaders.find(resourceTypeId) == resourceLoaders.end()) {
+			AssetLoader* loader = findLoader(resourceTypeId);
+			if (!loader) {
 				string logMsg = string("No loader implemented for resource type: ").append(typeid(T).name());
 				logMessage(LogError, logMsg);
 				return nullopt;
 			}
 			else {
 				logMessage(LogInfo, string("Using loader for resource type: ").append(typeid(T).name()));
-				//Load the resource using the appropriate loader
-				resource = resourceLoaders[resourceTypeId]->load(resourcePath);
+				//Load the resource using the appropriate loader. The manager isn't locked while loading, so other threads
+				//can keep resolving resources.
+				resource = prepared ? loader->loadPrepared(resourcePath, prepared) : loader->load(resourcePath);
 				//If resource was not loaded successfully and the resourceType has a defaultId
 				if (!resource && hasDefaultId(resourceTypeId)) {
 					//Get the default id for the resource type and try to load it
@@ -360,17 +424,33 @@ namespace CGEngine {
 					logMessage(LogError, string("Resource type mismatch when loading: ").append(assetName));
 					return nullopt;
 				}
-				id_t resourceId = add<T>(assetName, std::move(resource));
+				auto [resourceId, added] = addOrFind<T>(assetName, std::move(resource));
+				if (!added) {
+					//Another thread loaded the same name first
+					return resourceId;
+				}
 				rawPtr->setId(resourceId);
-				string logMsg = string("Loaded '").append(resourceContainers[resourceTypeId].first).append("' Resource '").append(assetName).append("' from '").append(resourcePath.filename().string()).append("' ID:").append(to_string(resourceId));
+				string logMsg = string("Loaded '").append(getTypeName(resourceTypeId)).append("' Resource '").append(assetName).append("' from '").append(resourcePath.filename().string()).append("' ID:").append(to_string(resourceId));
 				logMessage(LogInfo, logMsg);
-				logMessage(LogInfo, string("Resource '").append(resourceContainers[resourceTypeId].first).append("' Count:").append(to_string(resourceContainers[resourceTypeId].second.resources.size())));
+				logMessage(LogInfo, string("Resource '").append(getTypeName(resourceTypeId)).append("' Count:").append(to_string(getResourceCount<T>())));
 				return resourceId;
 			}
 
 			return nullopt;
 		}
 
+		/**
+		* Read and decode a resource file of T type ahead of loading it. Doesn't use OpenGL or add the resource, so it can be called from
+		* a worker thread, and the result is passed to load on the main thread.
+		* @param resourcePath Path to the resource file
+		* @return The prepared data, or nullptr if the type's loader has nothing to prepare
+		*/
+		template<typename T>
+		shared_ptr<void> prepare(const filesystem::path& resourcePath) {
+			AssetLoader* loader = findLoader(type_index(typeid(T)));
+			return loader ? loader->prepare(resourcePath) : nullptr;
+		}
+
 		/**
 		* Create a resource from memory rather than loading from disk
 		* @param resourceName Name to reference the resource
@@ -392,14 +472,12 @@ namespace CGEngine {
 				//Return if existingResource is valid or remove the container mapping if not
 				T* existingResource = get<T>(existingResourceId.value());
 				if (existingResource && existingResource->isValid()) {
-					logMessage(LogInfo, string("Found '").append(resourceContainers[resourceTypeId].first).append("' Resource: ").append(resourceName));
+					logMessage(LogInfo, string("Found '").append(getTypeName(resourceTypeId)).append("' Resource: ").append(resourceName));
 					return existingResourceId.value();
 				}
 				else {
 					//Remove container mapping for invalid resource
-					auto& container = resourceContainers[resourceTypeId].second;
-					container.nameToId.erase(resourceName);
-					container.resources.remove(existingResourceId.value());
+					removeMapping(resourceTypeId, resourceName, existingResourceId.value());
 					logMessage(LogWarn, "Invalid resource mapping. Deleting '" + resourceName + "'");
 				}
 			}
@@ -418,28 +496,34 @@ namespace CGEngine {
 			// Store raw pointer for setting ID after ownership transfer
 			T* rawPtr = resource.get();
 
-			// Transfer ownership to add method
-			id_t resourceId = add<T>(resourceName, std::move(resource));
+			// Transfer ownership to addOrFind
+			auto [resourceId, added] = addOrFind<T>(resourceName, std::move(resource));
+			if (!added) {
+				//Another thread created the same name first
+				return resourceId;
+			}
 			rawPtr->setId(resourceId);
 
-			string logMsg = string("Created '").append(resourceContainers[resourceTypeId].first).append("' Resource '").append(resourceName).append("' ID:").append(to_string(resourceId));
+			string logMsg = string("Created '").append(getTypeName(resourceTypeId)).append("' Resource '").append(resourceName).append("' ID:").append(to_string(resourceId));
 			logMessage(LogInfo, logMsg);
-			logMessage(LogInfo, string("Resource '").append(resourceContainers[resourceTypeId].first).append("' Count: ").append(to_string(resourceContainers[resourceTypeId].second.resources.size())));
+			logMessage(LogInfo, string("Resource '").append(getTypeName(resourceTypeId)).append("' Count: ").append(to_string(getResourceCount<T>())));
 			return resourceId;
 		}
 
 		//Get the default id for T type
 		template<typename T>
 		optional<id_t> getDefaultId() {
-			type_index typeId = type_index(typeid(T));
-			return resourceDefaultIds[typeId];
+			return getDefaultId(type_index(typeid(T)));
 		}
 
 		optional<id_t> getDefaultId(type_index typeId) {
-			return resourceDefaultIds[typeId];
+			shared_lock lock(assetMutex);
+			auto it = resourceDefaultIds.find(typeId);
+			return it != resourceDefaultIds.end() ? it->second : nullopt;
 		}
 
 		bool hasDefaultId(type_index typeId) {
+			shared_lock lock(assetMutex);
 			return resourceDefaultIds.find(typeId) != resourceDefaultIds.end();
 		}
 
@@ -447,20 +531,115 @@ namespace CGEngine {
 		//then add that to the container.resources and container.nameToId
 		template<typename T>
 		id_t add(const string& name, unique_ptr<IResource> resource) {
-			auto& container = getContainer<T>();
 			// Create the ResourceEntry with a shared_ptr that takes ownership from the unique_ptr
 			ResourceEntry entry{ std::shared_ptr<IResource>(resource.release()), name };
-			id_t id = container.resources.add(entry);
-			container.nameToId[name] = id;
+			unique_lock lock(assetMutex);
+			ResourceContainer* container = findContainer(type_index(typeid(T)));
+			if (!container) {
+				return 0;
+			}
+			id_t id = container->resources.add(entry);
+			container->nameToId[name] = id;
 			return id;
 		}
 
+		/**
+		* Add a batch of resources of T type in one pass. Ids for the whole batch are taken up front
+		* and a single summary is logged instead of a message per resource.
+		* @param resources Pairs of resource name and resource. Ownership of each resource is transferred.
+		* @return Ids of the added resources in the same order as resources
+		*/
+		template<typename T>
+		vector<id_t> addBatch(vector<pair<string, unique_ptr<IResource>>>& resources) {
+			type_index resourceTypeId = type_index(typeid(T));
+			if (!hasResourceType<T>()) {
+				logUnregistered("add batch of", typeid(T).name());
+				return {};
+			}
+
+			vector<ResourceEntry> entries;
+			entries.reserve(resources.size());
+			for (auto& [name, resource] : resources) {
+				entries.push_back(ResourceEntry{ std::shared_ptr<IResource>(resource.release()), name });
+			}
+			resources.clear();
+
+			vector<id_t> ids;
+			size_t count = 0;
+			{
+				unique_lock lock(assetMutex);
+				ResourceContainer* container = findContainer(resourceTypeId);
+				if (container) {
+					ids = container->resources.add(entries);
+					container->nameToId.reserve(container->nameToId.size() + ids.size());
+					for (size_t i = 0; i < ids.size(); i++) {
+						container->nameToId[entries[i].name] = ids[i];
+						entries[i].resource->setId(ids[i]);
+					}
+					count = container->resources.size();
+				}
+			}
+			logMessage(LogInfo, string("Added batch of ").append(to_string(ids.size())).append(" '").append(getTypeName(resourceTypeId)).append("' Resources. Count: ").append(to_string(count)));
+			return ids;
+		}
+
+		/**
+		* Remove a batch of resources of T type by id. The resources are released after the container
+		* is updated and unlocked, so resource destructors never see a partially updated container.
+		* @param ids Ids of the resources to remove
+		*/
+		template<typename T>
+		void remove(const vector<id_t>& ids) {
+			type_index resourceTypeId = type_index(typeid(T));
+			if (ids.empty()) {
+				return;
+			}
+
+			vector<shared_ptr<IResource>> removed;
+			size_t count = 0;
+			{
+				unique_lock lock(assetMutex);
+				ResourceContainer* container = findContainer(resourceTypeId);
+				if (!container) {
+					return;
+				}
+				removed.reserve(ids.size());
+				for (id_t id : ids) {
+					if (!container->resources.has(id)) continue;
+					ResourceEntry entry = container->resources.get(id);
+					auto nameIterator = container->nameToId.find(entry.name);
+					if (nameIterator != container->nameToId.end() && nameIterator->second == id) {
+						container->nameToId.erase(nameIterator);
+					}
+					container->resources.remove(id);
+					removed.push_back(entry.resource);
+				}
+				count = container->resources.size();
+			}
+			size_t removedCount = removed.size();
+			removed.clear();
+
+			logMessage(LogInfo, string("Removed ").append(to_string(removedCount)).append(" '").append(getTypeName(resourceTypeId)).append("' Resources. Count: ").append(to_string(count)));
+		}
+
+		/**
+		* Remove a resource of T type by id
+		* @param id Id of the resource to remove
+		*/
+		template<typename T>
+		void remove(id_t id) {
+			remove<T>(vector<id_t>{ id });
+		}
+
 		string defaultTextureName = "default_texture";
 		string defaultProgramName = "default_program";
 		string defaultMaterialName = "default_material";
 		string defaultFontName = "default_font";
-		unordered_map<type_index, optional<id_t>> resourceDefaultIds;
 	private:
+		//Readers (get, getId, has, counts and default ids) share the lock, so any thread can resolve resources in parallel.
+		//Registering, adding, removing and clearing take it exclusively. Loaders and resource destructors run unlocked.
+		mutable shared_mutex assetMutex;
+		unordered_map<type_index, optional<id_t>> resourceDefaultIds;
 		//ResourceTypeName string, ResourceContainer mapped to ResourceType type_index
 		unordered_map<type_index, pair<string, ResourceContainer>> resourceContainers;
 		unordered_map<type_index, unique_ptr<AssetLoader>> resourceLoaders;
@@ -468,25 +647,87 @@ namespace CGEngine {
 		//Check if the resource type is registered
 		template<typename T>
 		bool hasResourceType() {
-			type_index typeId = type_index(typeid(T));
-			return resourceContainers.find(typeId) != resourceContainers.end();
+			return hasResourceType(type_index(typeid(T)));
 		}
 
 		bool hasResourceType(type_index typeId) {
+			shared_lock lock(assetMutex);
 			return resourceContainers.find(typeId) != resourceContainers.end();
 		}
 
-		//Get the ResourceContainer of the indicated T type
+		//Find the ResourceContainer of a type without inserting one. The caller must hold assetMutex.
+		ResourceContainer* findContainer(type_index typeId) {
+			auto it = resourceContainers.find(typeId);
+			return it != resourceContainers.end() ? &it->second.second : nullptr;
+		}
+
+		AssetLoader* findLoader(type_index typeId) {
+			shared_lock lock(assetMutex);
+			auto it = resourceLoaders.find(typeId);
+			return it != resourceLoaders.end() ? it->second.get() : nullptr;
+		}
+
+		string getTypeName(type_index typeId) {
+			shared_lock lock(assetMutex);
+			auto it = resourceContainers.find(typeId);
+			return it != resourceContainers.end() ? it->second.first : string(typeId.name());
+		}
+
+		void logUnregistered(const string& action, const char* typeName) {
+			logMessage(LogInfo, string("Attempted to ").append(action).append(" unregistered resource type: ").append(typeName));
+		}
+
+		//Add the resource unless a valid resource was added with the same name since it was looked up.
+		//Returns the id of the resource with that name, and whether it is the one passed in.
 		template<typename T>
-		ResourceContainer& getContainer() {
-			type_index typeId = type_index(typeid(T));
-			return resourceContainers[typeId].second;
+		pair<id_t, bool> addOrFind(const string& name, unique_ptr<IResource> resource) {
+			//Parameters outlive the lock, so a discarded resource is destroyed unlocked
+			unique_lock lock(assetMutex);
+			ResourceContainer* container = findContainer(type_index(typeid(T)));
+			if (!container) {
+				return { 0, false };
+			}
+			auto it = container->nameToId.find(name);
+			if (it != container->nameToId.end()) {
+				ResourceEntry existing = container->resources.get(it->second);
+				if (existing.resource && existing.resource->isValid()) {
+					return { it->second, false };
+				}
+			}
+			id_t id = container->resources.add(ResourceEntry{ shared_ptr<IResource>(resource.release()), name });
+			container->nameToId[name] = id;
+			return { id, true };
+		}
+
+		//Remove an invalid resource's name mapping, unless another thread has replaced it already
+		void removeMapping(type_index typeId, const string& name, id_t id) {
+			shared_ptr<IResource> released;
+			unique_lock lock(assetMutex);
+			ResourceContainer* container = findContainer(typeId);
+			if (!container) return;
+			auto it = container->nameToId.find(name);
+			if (it != container->nameToId.end() && it->second == id) {
+				container->nameToId.erase(it);
+			}
+			//Declared before the lock, so the resource is destroyed after unlocking
+			released = container->resources.get(id).resource;
+			container->resources.remove(id);
+		}
+
+		//Move every resource of a container into released and empty it. The caller must hold assetMutex exclusively.
+		void releaseAll(ResourceContainer& container, vector<shared_ptr<IResource>>& released) {
+			container.resources.forEach([&released](ResourceEntry entry) {
+				released.push_back(entry.resource);
+			});
+			container.resources.clear();
+			container.nameToId.clear();
 		}
 
 		//Set the default id for T type
 		template<typename T>
 		optional<id_t> setDefaultId(optional<id_t> defaultId) {
 			type_index typeId = type_index(typeid(T));
+			unique_lock lock(assetMutex);
 			resourceDefaultIds[typeId] = defaultId;
 			return defaultId;
 		}
@@ -10,6 +10,10 @@ namespace CGEngine {
 		scripts.initialize();
 	};
 
+	id_t Behavior::addScript(domainId_t domainId, Script* script) {
+		return scripts.addScript(domainId, script);
+	}
+
 	id_t Behavior::addScript(string domain, Script* script) {
 		return scripts.addScript(domain, script);
 	}
@@ -25,6 +29,10 @@ namespace CGEngine {
 		}
 	}
 
+	void Behavior::callDomain(domainId_t domainId) {
+		scripts.callDomain(domainId, this);
+	}
+
 	void Behavior::callDomain(string domain) {
 		scripts.callDomain(domain, this);
 	}
@@ -33,6 +41,18 @@ namespace CGEngine {
 		scripts.callDomainWithData(domain, this, data);
 	}
 
+	void Behavior::callDomainWithEvent(domainId_t domainId, const ScriptPayload& payload) {
+		scripts.callDomainWithEvent(domainId, payload, this);
+	}
+
+	bool Behavior::getDomainAccess(domainId_t domainId, vector<Body*>& reads, vector<Body*>& writes) {
+		return scripts.getDomainAccess(domainId, reads, writes);
+	}
+
+	bool Behavior::getDomainAccess(string domain, vector<Body*>& reads, vector<Body*>& writes) {
+		return scripts.getDomainAccess(domain, reads, writes);
+	}
+
 	
 	id_t Behavior::getId() {
 		return behaviorId.value_or(0U);
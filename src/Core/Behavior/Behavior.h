@@ -15,12 +15,18 @@ namespace CGEngine {
 	class Behavior : public InputDataController, public OutputDataController, public ProcessDataController {
 	public:
 		Behavior(Body* owning, string name = "");
+		virtual ~Behavior() = default;
 
+		id_t addScript(domainId_t domainId, Script* script);
 		id_t addScript(string domain, Script* script);
 		void removeScript(string domain, id_t scriptId, bool shouldDelete = false);
 		void addScriptEventsByDomain(map<string, ScriptEvent> sc);
+		void callDomain(domainId_t domainId);
 		void callDomain(string domain);
 		void callDomainWithData(string domain, DataMap data);
+		void callDomainWithEvent(domainId_t domainId, const ScriptPayload& payload);
+		bool getDomainAccess(domainId_t domainId, vector<Body*>& reads, vector<Body*>& writes);
+		bool getDomainAccess(string domain, vector<Body*>& reads, vector<Body*>& writes);
 
 		id_t getId();
 		Body* getOwner();
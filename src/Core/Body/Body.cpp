@@ -2,6 +2,11 @@
 #include "../Engine/Engine.h"
 
 namespace CGEngine {
+    namespace {
+        //Interned once, so the intersect script doesn't look up the key's string each frame
+        const DataKey intersectsKey = "intersects";
+    }
+
     Body::Body(string displayName) : ScriptController(this) {
         bodyParams.name = displayName;
         scripts.initialize();
@@ -13,8 +18,12 @@ namespace CGEngine {
     }
 
     Body::Body(Transformable* d, Transformation handle, Body* p, Vector2f uv) : Body() {
-        //Cache the base transformable and cast it to a shape
+        //Cache the base transformable and resolve its components once
         entity = d;
+        components = BodyArchetypes::getComponents(entity);
+        if (entity != nullptr) {
+            world->getArchetypes().add(this);
+        }
         //Create the bounds rect and set draw bounds to world's value
         createBoundsRect();
         
@@ -41,11 +50,25 @@ namespace CGEngine {
         //Remove input actions from their domains (without deleting domains) and delete the input actions
         input->eraseActuatorIds(listenerIds);
         //Delete any timers
-        timers.deleteTimers(this);
-        //Call assigned OnDeleteEvent scripts
-        callScripts(onDeleteEvent);
+        timers.deleteTimers();
+        //Call assigned OnDeleteEvent scripts (destroyed Bodies had them called by the World before deletion)
+        if (!destroyed) {
+            callScripts(onDeleteDomain);
+        }
         //Delete scripts and domains (AFTER calling OnDeleteEvent scripts)
         scripts.clear();
+        //Stop the Body's coroutines, then remove the Body from the World's domain subscribers (including those of its Behaviors) and activity tracking
+        if (world != nullptr) {
+            //A Body deleted directly after being destroyed must not be deleted again by the World
+            if (destroyed) world->unqueueDestroyed(this);
+            world->getCoroutines().stopAll(this);
+            world->getUpdateScheduler().forget(this);
+            world->unsubscribeAll(this);
+            world->untrackActivity(this);
+        }
+        if (archetyped && world != nullptr) {
+            world->getArchetypes().remove(this);
+        }
         if (entity != nullptr) {
             delete entity;
             entity = nullptr;
@@ -75,6 +98,87 @@ namespace CGEngine {
         return valid;
     }
 
+    void Body::destroy(ChildrenTermination termination) {
+        //Structural changes made from parallel update jobs are applied when the jobs finish
+        if (JobSystem::isInJob()) {
+            world->defer([this, termination]() { destroy(termination); });
+            return;
+        }
+        //The world root is never destroyed and each Body is only queued once
+        if (destroyed || this == world->getRoot()) return;
+        destroyed = true;
+        destroyTermination = termination;
+        world->queueDestroyed(this);
+        //Terminated children are hidden along with this Body
+        if (termination == ChildrenTermination::Terminate) {
+            for (Body* child : children) {
+                child->destroy(ChildrenTermination::Terminate);
+            }
+        }
+    }
+
+    bool Body::isDestroyed() const {
+        return destroyed;
+    }
+
+    void Body::wake() {
+        if (world != nullptr) {
+            world->wakeBody(this);
+        }
+    }
+
+    bool Body::isAsleep() const {
+        return activity.asleep;
+    }
+
+    void Body::setAutoSleepEnabled(bool enabled) {
+        activity.autoSleep = enabled;
+        wake();
+    }
+
+    bool Body::getAutoSleepEnabled() const {
+        return activity.autoSleep;
+    }
+
+    bool Body::getUpdateAccess(vector<Body*>& reads, vector<Body*>& writes) {
+        //Every update writes the Body's own update time
+        writes.push_back(this);
+        bool parallel = scripts.getDomainAccess(onUpdateDomain, reads, writes);
+        behaviors.forEach([&parallel, &reads, &writes](Behavior* behavior) {
+            parallel = behavior->getDomainAccess(onUpdateDomain, reads, writes) && parallel;
+        });
+        return parallel;
+    }
+
+    bool Body::canSleep() {
+        //Pending timers don't keep the Body awake, since the World's TimerWheel fires them whether or not it is asleep
+        if (!activity.autoSleep) return false;
+        //Held key and mouse input is handled by coroutines that run until the input is released
+        CoroutineScheduler& coroutines = world->getCoroutines();
+        if (mouseOverlapHoldCoroutineId.has_value() && coroutines.isRunning(mouseOverlapHoldCoroutineId.value())) return false;
+        for (const auto& [key, coroutineId] : keyHoldCoroutineIds) {
+            if (coroutineId.has_value() && coroutines.isRunning(coroutineId.value())) return false;
+        }
+        return true;
+    }
+
+    void Body::captureSimulationState(size_t fixedStep) {
+        previousState.position = getPosition();
+        previousState.rotation = getRotation();
+        previousState.scale = getScale();
+        previousState.fixedStep = fixedStep;
+    }
+
+    Transform Body::getInterpolatedTransform(float alpha) {
+        Transformable blended;
+        blended.setOrigin(getOrigin());
+        blended.setPosition(previousState.position + (getPosition() - previousState.position) * alpha);
+        //Rotate through the shorter arc so a wrap from 359 to 0 degrees doesn't spin the Body backwards
+        blended.setRotation(previousState.rotation + (getRotation() - previousState.rotation).wrapSigned() * alpha);
+        blended.setScale(previousState.scale + (getScale() - previousState.scale) * alpha);
+        return blended.getTransform();
+    }
+
     string Body::getName() {
         return bodyParams.name;
     }
@@ -119,7 +223,7 @@ namespace CGEngine {
 
     void Body::start() {
         if (!initialized) {
-            callScripts(onStartEvent);
+            callScripts(onStartDomain);
             initialized = true;
         }
     }
@@ -136,14 +240,14 @@ namespace CGEngine {
 
     FloatRect Body::getGlobalBounds() const{
         if (entity != nullptr) {
-            if (Shape* t = dynamic_cast<Shape*>(entity)) {
-                return (getGlobalTransform()).transformRect(t->getLocalBounds());
+            if (components == ComponentShape) {
+                return (getGlobalTransform()).transformRect(static_cast<Shape*>(entity)->getLocalBounds());
             }
-            else if (Text* t = dynamic_cast<Text*>(entity)) {
-                return (getGlobalTransform()).transformRect(t->getLocalBounds());
+            else if (components == ComponentText) {
+                return (getGlobalTransform()).transformRect(static_cast<Text*>(entity)->getLocalBounds());
             }
-            else if (Sprite* t = dynamic_cast<Sprite*>(entity)) {
-                return (getGlobalTransform()).transformRect(t->getLocalBounds());
+            else if (components == ComponentSprite) {
+                return (getGlobalTransform()).transformRect(static_cast<Sprite*>(entity)->getLocalBounds());
             }
         } else {
             if (this == world->getRoot()) {
@@ -155,14 +259,14 @@ namespace CGEngine {
 
     FloatRect Body::getLocalBounds() const {
         if (entity != nullptr) {
-            if (Shape* t = dynamic_cast<Shape*>(entity)) {
-                return t->getLocalBounds();
+            if (components == ComponentShape) {
+                return static_cast<Shape*>(entity)->getLocalBounds();
             }
-            else if (Text* t = dynamic_cast<Text*>(entity)) {
-                return t->getLocalBounds();
+            else if (components == ComponentText) {
+                return static_cast<Text*>(entity)->getLocalBounds();
             }
-            else if (Sprite* t = dynamic_cast<Sprite*>(entity)) {
-                return t->getLocalBounds();
+            else if (components == ComponentSprite) {
+                return static_cast<Sprite*>(entity)->getLocalBounds();
             }
         } else {
             if (this == world->getRoot()) {
@@ -244,7 +348,7 @@ namespace CGEngine {
     }
 
     Vector2f Body::viewToGlobal(Vector2i input) const {
-        return screen->getWindow()->mapPixelToCoords(input);
+        return screen->viewToGlobal(input);
     }
 
     Vector2f Body::viewToLocal(Vector2i input) const {
@@ -346,6 +450,10 @@ namespace CGEngine {
 
     void Body::setRenderingEnabled(bool enabled) {
         bodyParams.rendering = enabled;
+        if (archetyped) {
+            world->getArchetypes().updateFlags(this);
+        }
+        wake();
     }
 
     bool Body::getBoundsRenderingEnabled() const {
@@ -354,6 +462,10 @@ namespace CGEngine {
 
     void Body::setBoundsRenderingEnabled(bool enabled) {
         bodyParams.boundsRendering = enabled;
+        if (archetyped) {
+            world->getArchetypes().updateFlags(this);
+        }
+        wake();
     }
 
     bool Body::getIntersectEnabled() const {
@@ -362,13 +474,25 @@ namespace CGEngine {
 
     void Body::setIntersectEnabled(bool enabled) {
         bodyParams.intersecting = enabled;
+        if (archetyped) {
+            world->getArchetypes().updateFlags(this);
+        }
+        wake();
     }
 
     size_t Body::getChildCount() const {
         return children.size();
     }
 
+    uint32_t Body::getComponents() const {
+        return components;
+    }
+
     void Body::attachBody(Body* child) {
+        if (JobSystem::isInJob()) {
+            world->defer([this, child]() { attachBody(child); });
+            return;
+        }
         //Do nothing on null input
         if (child != nullptr) {
             //If child is already attached, detach
@@ -379,10 +503,16 @@ namespace CGEngine {
             children.push_back(child);
             //Set the child's parent to this
             child->parent = this;
+            world->markHierarchyDirty(this);
+            child->wake();
         }
     }
 
     void Body::detachBody(Body* child, const bool keepWorldTranform) {
+        if (JobSystem::isInJob()) {
+            world->defer([this, child, keepWorldTranform]() { detachBody(child, keepWorldTranform); });
+            return;
+        }
         //Do nothing on null input
         if (child == nullptr) return;
         //Find the body to detach
@@ -396,11 +526,16 @@ namespace CGEngine {
             }
             //Remove child from children
             children.erase(iterator);
+            world->markHierarchyDirty(this);
             world->getRoot()->attachBody(child);
         }
     }
 
     void Body::detachChildren(const bool keepWorldTranform) {
+        if (JobSystem::isInJob()) {
+            world->defer([this, keepWorldTranform]() { detachChildren(keepWorldTranform); });
+            return;
+        }
         for (int i = children.size() - 1; i >= 0; i--) {
             Body* child = children[i];
             if (keepWorldTranform) {
@@ -419,9 +554,16 @@ namespace CGEngine {
             //Remove child from children
             children.erase(children.begin() + i);
         }
+        if (world != nullptr) {
+            world->markHierarchyDirty(this);
+        }
     }
 
     void Body::dropBody(Body* child) {
+        if (JobSystem::isInJob()) {
+            world->defer([this, child]() { dropBody(child); });
+            return;
+        }
         //Do nothing on null input
         if (child != nullptr) {
             //Find the body to detach
@@ -431,6 +573,9 @@ namespace CGEngine {
                 //Remove child from children
                 children.erase(iterator);
                 child->parent = nullptr;
+                if (world != nullptr) {
+                    world->markHierarchyDirty(this);
+                }
             }
         }
     }
@@ -442,6 +587,10 @@ namespace CGEngine {
     }
 
     void Body::exchangeBody(Body* child, Body* target) {
+        if (JobSystem::isInJob()) {
+            world->defer([this, child, target]() { exchangeBody(child, target); });
+            return;
+        }
         if (child != nullptr) {
             //Find the body to detach
             auto iterator = find_if(children.begin(), children.end(), [child](Body* c) { return c == child; });
@@ -449,6 +598,7 @@ namespace CGEngine {
             if (iterator != children.end()) {
                 //Remove child from children
                 children.erase(iterator);
+                world->markHierarchyDirty(this);
                 //parent the child to the world root
                 target->attachBody(child);
             }
@@ -474,16 +624,17 @@ namespace CGEngine {
     optional<id_t> Body::addOverlapMousePressScript(Script* script, Mouse::Button button, optional<id_t> behaviorId, bool alwaysAddListener) {
         //The input condition called by the InputMap
         InputCondition inputCondition = InputCondition((int)button, InputType::Button, InputState::Pressed);
+        domainId_t pressDomain = DomainRegistry::intern("mousePress_" + to_string((int)button));
         if (alwaysAddListener || listenerIds.find(inputCondition) == listenerIds.end()) {
             Behavior* behavior = nullptr;
             if (behaviorId.has_value()) {
                 behavior = behaviors.get(behaviorId.value());
             }
-            input->addActuator(inputCondition, new Actuator(MouseOverlapPressEvent, this, behavior));
+            input->addActuator(inputCondition, new Actuator(MouseOverlapPressEvent(pressDomain), this, behavior));
         }
         //Add the script to the input condition for clicking
         if (script != nullptr) {
-            return scripts.addScript("mousePress_"+to_string((int)button), script);
+            return scripts.addScript(pressDomain, script);
         }
         return nullopt;
     }
@@ -491,15 +642,16 @@ namespace CGEngine {
     optional<id_t> Body::addOverlapMouseReleaseScript(Script* script, Mouse::Button button, optional<id_t> behaviorId, bool alwaysAddListener) {
         //The input condition called by the InputMap
         InputCondition inputCondition = InputCondition((int)button, InputType::Button, InputState::Released);
+        domainId_t releaseDomain = DomainRegistry::intern("mouseRelease_" + to_string((int)button));
         if (alwaysAddListener || listenerIds.find(inputCondition) == listenerIds.end()) {
             Behavior* behavior = nullptr;
             if (behaviorId.has_value()) {
                 behavior = behaviors.get(behaviorId.value());
             }
-            input->addActuator(inputCondition, new Actuator(MouseOverlapReleaseEvent, this, behavior));
+            input->addActuator(inputCondition, new Actuator(MouseOverlapReleaseEvent(releaseDomain), this, behavior));
         }
         if (script != nullptr) {
-            return scripts.addScript("mouseRelease_" + to_string((int)button), script);
+            return scripts.addScript(releaseDomain, script);
         }
         return nullopt;
     }
@@ -507,7 +659,7 @@ namespace CGEngine {
     optional<id_t> Body::addOverlapMouseHoldScript(Script* script, Mouse::Button button, optional<id_t> behaviorId) {
         addMousePressScript(MouseOverlapHoldPressEvent, button, behaviorId);
         if (script != nullptr) {
-            return scripts.addScript("mouseHold_" + to_string((int)button), script);
+            return scripts.addScript(DomainRegistry::intern("mouseHold_" + to_string((int)button)), script);
         }
         return nullopt;
     }
@@ -515,7 +667,7 @@ namespace CGEngine {
     optional<id_t> Body::addOverlapEnterMouseScript(Script* script, optional<id_t> behaviorId) {
         addMouseMovedScript(MouseOverlapEnterEvent, behaviorId);
         if (script != nullptr) {
-            return scripts.addScript("mouseEnter", script);
+            return scripts.addScript(onMouseEnterDomain, script);
         }
         return nullopt;
     }
@@ -523,7 +675,7 @@ namespace CGEngine {
     optional<id_t> Body::addOverlapExitMouseScript(Script* script, optional<id_t> behaviorId) {
         addMouseMovedScript(MouseOverlapExitEvent, behaviorId);
         if (script != nullptr) {
-            return scripts.addScript("mouseExit", script);
+            return scripts.addScript(onMouseExitDomain, script);
         }
         return nullopt;
     }
@@ -588,7 +740,7 @@ namespace CGEngine {
         Behavior* behavior = nullptr;
         addKeyPressScript(KeyHoldPressedEvent, key, behaviorId);
         if (script != nullptr) {
-            return scripts.addScript("keyHold_" + to_string((int)key), script);
+            return scripts.addScript(DomainRegistry::intern("keyHold_" + to_string((int)key)), script);
         }
         return nullopt;
     }
@@ -648,16 +800,16 @@ namespace CGEngine {
     }
 
     void Body::cancelTimer(size_t timerId) {
-        timers.cancelTimer(this, timerId);
+        timers.cancelTimer(timerId);
     }
 
     void Body::cancelTimer(timerId_t* timerId) {
-        timers.cancelTimer(this, timerId);
+        timers.cancelTimer(timerId);
     }
 
-    void Body::callScripts(string domain) {
-        if (domain == onUpdateEvent) {
-            sec_t elapsed = time.getElapsedSec();
+    void Body::callScripts(domainId_t domainId) {
+        if (domainId == onUpdateDomain) {
+            sec_t elapsed = time->getElapsedSec();
             if (elapsed - lastUpdateTime > scriptUpdateInterval) {
                 lastUpdateTime = elapsed;
             } else {
@@ -665,25 +817,60 @@ namespace CGEngine {
             }
         }
 
-        behaviors.forEach([&domain](Behavior* behavior) { behavior->callDomain(domain); });
-        scripts.callDomain(domain);
+        behaviors.forEach([domainId](Behavior* behavior) { behavior->callDomain(domainId); });
+        scripts.callDomain(domainId);
+        if (world != nullptr) {
+            world->getCoroutines().notifyDomain(this, domainId);
+        }
+    }
+
+    void Body::callScripts(string domain) {
+        if (optional<domainId_t> domainId = DomainRegistry::find(domain)) {
+            callScripts(domainId.value());
+        }
     }
 
     void Body::callScriptsWithData(string domain, DataMap data) {
         behaviors.forEach([&domain, &data](Behavior* behavior) { behavior->callDomainWithData(domain, data); });
         scripts.callDomainWithData(domain, nullptr, data);
+        optional<domainId_t> domainId = DomainRegistry::find(domain);
+        if (domainId.has_value() && world != nullptr) {
+            world->getCoroutines().notifyDomain(this, domainId.value());
+        }
+    }
+
+    void Body::callScriptsWithEvent(domainId_t domainId, const ScriptPayload& payload) {
+        behaviors.forEach([domainId, &payload](Behavior* behavior) { behavior->callDomainWithEvent(domainId, payload); });
+        scripts.callDomainWithEvent(domainId, payload);
+        if (world != nullptr) {
+            world->getCoroutines().notifyDomain(this, domainId);
+        }
+    }
+
+    id_t Body::startCoroutine(ScriptTask task) {
+        return world->getCoroutines().start(std::move(task), this);
+    }
+
+    void Body::stopCoroutine(id_t coroutineId) {
+        world->getCoroutines().stop(coroutineId);
+    }
+
+    ScriptTask Body::callEachFrame(Body* body, domainId_t domainId) {
+        while (true) {
+            co_await nextFrame();
+            body->scripts.callDomain(domainId, {});
+        }
     }
 
     ScriptEvent Body::onIntersectScript = [](ScArgs args) {
         vector<Body*> intersections;
         stack<any> intersects;
         //Walk through the Body hierarchy from root and check intersection vs this Body bounds
-        vector<Body*> search = { world->getRoot() };
-        while (search.size() > 0) {
-            Body* other = search.back();
-            //For each other body that has bodyParams.intersecting enabled
-            if (args.caller != nullptr && other != nullptr){
-                if (other != args.caller && other->getIntersectEnabled()) {
+        //Scan the World's flattened hierarchy for other bodies that have bodyParams.intersecting enabled
+        if (args.caller != nullptr) {
+            for (const BodyTraversalEntry& entry : world->getTraversalOrder()) {
+                Body* other = entry.body;
+                if (other != args.caller && !other->destroyed && other->getIntersectEnabled()) {
                     //If they're intersecting
                     optional<FloatRect> intersection = args.caller->getGlobalBounds().findIntersection(other->getGlobalBounds());
                     if (intersection.has_value()) {
@@ -693,17 +880,14 @@ namespace CGEngine {
                         break;
                     }
                 }
-                //Check the search Body's children
-                search.insert(search.begin(), other->children.begin(), other->children.end());
             }
-
-            //Pop from the search list
-            search.pop_back();
         }
 
         //If there are any intersected bodies
         if (intersections.size() > 0) {
-            args.script->setOutput(DataMap(map<string, any>({ {"intersects",intersects }})));
+            DataMap output;
+            output.setData(intersectsKey, intersects);
+            args.script->setOutput(output);
             //Call any intersect domain scripts on this body, passing intersections and the intersectScript's data stack
             args.caller->callScriptsWithData(onIntersectEvent, args.script->getOutput());
         }
@@ -717,20 +901,7 @@ namespace CGEngine {
 
         // draw its children
         for (id_t i = 0; i < children.size(); ++i) {
-            children[i]->render(target, tr);
-        }
-    }
-
-    void Body::render(RenderTarget& target, const Transform& parentTransform) {
-        if (!getId().has_value()) return;
-
-        //Combine parent transform and local transform
-        Transform globalTransform = getGlobalTransform();
-        renderer.add(getId().value(), globalTransform);
-
-        //Draw children recursively
-        for (id_t i = 0; i < children.size(); ++i) {
-            children[i]->render(target, globalTransform);
+            children[i]->draw(target, states);
         }
     }
 
@@ -739,9 +910,9 @@ namespace CGEngine {
             target.draw(*boundsRect, transform);
         }
         if (bodyParams.rendering && entity != nullptr) {
-            if (Mesh* mesh = dynamic_cast<Mesh*>(entity)) {
+            if (components == ComponentMesh) {
                 // Pull OpenGL State
-                mesh->render(transform);
+                static_cast<Mesh*>(entity)->render(transform);
             } else {
                 target.draw(*(Shape*)entity, transform);
             }
@@ -749,25 +920,8 @@ namespace CGEngine {
     }
 
     Body* Body::deleteBody(ChildrenTermination termination) {
-        //Default behavior is that children detach (and therefor attach to world root)
-        for (int i = children.size() - 1; i >= 0; --i) {
-            switch (termination) {
-            case ChildrenTermination::Inherit:
-                if (parent != nullptr) {
-                    children[i]->exchange(parent);
-                    break;
-                }
-                [[fallthrough]];
-            case ChildrenTermination::Orphan:
-                children[i]->detach();
-                break;
-            case ChildrenTermination::Terminate:
-                children[i]->deleteBody();
-                break;
-            }
-        }
-
-        delete this;
+        //Deleting a Body while scripts may be iterating it is unsafe, so it is destroyed and deleted by the World at the end of the frame
+        destroy(termination);
         return nullptr;
     }
 
@@ -5,12 +5,14 @@
 #include <memory>
 #include "../Types/V2.h"
 #include "../Scripts/ScriptMap.h"
+#include "../Scripts/Coroutine.h"
 #include "../Input/InputMap.h"
 #include "../Timers/TimerMap.h"
 #include "../Behavior/Behavior.h"
 #include "../Types/UniqueDomain.h"
 #include "../Types/DataMap.h"
 #include "../Types/ScriptController/ScriptController.h"
+#include "BodyArchetypes.h"
 using namespace std;
 using namespace sf;
 
@@ -351,12 +353,6 @@ namespace CGEngine {
         /// <param name="states">The RenderStates</param>
         void draw(RenderTarget& target, RenderStates states) const;
         /// <summary>
-        /// Add the Body to the Renderer to initialize the draw order by hierarchy
-        /// </summary>
-        /// <param name="target">The RenderTarget</param>
-        /// <param name="parentTransform">This Body's parent transform</param>
-        void render(RenderTarget& target, const Transform& parentTransform);
-        /// <summary>
         /// Add the script to the "intersect" ScriptDomain to be called when the Body's GlobalBounds intersects another Body's GlobalBounds (if that Body has intersecting enabled)
         /// </summary>
         /// <param name="script">The script to add</param>
@@ -365,7 +361,8 @@ namespace CGEngine {
         /// <summary>
         /// Call each script within the domain
         /// </summary>
-        /// <param name="domain">The domain of the scripts to call</param>
+        /// <param name="domainId">The interned id of the domain of the scripts to call</param>
+        void callScripts(domainId_t domainId);
         void callScripts(string domain);
         /// <summary>
         /// Call each script within the domain, providing the indicated input data
@@ -374,6 +371,29 @@ namespace CGEngine {
         /// <param name="data">The DataMap to provide as input</param>
         void callScriptsWithData(string domain, DataMap data = DataMap());
         /// <summary>
+        /// Call each script within the domain with a typed event, which the scripts read through ScArgs::getEvent. The event is passed by
+        /// reference, so nothing is copied or allocated.
+        /// </summary>
+        /// <param name="domainId">The interned id of the domain of the scripts to call</param>
+        /// <param name="payload">The event to pass</param>
+        void callScriptsWithEvent(domainId_t domainId, const ScriptPayload& payload);
+        template<typename E>
+        void callScriptsWithEvent(domainId_t domainId, const E& event) {
+            callScriptsWithEvent(domainId, ScriptPayload::of(event));
+        }
+        /// <summary>
+        /// Start the coroutine on this Body. It runs until it first suspends, and is resumed by the World's CoroutineScheduler when its
+        /// wait is over. The coroutine is stopped when it returns, when it is stopped, or when the Body is deleted.
+        /// </summary>
+        /// <param name="task">The coroutine to start</param>
+        /// <returns>The id of the coroutine</returns>
+        id_t startCoroutine(ScriptTask task);
+        /// <summary>
+        /// Stop the coroutine started on this Body
+        /// </summary>
+        /// <param name="coroutineId">The id of the coroutine</param>
+        void stopCoroutine(id_t coroutineId);
+        /// <summary>
         /// Add the script to the "mousePress_"+buttonId ScriptMap domain. Also, if not added (or if 
         /// alwaysAddListener is true), add an Actuator for the indicated Mouse Button that calls the 
         /// "mousePress_"+buttonId ScriptMap domain when the Mouse Button is pressed when the cursor
@@ -582,9 +602,43 @@ namespace CGEngine {
 		/// </summary>
 		/// <returns>Number of children attached</returns>
 		size_t getChildCount() const;
+        /// <summary>
+        /// Return the component set of the Body's entity, resolved when the Body was created
+        /// </summary>
+        /// <returns>The BodyComponent flags of the entity</returns>
+        uint32_t getComponents() const;
 
         bool isValid() const;
         /// <summary>
+        /// Queue the Body to be deleted at the end of the frame. The Body is immediately hidden from rendering, script updates,
+        /// input and queries, then deleted along with every other destroyed Body in a single batch by the World.
+        /// </summary>
+        /// <param name="termination">Whether the Body's children should be orphaned, inherited, or terminated</param>
+        void destroy(ChildrenTermination termination = ChildrenTermination::Orphan);
+        /// <summary>
+        /// Return whether the Body has been destroyed and is waiting to be deleted at the end of the frame
+        /// </summary>
+        /// <returns>True if the Body has been destroyed</returns>
+        bool isDestroyed() const;
+        /// <summary>
+        /// Wake the Body if it's asleep and restart its idle frame count. Bodies are woken automatically when their scripts, hierarchy or
+        /// flags change through the Body, or when they receive input. Call this after changing a sleeping Body's transform from another Body's script.
+        /// </summary>
+        void wake();
+        /// <summary>
+        /// Return whether the Body is asleep. Sleeping Bodies are skipped by the World's update pass.
+        /// </summary>
+        /// <returns>True if the Body is asleep</returns>
+        bool isAsleep() const;
+        /// <summary>
+        /// Set whether the Body may fall asleep after its transform, Z-Order and scripts are unchanged for the World's sleep threshold.
+        /// Off by default. A sleeping Body's update, fixed update and scheduled domains aren't called, so only enable it on Bodies whose
+        /// update scripts have nothing to do while the Body is still.
+        /// </summary>
+        /// <param name="enabled">Whether the Body may fall asleep</param>
+        void setAutoSleepEnabled(bool enabled);
+        bool getAutoSleepEnabled() const;
+        /// <summary>
         /// Base Body initialization with a display name, taking a unique ID from world's body IDs stack, and assigning itself to the ScriptMap's owner pointer.
         /// </summary>
         /// <param name="name">Optional body display name</param>
@@ -605,6 +659,9 @@ namespace CGEngine {
         friend class Renderer;
         friend class InputMap;
 		friend class AssetManager;
+        friend class SceneSnapshot;
+        friend class SceneStreamer;
+        friend class BodyArchetypes;
         /// <summary>
         /// The unique id of the Body provided by the world
         /// </summary>
@@ -612,6 +669,75 @@ namespace CGEngine {
 
         bool valid = true;
         /// <summary>
+        /// Whether the Body has been destroyed and queued for deletion at the end of the frame
+        /// </summary>
+        bool destroyed = false;
+        /// <summary>
+        /// How the Body's children are handled when the destroyed Body is deleted
+        /// </summary>
+        ChildrenTermination destroyTermination = ChildrenTermination::Orphan;
+        /// <summary>
+        /// Index of the Body's entry in the World's flattened hierarchy, valid while the hierarchy is unchanged
+        /// </summary>
+        size_t traversalIndex = 0;
+        /// <summary>
+        /// The BodyComponent flags of the entity
+        /// </summary>
+        uint32_t components = ComponentNone;
+        /// <summary>
+        /// Whether the Body is stored in the World's BodyArchetypes, and at which archetype and row
+        /// </summary>
+        bool archetyped = false;
+        size_t archetypeIndex = 0;
+        size_t archetypeRow = 0;
+        /// <summary>
+        /// The Body's sleep state, tracked by the World once the Body has started
+        /// </summary>
+        struct ActivityState {
+            bool tracked = false;
+            bool asleep = false;
+            bool autoSleep = false;
+            size_t idleFrames = 0;
+            /// <summary>
+            /// Index of the Body in the World's awake Bodies while awake
+            /// </summary>
+            size_t awakeIndex = 0;
+            /// <summary>
+            /// The transform and Z-Order when last checked
+            /// </summary>
+            Transform transform;
+            int zOrder = 0;
+        } activity;
+        /// <summary>
+        /// The Body's local transform before its last fixed step, used to interpolate rendering between fixed steps
+        /// </summary>
+        struct SimulationState {
+            Vector2f position;
+            Angle rotation;
+            Vector2f scale = { 1,1 };
+            /// <summary>
+            /// The fixed step the state was captured before. 0 if it was never captured.
+            /// </summary>
+            size_t fixedStep = 0;
+        } previousState;
+        /// <summary>
+        /// Capture the local transform before the fixed step
+        /// </summary>
+        void captureSimulationState(size_t fixedStep);
+        /// <summary>
+        /// Return the local transform blended from the captured state toward the current one
+        /// </summary>
+        Transform getInterpolatedTransform(float alpha);
+        /// <summary>
+        /// Return whether the Body can fall asleep. Bodies with auto sleep disabled or held input scripts stay awake.
+        /// </summary>
+        bool canSleep();
+        /// <summary>
+        /// Return whether every update script of the Body and its Behaviors can run on a job thread, adding the Bodies they read and write
+        /// (including this Body) to reads and writes
+        /// </summary>
+        bool getUpdateAccess(vector<Body*>& reads, vector<Body*>& writes);
+        /// <summary>
         /// This Body's parameters
         /// </summary>
         BodyParameters bodyParams;
@@ -680,7 +806,7 @@ namespace CGEngine {
         /// </summary>
         bool initialized = false;
         /// <summary>
-        /// Delete the Body and, based on the setting, either orphan, inherit, or terminate its children
+        /// Destroy the Body to be deleted at the end of the frame and, based on the setting, either orphan, inherit, or terminate its children
         /// </summary>
         /// <param name="inheritChildren">Whether the Body's children should be orphaned, inherited, or terminated</param>
         /// <returns>The nulled reference</returns>
@@ -688,37 +814,43 @@ namespace CGEngine {
         //Draw the assigned Drawable shape to target with the provided transform
         void onDraw(RenderTarget& target, const Transform& transform) const;
 
-        ScriptEvent MouseOverlapReleaseEvent = [](ScArgs args) {
-            //Get the mouse release event from the script input data
-            MouseReleaseInput* evt = args.script->getInput().getDataPtr<MouseReleaseInput>("evt");
-            if (evt == nullptr) return;
-
-            //If the caller's bounds contains the mouse position (converted from View Space)
-            if (args.caller->contains(args.caller->viewToGlobal(evt->position))) {
-                //Call any mouseRelease+button domain scripts with the mouse release event as input
-                args.caller->scripts.callDomainWithData("mouseRelease_" + to_string((int)evt->button), nullptr, DataMap(map<string, any>({ {"evt",evt} })));
-            }
-        };
-        ScriptEvent MouseOverlapPressEvent = [](ScArgs args) {
-            //Get the mouse press event from the script input data
-            MousePressInput* evt = args.script->getInput().getDataPtr<MousePressInput>("evt");
-            if (evt == nullptr) return;
-
-            //If the caller's bounds contains the mouse position (converted from View Space)
-            if (args.caller->contains(args.caller->viewToGlobal(evt->position))) {
-                //Call any mousePress+button domain scripts with the mouse press event as input
-                args.caller->scripts.callDomainWithData("mousePress_" + to_string((int)evt->button), nullptr, DataMap(map<string, any>({ {"evt",evt} })));
-            }
-        };
+        //The overlap release and press actuators call their button's domain, which is interned when the actuator is added rather than on each event
+        static ScriptEvent MouseOverlapReleaseEvent(domainId_t releaseDomain) {
+            return [releaseDomain](ScArgs args) {
+                //Get the mouse release event the script was called with
+                MouseReleaseInput* evt = args.getEvent<MouseReleaseInput>();
+                if (evt == nullptr) return;
+
+                //If the caller's bounds contains the mouse position (converted from View Space)
+                if (args.caller->contains(args.caller->viewToGlobal(evt->position))) {
+                    //Call any mouseRelease+button domain scripts with the mouse release event
+                    args.caller->scripts.callDomainWithEvent(releaseDomain, *evt);
+                }
+            };
+        }
+        static ScriptEvent MouseOverlapPressEvent(domainId_t pressDomain) {
+            return [pressDomain](ScArgs args) {
+                //Get the mouse press event the script was called with
+                MousePressInput* evt = args.getEvent<MousePressInput>();
+                if (evt == nullptr) return;
+
+                //If the caller's bounds contains the mouse position (converted from View Space)
+                if (args.caller->contains(args.caller->viewToGlobal(evt->position))) {
+                    //Call any mousePress+button domain scripts with the mouse press event
+                    args.caller->scripts.callDomainWithEvent(pressDomain, *evt);
+                }
+            };
+        }
         ScriptEvent MouseOverlapHoldReleasedEvent = [](ScArgs args) {
-            //Get the mouse release event from the script input data
-            MouseReleaseInput* evt = args.script->getInput().getDataPtr<MouseReleaseInput>("evt");
+            //Get the mouse release event the script was called with
+            MouseReleaseInput* evt = args.getEvent<MouseReleaseInput>();
             if (evt == nullptr) return;
 
-            //If the caller has a mouseOverlapHold update script id assigned
-            if (args.caller->mouseOverlapHoldUpdateId.has_value()) {
-                //Erase the mouseOverlapHold update script
-                args.caller->eraseUpdateScript(args.caller->mouseOverlapHoldUpdateId.value(), true);
+            //If the caller has a mouseOverlapHold coroutine id assigned
+            if (args.caller->mouseOverlapHoldCoroutineId.has_value()) {
+                //Stop the mouseOverlapHold coroutine
+                args.caller->stopCoroutine(args.caller->mouseOverlapHoldCoroutineId.value());
+                args.caller->mouseOverlapHoldCoroutineId = nullopt;
                 //Remove this key release actuator
                 args.caller->removeListener(InputCondition((int)evt->button, InputType::Button, InputState::Released), args.script->id.value());
                 //Add a key press actuator
@@ -726,19 +858,17 @@ namespace CGEngine {
             }
         };
         ScriptEvent MouseOverlapHoldPressEvent = [](ScArgs args) {
-            //Get the mouse press event from the scipt input data
-            MousePressInput* evt = args.script->getInput().getDataPtr<MousePressInput>("evt");
+            //Get the mouse press event the script was called with
+            MousePressInput* evt = args.getEvent<MousePressInput>();
             if (evt == nullptr) return;
 
             //If the caller's bounds contains the mouse position (converted from View Space)
             if (args.caller->contains(args.caller->viewToGlobal(evt->position))) {
                 Mouse::Button button = evt->button;
 
-                //Add an update script to call mouseHold+button scripts each tick
-                args.caller->mouseOverlapHoldUpdateId = args.caller->addUpdateScript(new Script([button](ScArgs args) {
-                    //Call any mouseHold+button scripts each tick
-                    args.caller->scripts.callDomain("mouseHold_" + to_string((int)button), {});
-                }));
+                //Start a coroutine that calls any mouseHold+button scripts each frame, interning the domain once per press
+                domainId_t holdDomain = DomainRegistry::intern("mouseHold_" + to_string((int)button));
+                args.caller->mouseOverlapHoldCoroutineId = args.caller->startCoroutine(callEachFrame(args.caller, holdDomain));
 
                 //Remove this key press actuator
                 args.caller->removeListener(InputCondition((int)button, InputType::Button, InputState::Pressed), args.script->id.value());
@@ -746,22 +876,23 @@ namespace CGEngine {
                 args.caller->addMouseReleaseScript(args.caller->MouseOverlapHoldReleasedEvent);
             }
         };
-        optional<id_t> mouseOverlapHoldUpdateId = nullopt;
+        optional<id_t> mouseOverlapHoldCoroutineId = nullopt;
         
 
         ScriptEvent KeyHoldReleasedEvent = [](ScArgs args) {
-            //Get the key released event from the script input data
-            KeyReleaseInput* evt = args.script->getInput().getDataPtr<KeyReleaseInput>("evt");
+            //Get the key released event the script was called with
+            KeyReleaseInput* evt = args.getEvent<KeyReleaseInput>();
             if(evt == nullptr) return;
             Keyboard::Scan key = evt->scancode;
 
-            //When the key is released, find the id of the update script for this key hold
-            auto iterator = args.caller->keyHoldUpdateIds.find(key);
-            if (iterator != args.caller->keyHoldUpdateIds.end()) {
-                optional<id_t> updateId = (*iterator).second;
-                if (updateId.has_value()) {
-                    //Erase the key hold update script
-                    args.caller->eraseUpdateScript(updateId.value(), true);
+            //When the key is released, find the id of the coroutine for this key hold
+            auto iterator = args.caller->keyHoldCoroutineIds.find(key);
+            if (iterator != args.caller->keyHoldCoroutineIds.end()) {
+                optional<id_t> coroutineId = (*iterator).second;
+                if (coroutineId.has_value()) {
+                    //Stop the key hold coroutine
+                    args.caller->stopCoroutine(coroutineId.value());
+                    (*iterator).second = nullopt;
                     //Remove this key release actuator
                     args.caller->removeListener(InputCondition((int)key, InputType::Key, InputState::Released), args.script->id.value());
                     //Add a key press actuator
@@ -771,43 +902,47 @@ namespace CGEngine {
         };
 
         ScriptEvent KeyHoldPressedEvent = [this](ScArgs args) {
-            //Get the key press event from the script input data
-            KeyPressInput* evt = args.script->getInput().getDataPtr<KeyPressInput>("evt");
+            //Get the key press event the script was called with
+            KeyPressInput* evt = args.getEvent<KeyPressInput>();
             if (evt == nullptr) return;
             Keyboard::Scan key = evt->scancode;
 
-            //When the key is pressed, add an update script to call keyHold+key domain scripts each tick
-            args.caller->keyHoldUpdateIds[key] = args.caller->addUpdateScript(new Script([key](ScArgs args) {
-                //Call the keyHold+key script each tick
-                args.caller->scripts.callDomain("keyHold_" + to_string((int)key), {});
-            }));
+            //When the key is pressed, start a coroutine that calls keyHold+key domain scripts each frame, interning the domain once per press
+            domainId_t holdDomain = DomainRegistry::intern("keyHold_" + to_string((int)key));
+            args.caller->keyHoldCoroutineIds[key] = args.caller->startCoroutine(callEachFrame(args.caller, holdDomain));
 
             //Remove this key press actuator
             args.caller->removeListener(InputCondition((int)key, InputType::Key, InputState::Pressed), args.script->id.value());
             //Add a key release actuator
             args.caller->addKeyReleaseScript(args.caller->KeyHoldReleasedEvent, key);
         };
-        map<Keyboard::Scan,optional<id_t>> keyHoldUpdateIds;
+        map<Keyboard::Scan,optional<id_t>> keyHoldCoroutineIds;
+        /// <summary>
+        /// Call the domain on the Body once each frame, starting with the next frame, until the coroutine is stopped
+        /// </summary>
+        static ScriptTask callEachFrame(Body* body, domainId_t domainId);
 
         ScriptEvent MouseOverlapEnterEvent = [](ScArgs args) {
-            //Get the mouse position from the script input data
-            Vector2i pos = args.script->getInput().getData<Vector2i>("evt");
+            //Get the mouse moved event the script was called with
+            const Event::MouseMoved* evt = args.getEvent<Event::MouseMoved>();
+            if (evt == nullptr) return;
 
             //If the mouse position (converted from View Space) is contained by the caller's bounds
-            if (args.caller->contains(args.caller->viewToGlobal(pos))) {
-                //Call any mouseEnter domain scripts with the mouse position as input data
-                args.caller->scripts.callDomainWithData("mouseEnter", nullptr, DataMap(map<string, any>({ {"evt",pos} })));
+            if (args.caller->contains(args.caller->viewToGlobal(evt->position))) {
+                //Call any mouseEnter domain scripts with the mouse moved event
+                args.caller->scripts.callDomainWithEvent(onMouseEnterDomain, *evt);
             }
         };
 
         ScriptEvent MouseOverlapExitEvent = [](ScArgs args) {
-            //Get the mouse position from the script input data
-            Vector2i pos = args.script->getInput().getData<Vector2i>("evt");
-            
+            //Get the mouse moved event the script was called with
+            const Event::MouseMoved* evt = args.getEvent<Event::MouseMoved>();
+            if (evt == nullptr) return;
+
             //If the mouse position (converted from View Space) is contained by the caller's bounds
-            if (!args.caller->contains(args.caller->viewToGlobal(pos))) {
-                //Call any mouseExit domain scripts with the mouse position as input data
-                args.caller->scripts.callDomainWithData("mouseExit", nullptr, DataMap(map<string, any>({ {"evt",pos} })));
+            if (!args.caller->contains(args.caller->viewToGlobal(evt->position))) {
+                //Call any mouseExit domain scripts with the mouse moved event
+                args.caller->scripts.callDomainWithEvent(onMouseExitDomain, *evt);
             }
         };
         /// <summary>
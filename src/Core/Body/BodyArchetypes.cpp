@@ -0,0 +1,84 @@
+#include "BodyArchetypes.h"
+#include "../Engine/Engine.h"
+
+namespace CGEngine {
+    BodyArchetypes::BodyArchetypes() {
+        init();
+    }
+
+    uint32_t BodyArchetypes::getComponents(Transformable* entity) {
+        if (entity == nullptr) return ComponentNone;
+        if (dynamic_cast<Mesh*>(entity)) return ComponentMesh;
+        if (dynamic_cast<Sprite*>(entity)) return ComponentSprite;
+        if (dynamic_cast<Text*>(entity)) return ComponentText;
+        if (dynamic_cast<Shape*>(entity)) return ComponentShape;
+        return ComponentNone;
+    }
+
+    void BodyArchetypes::add(Body* body) {
+        if (body == nullptr || body->archetyped || body->entity == nullptr) return;
+
+        auto found = archetypeIndices.find(body->components);
+        if (found == archetypeIndices.end()) {
+            found = archetypeIndices.insert({ body->components, archetypes.size() }).first;
+            BodyArchetype archetype;
+            archetype.components = body->components;
+            archetypes.push_back(archetype);
+        }
+
+        BodyArchetype& archetype = archetypes[found->second];
+        body->archetypeIndex = found->second;
+        body->archetypeRow = archetype.bodies.size();
+        body->archetyped = true;
+        archetype.bodies.push_back(body);
+        archetype.entities.push_back(body->entity);
+        archetype.flags.push_back({ body->bodyParams.rendering, body->bodyParams.intersecting, body->bodyParams.boundsRendering });
+    }
+
+    void BodyArchetypes::remove(Body* body) {
+        if (body == nullptr || !body->archetyped) return;
+
+        BodyArchetype& archetype = archetypes[body->archetypeIndex];
+        size_t row = body->archetypeRow;
+        size_t last = archetype.bodies.size() - 1;
+        //Move the last row into the removed Body's row so the arrays stay dense
+        if (row != last) {
+            archetype.bodies[row] = archetype.bodies[last];
+            archetype.entities[row] = archetype.entities[last];
+            archetype.flags[row] = archetype.flags[last];
+            archetype.bodies[row]->archetypeRow = row;
+        }
+        archetype.bodies.pop_back();
+        archetype.entities.pop_back();
+        archetype.flags.pop_back();
+        body->archetyped = false;
+    }
+
+    void BodyArchetypes::updateFlags(Body* body) {
+        if (body == nullptr || !body->archetyped) return;
+        archetypes[body->archetypeIndex].flags[body->archetypeRow] = { body->bodyParams.rendering, body->bodyParams.intersecting, body->bodyParams.boundsRendering };
+    }
+
+    void BodyArchetypes::forEach(uint32_t components, function<void(Body*, Transformable*, const BodyFlags&)> function) {
+        for (BodyArchetype& archetype : archetypes) {
+            if ((archetype.components & components) != components) continue;
+            for (size_t row = 0; row < archetype.bodies.size(); row++) {
+                function(archetype.bodies[row], archetype.entities[row], archetype.flags[row]);
+            }
+        }
+    }
+
+    const vector<BodyArchetype>& BodyArchetypes::getArchetypes() const {
+        return archetypes;
+    }
+
+    size_t BodyArchetypes::getCount(uint32_t components) const {
+        size_t count = 0;
+        for (const BodyArchetype& archetype : archetypes) {
+            if ((archetype.components & components) == components) {
+                count += archetype.bodies.size();
+            }
+        }
+        return count;
+    }
+}
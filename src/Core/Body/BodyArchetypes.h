@@ -0,0 +1,120 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "SFML/Graphics.hpp"
+#include "../Engine/EngineSystem.h"
+
+using namespace sf;
+using namespace std;
+
+namespace CGEngine {
+    class Body;
+    class Mesh;
+
+    /// <summary>
+    /// The component types a Body's entity can provide. A Body's component set is resolved once, when its entity is assigned.
+    /// </summary>
+    enum BodyComponent : uint32_t {
+        ComponentNone = 0,
+        ComponentShape = 1 << 0,
+        ComponentText = 1 << 1,
+        ComponentSprite = 1 << 2,
+        ComponentMesh = 1 << 3
+    };
+
+    /// <summary>
+    /// Dense copy of a Body's rendering and intersection flags
+    /// </summary>
+    struct BodyFlags {
+        bool rendering = true;
+        bool intersecting = false;
+        bool boundsRendering = false;
+    };
+
+    /// <summary>
+    /// Every Body with the same component set, stored in parallel dense arrays. Row i of each array belongs to the same Body.
+    /// </summary>
+    struct BodyArchetype {
+        uint32_t components = ComponentNone;
+        vector<Body*> bodies;
+        /// <summary>
+        /// The Bodies' entities. Their concrete type is known from the component set, so they can be static_cast.
+        /// </summary>
+        vector<Transformable*> entities;
+        vector<BodyFlags> flags;
+    };
+
+    /// <summary>
+    /// BodyArchetypes groups Bodies with entities by their component set, so systems can iterate every Sprite, Mesh, Shape or Text
+    /// without walking the hierarchy and casting each Body's entity. Bodies without an entity aren't stored. Bodies keep their archetype
+    /// and row, and remain the public interface to their data: changes made through a Body are written through to its row. The Renderer
+    /// advances Mesh animators from these rows each frame.
+    /// </summary>
+    class BodyArchetypes : public EngineSystem {
+    public:
+        BodyArchetypes();
+        /// <summary>
+        /// Resolve the component set provided by an entity
+        /// </summary>
+        /// <param name="entity">The Body's entity</param>
+        /// <returns>The entity's component set</returns>
+        static uint32_t getComponents(Transformable* entity);
+        /// <summary>
+        /// Add the Body to the archetype of its entity's component set. Bodies without an entity are ignored.
+        /// </summary>
+        /// <param name="body">The Body to add</param>
+        void add(Body* body);
+        /// <summary>
+        /// Remove the Body from its archetype, moving the archetype's last row into its place
+        /// </summary>
+        /// <param name="body">The Body to remove</param>
+        void remove(Body* body);
+        /// <summary>
+        /// Copy the Body's flags into its row
+        /// </summary>
+        /// <param name="body">The Body whose flags changed</param>
+        void updateFlags(Body* body);
+        /// <summary>
+        /// Call the function for each Body whose component set includes all of the components
+        /// </summary>
+        /// <param name="components">The required components</param>
+        /// <param name="function">The function to call with the Body, its entity and its flags</param>
+        void forEach(uint32_t components, function<void(Body*, Transformable*, const BodyFlags&)> function);
+        /// <summary>
+        /// Call the function for each Body with an entity of type T
+        /// </summary>
+        /// <typeparam name="T">Shape, Text, Sprite or Mesh</typeparam>
+        /// <param name="function">The function to call with the Body and its entity</param>
+        template<typename T>
+        void forEach(function<void(Body*, T*)> function) {
+            forEach(getComponent<T>(), [&function](Body* body, Transformable* entity, const BodyFlags& flags) { function(body, static_cast<T*>(entity)); });
+        }
+        /// <summary>
+        /// Return the archetypes
+        /// </summary>
+        /// <returns>Every archetype created so far, including empty ones</returns>
+        const vector<BodyArchetype>& getArchetypes() const;
+        /// <summary>
+        /// Return the number of Bodies whose component set includes all of the components
+        /// </summary>
+        /// <param name="components">The required components</param>
+        /// <returns>The number of matching Bodies</returns>
+        size_t getCount(uint32_t components) const;
+    private:
+        vector<BodyArchetype> archetypes;
+        unordered_map<uint32_t, size_t> archetypeIndices;
+
+        template<typename T>
+        static constexpr uint32_t getComponent() {
+            if constexpr (is_same_v<T, Mesh>) return ComponentMesh;
+            else if constexpr (is_same_v<T, Sprite>) return ComponentSprite;
+            else if constexpr (is_same_v<T, Text>) return ComponentText;
+            else {
+                static_assert(is_same_v<T, Shape>, "Archetypes are iterated by Shape, Text, Sprite or Mesh");
+                return ComponentShape;
+            }
+        }
+    };
+}
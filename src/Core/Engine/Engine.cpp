@@ -1,4 +1,5 @@
 #include "Engine.h"
+#include "EngineContext.h"
 
 namespace CGEngine {
     //Size and name to give created window
@@ -7,19 +8,11 @@ namespace CGEngine {
     OpenGLSettings openGLSettings = OpenGLSettings(true, true);
     //List of Scenes to create, add to World and load sceneList[0]
     vector<Behavior*> sceneList = { };
-    Logging log;
-    GlobalTime time;
-    Renderer renderer;
-    AssetManager assets;
-    InputMap* input = new InputMap();
-    
-    //Window Size & Window Title
-    Screen* screen = new Screen(windowParameters.windowSize, windowParameters.windowTitle);
-    World* world = new World();
     function<void()> beginWorld = []() { world->startWorld(); world->runWorld(); };
-    function<Camera* ()> getCamera = []() { return renderer.getCurrentCamera(); };
+    function<Camera* ()> getCamera = []() { return renderer->getCurrentCamera(); };
 
     const string onUpdateEvent = "update";
+    const string onFixedUpdateEvent = "fixedUpdate";
     const string onStartEvent = "start";
     const string onDeleteEvent = "delete";
     const string onIntersectEvent = "intersect";
@@ -30,4 +23,7 @@ namespace CGEngine {
     const string onLoadEvent = "load";
 
     const float minHolographicNearClip = 0.000000000001f;
+
+    //Create the default context (and its World) on the main thread during static initialization, after the constants it uses
+    static EngineContext& defaultContext = EngineContext::getDefault();
 }
\ No newline at end of file
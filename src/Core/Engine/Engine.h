@@ -6,23 +6,54 @@
 #include "../Time/GlobalTime.h"
 #include "SFML/Graphics.hpp"
 #include "../AssetManager/AssetManager.h"
+#include "../Jobs/JobSystem.h"
+#include "EngineContext.h"
 
 namespace CGEngine {
 	extern WindowParameters windowParameters;
 	extern OpenGLSettings openGLSettings;
-	extern Renderer renderer;
-	extern World* world;
-	extern GlobalTime time;
-	extern InputMap* input;
-	extern Screen* screen;
 	extern function<void()> updateWorld;
 	extern function<void()> beginWorld;
 	extern function<Camera*()> getCamera;
 	extern vector<Behavior*> sceneList;
-	extern Logging log;
-	extern AssetManager assets;
+
+	//One of the systems of the calling thread's EngineContext. The context is looked up on each access rather than bound once, so a thread
+	//that makes a context current uses its systems from then on, however its thread-local storage was initialized.
+	template <typename T, T EngineContext::* member>
+	class EngineName {
+	public:
+		T& get() const {
+			return EngineContext::current().*member;
+		}
+		operator T&() const {
+			return get();
+		}
+		//Systems held by pointer are reached through the pointer itself
+		auto operator->() const {
+			if constexpr (is_pointer_v<T>) {
+				return get();
+			} else {
+				return &get();
+			}
+		}
+		template <typename... Args>
+		decltype(auto) operator()(Args&&... args) const {
+			return get()(forward<Args>(args)...);
+		}
+	};
+
+	//The systems of the calling thread's EngineContext
+	inline constexpr EngineName<Renderer, &EngineContext::renderer> renderer;
+	inline constexpr EngineName<World*, &EngineContext::world> world;
+	inline constexpr EngineName<GlobalTime, &EngineContext::time> time;
+	inline constexpr EngineName<InputMap*, &EngineContext::input> input;
+	inline constexpr EngineName<Screen*, &EngineContext::screen> screen;
+	inline constexpr EngineName<Logging, &EngineContext::log> log;
+	inline constexpr EngineName<AssetManager, &EngineContext::assets> assets;
+	inline constexpr EngineName<JobSystem, &EngineContext::jobs> jobs;
 
 	extern const string onUpdateEvent;
+	extern const string onFixedUpdateEvent;
 	extern const string onStartEvent;
 	extern const string onDeleteEvent;
 	extern const string onIntersectEvent;
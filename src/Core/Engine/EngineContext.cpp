@@ -0,0 +1,71 @@
+#include "Engine.h"
+#include "EngineContext.h"
+
+namespace CGEngine {
+	//The context the calling thread's engine names refer to. Constant initialized, so it doesn't depend on when thread-local storage is initialized.
+	static thread_local EngineContext* currentContext = nullptr;
+
+	EngineContext::Binding::Binding(EngineContext* context) : context(context) {
+		bind();
+	}
+
+	EngineContext::Binding::~Binding() {
+		restore();
+	}
+
+	void EngineContext::Binding::bind() {
+		previous = currentContext;
+		currentContext = context;
+	}
+
+	void EngineContext::Binding::restore() {
+		if (currentContext == context) {
+			//A context destroyed while current is no longer used, so the thread falls back to the default context
+			currentContext = previous != context ? previous : nullptr;
+		}
+	}
+
+	EngineContext::EngineContext() : binding(this) {
+		input = new InputMap();
+		screen = new Screen(windowParameters.windowSize, windowParameters.windowTitle);
+		world = new World();
+		binding.restore();
+	}
+
+	EngineContext::~EngineContext() {
+		//Restored when the binding is destroyed, after the systems
+		binding.bind();
+		destroying = true;
+		jobs.stop();
+		renderer.setPipelinedEnabled(false);
+		//Bodies are owned by the AssetManager and unregister themselves from the World when deleted
+		assets.clear();
+		delete world;
+		world = nullptr;
+		delete screen;
+		screen = nullptr;
+		delete input;
+		input = nullptr;
+	}
+
+	EngineContext& EngineContext::current() {
+		if (currentContext == nullptr) {
+			currentContext = &getDefault();
+		}
+		return *currentContext;
+	}
+
+	EngineContext& EngineContext::getDefault() {
+		//Never deleted, like the globals it replaces
+		static EngineContext* defaultContext = new EngineContext();
+		return *defaultContext;
+	}
+
+	bool EngineContext::makeCurrent() {
+		if (destroying) {
+			return false;
+		}
+		currentContext = this;
+		return true;
+	}
+}
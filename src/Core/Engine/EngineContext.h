@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../World/Renderer.h"
+#include "../World/World.h"
+#include "../Input/InputMap.h"
+#include "../Time/GlobalTime.h"
+#include "../AssetManager/AssetManager.h"
+#include "../Jobs/JobSystem.h"
+
+namespace CGEngine {
+	//Declared here too, since the engine names are declared while World.h is still being included
+	class World;
+	class InputMap;
+	class Screen;
+
+	// An EngineContext owns one instance of every engine system: the World and the systems it runs on. The engine's free names
+	// (world, renderer, time, assets, input, screen, log and jobs) refer to the current context of the calling thread, which is
+	// looked up each time a name is used: the context made current on the thread, or the default context if there is none.
+	// A context is only current on the thread constructing or destroying it while it does, after which the thread's previous context
+	// is restored, so a thread hosts its own World by constructing a context and making it current. Threads the engine starts for a
+	// context (job workers, the render thread and scene loads) make it current first.
+
+	class EngineContext {
+	private:
+		//Makes the context current while its systems are constructed and destroyed, since they use the free names. Declared first, so it
+		//is destroyed after every system.
+		struct Binding {
+			Binding(EngineContext* context);
+			~Binding();
+			//Make the context current, remembering the calling thread's previous context
+			void bind();
+			//Make the previous context current again, or none if the previous context was this one
+			void restore();
+
+			EngineContext* context;
+			EngineContext* previous = nullptr;
+		} binding;
+	public:
+		EngineContext();
+		~EngineContext();
+		EngineContext(const EngineContext&) = delete;
+		EngineContext& operator=(const EngineContext&) = delete;
+		/// <summary>
+		/// Return the calling thread's current context, or the default context if it has none
+		/// </summary>
+		static EngineContext& current();
+		/// <summary>
+		/// Return the context created for the process, which a thread uses until it makes another context current
+		/// </summary>
+		static EngineContext& getDefault();
+		/// <summary>
+		/// Make this the calling thread's context, which the engine names refer to from then on
+		/// </summary>
+		/// <returns>False if the context is being destroyed, in which case the thread's context is unchanged</returns>
+		bool makeCurrent();
+
+		GlobalTime time;
+		Logging log;
+		Renderer renderer;
+		AssetManager assets;
+		JobSystem jobs;
+		InputMap* input = nullptr;
+		Screen* screen = nullptr;
+		World* world = nullptr;
+	private:
+		//Set when destruction starts, so threads still being started or finishing for the context don't make it current
+		atomic<bool> destroying{ false };
+	};
+}
@@ -23,10 +23,10 @@ namespace CGEngine {
 			ImportResult result = processNode(scene->mRootNode, scene, modelBones, modelMaterials);
 			result.materials = modelMaterials;
 			//If skeletonName is empty or if that skeleton exists but doesn't have matching bones, use a name that will create a new skeleton
-			string newSkeletonName = (skeletonName.empty() || (!skeletonName.empty() && !assets.get<Skeleton>(skeletonName)->equals(modelBones))) ? path.append("_Skeleton") : skeletonName;
-			optional<id_t> skeletonId = assets.create<Skeleton>(newSkeletonName, modelBones);
+			string newSkeletonName = (skeletonName.empty() || (!skeletonName.empty() && !assets->get<Skeleton>(skeletonName)->equals(modelBones))) ? path.append("_Skeleton") : skeletonName;
+			optional<id_t> skeletonId = assets->create<Skeleton>(newSkeletonName, modelBones);
 			if (skeletonId.has_value()) {
-				result.skeleton = assets.get<Skeleton>(skeletonId.value());
+				result.skeleton = assets->get<Skeleton>(skeletonId.value());
 			}
 			//Import animations for the model bones
 			importAnimations(scene, result.skeleton, result.animations);
@@ -54,7 +54,7 @@ namespace CGEngine {
 				if (!animation) continue;
 
 				// Cache the animation using AssetManager
-				optional<id_t> animationId = assets.add<Animation>(animName, move(animation));
+				optional<id_t> animationId = assets->add<Animation>(animName, move(animation));
 				if (animationId.has_value()) {
 					modelAnimations.push_back(animName);
 					//log(this, LogInfo, "  - Successfully Imported Animation '{}' with {} Channels and {} Bones", animation->getName(), anim->mNumChannels, animation->bones.size());
@@ -115,7 +115,7 @@ namespace CGEngine {
 				SurfaceDomain specularDomain = SurfaceDomain(specularTexture, fromAiColor4(specularColor), (*roughness) * (*shininess));
 				SurfaceDomain opacityDomain = SurfaceDomain(opacityTexture, Color::White, *opacity);
 				SurfaceParameters surfaceParams = SurfaceParameters(diffuseDomain, specularDomain);
-				optional<id_t> worldMaterialId = assets.create<Material>(modelMaterial->GetName().C_Str(), surfaceParams, assets.get<Program>(assets.defaultProgramName));
+				optional<id_t> worldMaterialId = assets->create<Material>(modelMaterial->GetName().C_Str(), surfaceParams, assets->get<Program>(assets->defaultProgramName));
 				if (!worldMaterialId.has_value()) {
 					log(this, LogWarn, "  - {} Material: '{}' Failed to create world material!", modelMaterialId, modelMaterial->GetName().C_Str());
 				} else {
@@ -235,8 +235,8 @@ namespace CGEngine {
 			}
 			
 			//Finally, create MeshData with node name, vertices, indices, and modelBones
-			optional<id_t> meshDataId = assets.create<MeshData>(mesh->mName.C_Str(), fromSceneNode->mName.C_Str(), vertices, indices, modelBones);
-			toModelNode->meshData = assets.get<MeshData>(meshDataId.value());
+			optional<id_t> meshDataId = assets->create<MeshData>(mesh->mName.C_Str(), fromSceneNode->mName.C_Str(), vertices, indices, modelBones);
+			toModelNode->meshData = assets->get<MeshData>(meshDataId.value());
 			//Set the node materialId to the world material id for this node
 			toModelNode->materialId = modelMaterials[mesh->mMaterialIndex];
 			log(this, LogDebug, "  - Created node with Material Id {}, {} vertices, {} indices, and {} bones", toModelNode->materialId, toModelNode->meshData->vertices.size(), toModelNode->meshData->indices.size(), toModelNode->meshData->bones.size());
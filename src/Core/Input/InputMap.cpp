@@ -12,7 +12,8 @@ namespace CGEngine {
         ScriptDomain* domain = nullptr;
         auto iterator = domains.find(domainCondition);
         if (iterator == domains.end()) {
-            domains[domainCondition] = new ScriptDomain("");
+            //Input domains are keyed by their InputCondition, so they share one domain name
+            domains[domainCondition] = new ScriptDomain(DomainRegistry::intern("input"), "InputMap");
             domain = domains[domainCondition];
         } else {
             domain = (*iterator).second;
@@ -56,11 +57,11 @@ namespace CGEngine {
         }
     }
 
-    void InputMap::eraseActuatorIds(map<InputCondition,vector<id_t>> scriptIds) {
+    void InputMap::eraseActuatorIds(const map<InputCondition,vector<id_t>>& scriptIds) {
         for (auto iterator = scriptIds.begin(); iterator != scriptIds.end(); ++iterator) {
             ScriptDomain* domain = getDomain((*iterator).first);
             if(domain!=nullptr){
-                vector<id_t> ids = (*iterator).second;
+                const vector<id_t>& ids = (*iterator).second;
                 for (int i = ids.size() - 1; i >= 0; i--) {
                     domain->eraseScript(ids[i]);
                 }
@@ -129,31 +130,165 @@ namespace CGEngine {
         }
     }
 
+    void InputMap::callDomain(InputCondition domainCondition, const ScriptPayload& payload) {
+        if (ScriptDomain* domain = getDomain(domainCondition)) {
+            domain->callDomainWithEvent(nullptr, nullptr, payload);
+        }
+    }
+
+    void InputMap::inject(const Event& event) {
+        injectedEvents.push_back(event);
+    }
+
     void InputMap::gather() {
-        //Poll window events
-        while (const optional event = window->pollEvent()) {
-            if (event->is<Event::Closed>()) {
-                world->endWorld();
-            } else if (const auto* keyReleased = event->getIf<Event::KeyReleased>()) {
-                callDomain(InputCondition((int)keyReleased->scancode, InputType::Key, InputState::Released), map<string, any>({ {"evt",keyReleased} }));
+        //Poll window events. Injected events are handled after the window's, in the order they were injected.
+        vector<Event>& events = frameEvents;
+        events.clear();
+        if (window != nullptr) {
+            while (const optional event = window->pollEvent()) {
+                events.push_back(*event);
             }
-            else if (const auto* keyPressed = event->getIf<Event::KeyPressed>()) {
-                callDomain(InputCondition((int)keyPressed->scancode, InputType::Key, InputState::Pressed), map<string, any>({ {"evt",keyPressed } }));
+        }
+        events.insert(events.end(), injectedEvents.begin(), injectedEvents.end());
+        injectedEvents.clear();
+
+        if (trace.isRecording() || trace.isReplaying()) {
+            uint64_t checksum = world->getStateChecksum();
+            if (trace.isRecording()) {
+                trace.recordFrame(time->getDeltaSec(), time->getElapsedSec(), checksum, events);
             }
-            else if (const auto* mousePressed = event->getIf<Event::MouseButtonPressed>()) {
-                callDomain(InputCondition((int)mousePressed->button, InputType::Button, InputState::Pressed), map<string, any>({ {"evt",mousePressed } }));
+            if (trace.isReplaying()) {
+                //Only the recorded events are handled, but the window can still be closed
+                vector<Event> replayed;
+                if (trace.replayFrame(checksum, replayed)) {
+                    for (const Event& event : events) {
+                        if (event.is<Event::Closed>()) {
+                            replayed.push_back(event);
+                        }
+                    }
+                    events.swap(replayed);
+                    time->lockNextDelta(trace.getNextDeltaSec(), trace.getNextElapsedSec());
+                } else {
+                    stopReplay();
+                }
             }
-            else if (const auto* mouseReleased = event->getIf<Event::MouseButtonReleased>()) {
-                callDomain(InputCondition((int)mouseReleased->button, InputType::Button, InputState::Released), map<string, any>({ {"evt",mouseReleased } }));
+        }
+
+        //Traces hold the raw events, and coalescing the same events always gives the same result, so replays dispatch what was recorded
+        coalesceCursorMoves();
+    }
+
+    void InputMap::coalesceCursorMoves() {
+        cursorPath.clear();
+        lastCoalescedCount = 0;
+        lastSavedHandlerCount = 0;
+        size_t kept = 0;
+        for (size_t i = 0; i < frameEvents.size(); i++) {
+            if (const auto* mouseMoved = frameEvents[i].getIf<Event::MouseMoved>()) {
+                cursorPath.push_back(mouseMoved->position);
+                //A move followed directly by another is superseded by it. Moves separated by any other event are kept, so presses and
+                //releases still see the cursor where it was.
+                if (cursorCoalescing && i + 1 < frameEvents.size() && frameEvents[i + 1].is<Event::MouseMoved>()) {
+                    lastCoalescedCount++;
+                    continue;
+                }
             }
-            else if (const auto* textEntered = event->getIf<Event::TextEntered>()) {
-                callDomain(InputCondition(0, InputType::Character, InputState::Atomic), map<string, any>({ {"evt", textEntered } }));
+            if (kept != i) {
+                frameEvents[kept] = frameEvents[i];
             }
-            else if (const auto* mouseMoved = event->getIf<Event::MouseMoved>()) {
-                cursorPosition = mouseMoved->position;
-                callDomain(InputCondition(0, InputType::Cursor, InputState::Atomic), map<string, any>({ {"evt", mouseMoved->position } }));
-            } else if (const auto* resized = event->getIf<sf::Event::Resized>()) {
-                // adjust the viewport when the window is resized
+            kept++;
+        }
+        frameEvents.erase(frameEvents.begin() + kept, frameEvents.end());
+        if (ScriptDomain* cursorDomain = getCursorDomain()) {
+            lastSavedHandlerCount = lastCoalescedCount * cursorDomain->getScriptCount();
+        }
+    }
+
+    void InputMap::dispatch() {
+        //Events injected by handlers are queued for the next frame's gather, so the buffer doesn't change while it is dispatched
+        for (const Event& event : frameEvents) {
+            handleEvent(event);
+        }
+        lastDispatchedCount = frameEvents.size();
+        frameEvents.clear();
+    }
+
+    void InputMap::setCoalesceCursorMoves(bool coalesce) {
+        cursorCoalescing = coalesce;
+    }
+
+    bool InputMap::getCoalesceCursorMoves() const {
+        return cursorCoalescing;
+    }
+
+    const vector<Vector2i>& InputMap::getCursorPath() const {
+        return cursorPath;
+    }
+
+    size_t InputMap::getLastDispatchedCount() const {
+        return lastDispatchedCount;
+    }
+
+    size_t InputMap::getLastCoalescedCount() const {
+        return lastCoalescedCount;
+    }
+
+    size_t InputMap::getLastSavedHandlerCount() const {
+        return lastSavedHandlerCount;
+    }
+
+    bool InputMap::startRecording(const filesystem::path& path) {
+        if (!trace.startRecording(path, time->getElapsedSec())) return false;
+        //Every read in a recorded frame sees the elapsed time that is recorded for it
+        time->setElapsedPerFrame(true);
+        return true;
+    }
+
+    void InputMap::stopRecording() {
+        trace.stopRecording();
+        time->setElapsedPerFrame(false);
+    }
+
+    bool InputMap::startReplay(const filesystem::path& path) {
+        if (!trace.startReplay(path)) return false;
+        //Replay each frame at its recorded elapsed time so timers expire on the same frames
+        time->lockNextDelta(trace.getNextDeltaSec(), trace.getNextElapsedSec());
+        return true;
+    }
+
+    void InputMap::stopReplay() {
+        trace.stopReplay();
+        time->unlockDelta();
+    }
+
+    InputTrace& InputMap::getTrace() {
+        return trace;
+    }
+
+    void InputMap::handleEvent(const Event& event) {
+        if (event.is<Event::Closed>()) {
+            world->endWorld();
+        } else if (const auto* keyReleased = event.getIf<Event::KeyReleased>()) {
+            callDomain(InputCondition((int)keyReleased->scancode, InputType::Key, InputState::Released), ScriptPayload::of(*keyReleased));
+        }
+        else if (const auto* keyPressed = event.getIf<Event::KeyPressed>()) {
+            callDomain(InputCondition((int)keyPressed->scancode, InputType::Key, InputState::Pressed), ScriptPayload::of(*keyPressed));
+        }
+        else if (const auto* mousePressed = event.getIf<Event::MouseButtonPressed>()) {
+            callDomain(InputCondition((int)mousePressed->button, InputType::Button, InputState::Pressed), ScriptPayload::of(*mousePressed));
+        }
+        else if (const auto* mouseReleased = event.getIf<Event::MouseButtonReleased>()) {
+            callDomain(InputCondition((int)mouseReleased->button, InputType::Button, InputState::Released), ScriptPayload::of(*mouseReleased));
+        }
+        else if (const auto* textEntered = event.getIf<Event::TextEntered>()) {
+            callDomain(InputCondition(0, InputType::Character, InputState::Atomic), ScriptPayload::of(*textEntered));
+        }
+        else if (const auto* mouseMoved = event.getIf<Event::MouseMoved>()) {
+            cursorPosition = mouseMoved->position;
+            callDomain(InputCondition(0, InputType::Cursor, InputState::Atomic), ScriptPayload::of(*mouseMoved));
+        } else if (const auto* resized = event.getIf<sf::Event::Resized>()) {
+            // adjust the viewport when the window is resized
+            if (window != nullptr) {
                 glViewport(0, 0, resized->size.x, resized->size.y);
             }
         }
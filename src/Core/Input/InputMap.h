@@ -3,6 +3,7 @@
 #include "SFML/Graphics.hpp"
 #include "../Scripts/ScriptDomain.h"
 #include "../Scripts/Actuator.h"
+#include "InputTrace.h"
 using namespace sf;
 using namespace std;
 
@@ -34,18 +35,52 @@ namespace CGEngine {
         void removeActuator(InputCondition domainCondition, Script* script);
         void eraseActuator(InputCondition domainCondition, id_t scriptId);
         void eraseActuator(InputCondition domainCondition, Script* script);
-        void eraseActuatorIds(map<InputCondition, vector<id_t>> scriptIds);
+        void eraseActuatorIds(const map<InputCondition, vector<id_t>>& scriptIds);
         ScriptDomain* getDomain(InputCondition domainCondition);
         ScriptDomain* getKeyDomain(int input, InputState state);
         ScriptDomain* getButtonDomain(int input, InputState state);
         ScriptDomain* getCharacterDomain();
         ScriptDomain* getCursorDomain();
         void callDomain(InputCondition domainCondition, optional<map<string, any>> input = nullopt);
+        //Call the domain's Actuators with a typed event, which they read through ScArgs::getEvent
+        void callDomain(InputCondition domainCondition, const ScriptPayload& payload);
+        //Queue an event to be handled with the window's events in the next gather. Used to drive input without a window.
+        void inject(const Event& event);
+        //Record the events gathered each frame, with the frame's delta and elapsed time and the World's checksum, to path. While recording, the elapsed time is read once per frame.
+        bool startRecording(const filesystem::path& path);
+        void stopRecording();
+        //Replay recorded events, ignoring the window's input and locking each frame's delta and elapsed time to the recorded ones
+        bool startReplay(const filesystem::path& path);
+        void stopReplay();
+        InputTrace& getTrace();
+        //Set whether consecutive cursor moves within a frame are coalesced into the last one. The full path is still kept.
+        void setCoalesceCursorMoves(bool coalesce);
+        bool getCoalesceCursorMoves() const;
+        //Return every cursor position moved through in the last dispatched frame, including those of coalesced moves
+        const vector<Vector2i>& getCursorPath() const;
+        //Return the number of events dispatched by the last frame, the number of cursor moves coalesced away, and the cursor handler calls that saved
+        size_t getLastDispatchedCount() const;
+        size_t getLastCoalescedCount() const;
+        size_t getLastSavedHandlerCount() const;
     protected:
         friend class World;
-        RenderWindow* window;
+        RenderWindow* window = nullptr;
         map<InputCondition, ScriptDomain*> domains;
+        vector<Event> injectedEvents;
+        InputTrace trace;
+        //Poll the window and take the injected events into the frame's buffer, recording or replaying them, then coalesce cursor moves
         void gather();
+        //Handle the frame's buffered events in order. Called by the World once per frame, right after gather.
+        void dispatch();
+        void handleEvent(const Event& event);
+        //Drop each cursor move that is directly followed by another, adding every move's position to the cursor path
+        void coalesceCursorMoves();
+        vector<Event> frameEvents;
+        vector<Vector2i> cursorPath;
+        bool cursorCoalescing = true;
+        size_t lastDispatchedCount = 0;
+        size_t lastCoalescedCount = 0;
+        size_t lastSavedHandlerCount = 0;
         optional<Vector2i> cursorPosition = nullopt;
     };
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "InputTrace.h"
+#include "../Engine/Engine.h"
+
+namespace CGEngine {
+    InputTrace::InputTrace() {
+        init();
+    }
+
+    InputTrace::~InputTrace() {
+        stopRecording();
+    }
+
+    bool InputTrace::startRecording(const filesystem::path& path, float startElapsedSec) {
+        stopRecording();
+        file.open(path, ios::binary | ios::trunc);
+        if (!file) {
+            log(this, LogError, "Failed to open '{}' to record input", path.string());
+            return false;
+        }
+        header = InputTraceHeader();
+        header.startElapsedSec = startElapsedSec;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        recording = true;
+        frameIndex = 0;
+        log(this, LogInfo, "Recording input to '{}'", path.string());
+        return true;
+    }
+
+    void InputTrace::recordFrame(float deltaSec, float elapsedSec, uint64_t checksum, const vector<Event>& frameEvents) {
+        if (!recording) return;
+        encoded.clear();
+        InputTraceEvent traced;
+        for (const Event& event : frameEvents) {
+            if (encode(event, traced)) {
+                encoded.push_back(traced);
+            }
+        }
+        //Value initialized, which zeroes any padding bytes too, so the bytes written are deterministic
+        InputTraceFrame frame{};
+        frame.frame = (uint32_t)frameIndex++;
+        frame.deltaSec = deltaSec;
+        frame.checksum = checksum;
+        frame.eventCount = (uint32_t)encoded.size();
+        frame.elapsedSec = elapsedSec;
+        file.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+        file.write(reinterpret_cast<const char*>(encoded.data()), encoded.size() * sizeof(InputTraceEvent));
+    }
+
+    void InputTrace::stopRecording() {
+        if (!recording) return;
+        file.close();
+        recording = false;
+        log(this, LogInfo, "Recorded {} frames of input", frameIndex);
+    }
+
+    bool InputTrace::startReplay(const filesystem::path& path) {
+        ifstream traceFile(path, ios::binary);
+        if (!traceFile || !traceFile.read(reinterpret_cast<char*>(&header), sizeof(header)) || memcmp(header.magic, InputTraceHeader().magic, sizeof(header.magic)) != 0) {
+            log(this, LogError, "'{}' is not an input trace", path.string());
+            return false;
+        }
+        if (header.version != inputTraceVersion) {
+            log(this, LogError, "Unsupported input trace version {} in '{}'", header.version, path.string());
+            return false;
+        }
+        frames.clear();
+        events.clear();
+        InputTraceFrame frame;
+        while (traceFile.read(reinterpret_cast<char*>(&frame), sizeof(frame))) {
+            size_t eventStart = events.size();
+            events.resize(eventStart + frame.eventCount);
+            if (!traceFile.read(reinterpret_cast<char*>(events.data() + eventStart), frame.eventCount * sizeof(InputTraceEvent))) {
+                log(this, LogWarn, "Input trace '{}' is truncated after {} frames", path.string(), frames.size());
+                events.resize(eventStart);
+                break;
+            }
+            frames.push_back(frame);
+        }
+        replaying = true;
+        frameIndex = 0;
+        eventIndex = 0;
+        divergedFrame = nullopt;
+        log(this, LogInfo, "Replaying {} frames of input from '{}'", frames.size(), path.string());
+        return true;
+    }
+
+    bool InputTrace::replayFrame(uint64_t checksum, vector<Event>& frameEvents) {
+        if (!replaying || frameIndex >= frames.size()) return false;
+        const InputTraceFrame& frame = frames[frameIndex];
+        if (frame.checksum != checksum && !divergedFrame.has_value()) {
+            divergedFrame = frameIndex;
+            log(this, LogWarn, "Replay diverged from the recording at frame {}", frameIndex);
+        }
+        for (uint32_t i = 0; i < frame.eventCount; i++) {
+            frameEvents.push_back(decode(events[eventIndex++]));
+        }
+        frameIndex++;
+        return true;
+    }
+
+    void InputTrace::stopReplay() {
+        if (!replaying) return;
+        replaying = false;
+        if (divergedFrame.has_value()) {
+            log(this, LogWarn, "Replayed {} frames. Diverged at frame {}", frameIndex, divergedFrame.value());
+        } else {
+            log(this, LogInfo, "Replayed {} frames without divergence", frameIndex);
+        }
+        frames.clear();
+        events.clear();
+    }
+
+    float InputTrace::getNextDeltaSec() const {
+        return frameIndex < frames.size() ? frames[frameIndex].deltaSec : 0.f;
+    }
+
+    float InputTrace::getNextElapsedSec() const {
+        return frameIndex < frames.size() ? frames[frameIndex].elapsedSec : header.startElapsedSec;
+    }
+
+    bool InputTrace::encode(const Event& event, InputTraceEvent& traced) {
+        traced = InputTraceEvent();
+        if (event.is<Event::Closed>()) {
+            traced.type = TraceEventType::Closed;
+        } else if (const auto* resized = event.getIf<Event::Resized>()) {
+            traced.type = TraceEventType::Resized;
+            traced.values[0] = (int32_t)resized->size.x;
+            traced.values[1] = (int32_t)resized->size.y;
+        } else if (const auto* textEntered = event.getIf<Event::TextEntered>()) {
+            traced.type = TraceEventType::TextEntered;
+            traced.values[0] = (int32_t)textEntered->unicode;
+        } else if (const auto* keyPressed = event.getIf<Event::KeyPressed>()) {
+            traced.type = TraceEventType::KeyPressed;
+            traced.values[0] = (int32_t)keyPressed->scancode;
+            traced.values[1] = (int32_t)keyPressed->code;
+            traced.values[2] = keyPressed->alt | keyPressed->control << 1 | keyPressed->shift << 2 | keyPressed->system << 3;
+        } else if (const auto* keyReleased = event.getIf<Event::KeyReleased>()) {
+            traced.type = TraceEventType::KeyReleased;
+            traced.values[0] = (int32_t)keyReleased->scancode;
+            traced.values[1] = (int32_t)keyReleased->code;
+            traced.values[2] = keyReleased->alt | keyReleased->control << 1 | keyReleased->shift << 2 | keyReleased->system << 3;
+        } else if (const auto* buttonPressed = event.getIf<Event::MouseButtonPressed>()) {
+            traced.type = TraceEventType::ButtonPressed;
+            traced.values[0] = (int32_t)buttonPressed->button;
+            traced.values[1] = buttonPressed->position.x;
+            traced.values[2] = buttonPressed->position.y;
+        } else if (const auto* buttonReleased = event.getIf<Event::MouseButtonReleased>()) {
+            traced.type = TraceEventType::ButtonReleased;
+            traced.values[0] = (int32_t)buttonReleased->button;
+            traced.values[1] = buttonReleased->position.x;
+            traced.values[2] = buttonReleased->position.y;
+        } else if (const auto* mouseMoved = event.getIf<Event::MouseMoved>()) {
+            traced.type = TraceEventType::CursorMoved;
+            traced.values[1] = mouseMoved->position.x;
+            traced.values[2] = mouseMoved->position.y;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    Event InputTrace::decode(const InputTraceEvent& traced) {
+        const int32_t* values = traced.values;
+        switch (traced.type) {
+        case TraceEventType::Resized:
+            return Event::Resized{ { (unsigned int)values[0], (unsigned int)values[1] } };
+        case TraceEventType::TextEntered:
+            return Event::TextEntered{ (char32_t)values[0] };
+        case TraceEventType::KeyPressed:
+            return Event::KeyPressed{ (Keyboard::Key)values[1], (Keyboard::Scancode)values[0], (values[2] & 1) != 0, (values[2] & 2) != 0, (values[2] & 4) != 0, (values[2] & 8) != 0 };
+        case TraceEventType::KeyReleased:
+            return Event::KeyReleased{ (Keyboard::Key)values[1], (Keyboard::Scancode)values[0], (values[2] & 1) != 0, (values[2] & 2) != 0, (values[2] & 4) != 0, (values[2] & 8) != 0 };
+        case TraceEventType::ButtonPressed:
+            return Event::MouseButtonPressed{ (Mouse::Button)values[0], { values[1], values[2] } };
+        case TraceEventType::ButtonReleased:
+            return Event::MouseButtonReleased{ (Mouse::Button)values[0], { values[1], values[2] } };
+        case TraceEventType::CursorMoved:
+            return Event::MouseMoved{ { values[1], values[2] } };
+        default:
+            return Event::Closed{};
+        }
+    }
+}
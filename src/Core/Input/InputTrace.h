@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <type_traits>
+#include <vector>
+#include "SFML/Graphics.hpp"
+#include "../Engine/EngineSystem.h"
+using namespace sf;
+using namespace std;
+
+namespace CGEngine {
+    // An InputTrace records the window events InputMap gathers each frame, along with the frame's delta and elapsed time
+    // and a checksum of the World's state, into a compact binary file. Replaying the trace feeds the same events back on
+    // the same frames with the recorded delta and elapsed times locked, and compares each frame's checksum with the
+    // recorded one so any divergence from the recorded run is reported.
+
+    constexpr uint32_t inputTraceVersion = 2;
+
+    enum class TraceEventType : uint32_t { Closed, Resized, TextEntered, KeyPressed, KeyReleased, ButtonPressed, ButtonReleased, CursorMoved };
+
+    struct InputTraceHeader {
+        char magic[4] = { 'C','G','I','T' };
+        uint32_t version = inputTraceVersion;
+        float startElapsedSec = 0;             // Elapsed time when recording started, restored when replaying
+    };
+
+    struct InputTraceFrame {
+        uint32_t frame = 0;                    // Frame index since recording started
+        float deltaSec = 0;
+        uint64_t checksum = 0;                 // World state checksum when the frame's events were gathered
+        uint32_t eventCount = 0;
+        float elapsedSec = 0;                  // Elapsed time of the frame, which every time read in the frame returns
+    };
+
+    struct InputTraceEvent {
+        TraceEventType type = TraceEventType::Closed;
+        int32_t values[3] = { 0,0,0 };         // Scancode, key and modifier bits; button and position; or size, position and character
+    };
+
+    static_assert(is_trivially_copyable_v<InputTraceFrame> && is_trivially_copyable_v<InputTraceEvent>, "Input trace records must be trivially copyable");
+
+    class InputTrace : public EngineSystem {
+    public:
+        InputTrace();
+        ~InputTrace();
+        //Start recording frames to path
+        bool startRecording(const filesystem::path& path, float startElapsedSec);
+        //Record a frame's events. The checksum is of the World's state before the events are handled.
+        void recordFrame(float deltaSec, float elapsedSec, uint64_t checksum, const vector<Event>& events);
+        void stopRecording();
+        bool isRecording() const { return recording; }
+
+        //Load the trace at path for replay
+        bool startReplay(const filesystem::path& path);
+        //Return the recorded events of the next frame and compare its checksum, returning false once the trace is finished
+        bool replayFrame(uint64_t checksum, vector<Event>& events);
+        void stopReplay();
+        bool isReplaying() const { return replaying; }
+        //Return the delta time of the next frame to replay
+        float getNextDeltaSec() const;
+        //Return the elapsed time of the next frame to replay
+        float getNextElapsedSec() const;
+        float getStartElapsedSec() const { return header.startElapsedSec; }
+        //Return the first replayed frame whose checksum differed from the recorded one, if any
+        optional<size_t> getDivergedFrame() const { return divergedFrame; }
+        size_t getFrameIndex() const { return frameIndex; }
+
+        //Convert between SFML events and trace records. Returns false for event types that aren't traced.
+        static bool encode(const Event& event, InputTraceEvent& traced);
+        static Event decode(const InputTraceEvent& traced);
+    private:
+        InputTraceHeader header;
+        bool recording = false;
+        bool replaying = false;
+        ofstream file;
+        size_t frameIndex = 0;
+        vector<InputTraceEvent> encoded;
+
+        //Replay data
+        vector<InputTraceFrame> frames;
+        vector<InputTraceEvent> events;
+        size_t eventIndex = 0;
+        optional<size_t> divergedFrame = nullopt;
+    };
+}
@@ -0,0 +1,125 @@
+#include "CommandQueue.h"
+#include "../Engine/Engine.h"
+
+namespace CGEngine {
+	CommandQueue::CommandList::CommandList() {
+		CommandNode* stub = new CommandNode();
+		head = stub;
+		tail = stub;
+	}
+
+	CommandQueue::CommandList::~CommandList() {
+		CommandNode* node = tail;
+		while (node != nullptr) {
+			CommandNode* next = node->next.load(memory_order_relaxed);
+			delete node;
+			node = next;
+		}
+	}
+
+	void CommandQueue::CommandList::push(CommandNode* node) {
+		CommandNode* previous = head.exchange(node, memory_order_acq_rel);
+		previous->next.store(node, memory_order_release);
+	}
+
+	bool CommandQueue::CommandList::pop(function<void()>& command) {
+		CommandNode* next = tail->next.load(memory_order_acquire);
+		if (next == nullptr) return false;
+		//The popped node becomes the new stub
+		command = move(next->command);
+		delete tail;
+		tail = next;
+		return true;
+	}
+
+	CommandQueue::CommandQueue() {
+		init();
+	}
+
+	CommandQueue::~CommandQueue() {
+		if (pending > 0) {
+			log(this, LogWarn, "Discarding {} commands that were never run", pending.load());
+		}
+	}
+
+	void CommandQueue::post(function<void()> command, CommandPriority priority) {
+		CommandNode* node = new CommandNode();
+		node->command = move(command);
+		pending.fetch_add(1, memory_order_relaxed);
+		posted.fetch_add(1, memory_order_relaxed);
+		lists[(size_t)priority].push(node);
+	}
+
+	size_t CommandQueue::drain() {
+		Clock drainClock;
+		size_t count = 0;
+		function<void()> command;
+
+		//Only the commands queued when the drain starts are run, so a command that posts another can't keep the drain going
+		size_t available = pending.load(memory_order_relaxed);
+		while (count < available && lists[(size_t)CommandPriority::High].pop(command)) {
+			run(command);
+			count++;
+		}
+
+		size_t budgeted = 0;
+		for (size_t priority = (size_t)CommandPriority::Normal; priority < priorityCount; priority++) {
+			while (count < available) {
+				if (drainLimit > 0 && budgeted >= drainLimit) break;
+				if (drainBudgetMs > 0 && drainClock.getElapsedTime().asMicroseconds() / 1000.f >= drainBudgetMs) break;
+				if (!lists[priority].pop(command)) break;
+				run(command);
+				count++;
+				budgeted++;
+			}
+		}
+
+		lastDrainCount = count;
+		lastDrainMs = drainClock.getElapsedTime().asMicroseconds() / 1000.f;
+		return count;
+	}
+
+	void CommandQueue::run(function<void()>& command) {
+		//Counted as run before it's called, so a command that throws doesn't leave it pending or stop the drain
+		pending.fetch_sub(1, memory_order_relaxed);
+		try {
+			command();
+		} catch (const exception& ex) {
+			log(this, LogError, "Exception in command: {}", ex.what());
+		} catch (...) {
+			log(this, LogError, "Unknown exception in command");
+		}
+	}
+
+	void CommandQueue::setDrainBudget(float budgetMs) {
+		drainBudgetMs = max(budgetMs, 0.f);
+	}
+
+	float CommandQueue::getDrainBudget() const {
+		return drainBudgetMs;
+	}
+
+	void CommandQueue::setDrainLimit(size_t commandCount) {
+		drainLimit = commandCount;
+	}
+
+	size_t CommandQueue::getDrainLimit() const {
+		return drainLimit;
+	}
+
+	size_t CommandQueue::getPendingCount() const {
+		return pending.load(memory_order_relaxed);
+	}
+
+	size_t CommandQueue::getPostedCount() const {
+		return posted.load(memory_order_relaxed);
+	}
+
+	size_t CommandQueue::getLastDrainCount() const {
+		return lastDrainCount;
+	}
+
+	float CommandQueue::getLastDrainMs() const {
+		return lastDrainMs;
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include "SFML/System.hpp"
+#include "../Engine/EngineSystem.h"
+
+using namespace std;
+using namespace sf;
+
+namespace CGEngine {
+	enum class CommandPriority { High, Normal, Low };
+
+	/// <summary>
+	/// A lock-free multi-producer, single-consumer queue of commands for the main thread. Any thread can post a command, and the World
+	/// drains the queue at the start of each frame, before scenes are streamed and Bodies are started, so commands can safely touch the
+	/// World, the AssetManager and Bodies. High priority commands are always drained. Normal and then low priority commands are drained
+	/// until the frame's budget is spent, and the rest wait for the next frame.
+	/// </summary>
+	class CommandQueue : public EngineSystem {
+	public:
+		CommandQueue();
+		~CommandQueue();
+		/// <summary>
+		/// Queue a command to run on the main thread. Safe to call from any thread.
+		/// </summary>
+		/// <param name="command">The command to run</param>
+		/// <param name="priority">The priority to drain the command with</param>
+		void post(function<void()> command, CommandPriority priority = CommandPriority::Normal);
+		/// <summary>
+		/// Run queued commands within the budget. Called by the World on the main thread each frame. A command that throws is logged and the drain continues.
+		/// </summary>
+		/// <returns>The number of commands run</returns>
+		size_t drain();
+		/// <summary>
+		/// Set the milliseconds of normal and low priority commands run per drain. If 0, the time isn't limited.
+		/// </summary>
+		void setDrainBudget(float budgetMs);
+		float getDrainBudget() const;
+		/// <summary>
+		/// Set the maximum number of normal and low priority commands run per drain. If 0, the count isn't limited.
+		/// </summary>
+		void setDrainLimit(size_t commandCount);
+		size_t getDrainLimit() const;
+		/// <summary>
+		/// Return the number of commands posted but not yet run
+		/// </summary>
+		size_t getPendingCount() const;
+		/// <summary>
+		/// Return the number of commands posted since the queue was created
+		/// </summary>
+		size_t getPostedCount() const;
+		/// <summary>
+		/// Return the number of commands run by the last drain, and how long it took in milliseconds
+		/// </summary>
+		size_t getLastDrainCount() const;
+		float getLastDrainMs() const;
+	private:
+		struct CommandNode {
+			atomic<CommandNode*> next{ nullptr };
+			function<void()> command;
+		};
+
+		/// <summary>
+		/// An intrusive MPSC linked list. Producers swap themselves in as the head, and the consumer follows next pointers from the tail,
+		/// which is always a consumed (or stub) node.
+		/// </summary>
+		struct CommandList {
+			atomic<CommandNode*> head;
+			CommandNode* tail;
+			CommandList();
+			~CommandList();
+			void push(CommandNode* node);
+			//Move the oldest command into command. Returns false if the list is empty, or the next command is still being linked.
+			bool pop(function<void()>& command);
+		};
+
+		static constexpr size_t priorityCount = 3;
+		CommandList lists[priorityCount];
+		atomic<size_t> pending{ 0 };
+		atomic<size_t> posted{ 0 };
+		float drainBudgetMs = 2.f;
+		size_t drainLimit = 0;
+		size_t lastDrainCount = 0;
+		float lastDrainMs = 0;
+
+		//Run a popped command, logging any exception it throws
+		void run(function<void()>& command);
+	};
+}
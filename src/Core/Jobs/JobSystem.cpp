@@ -0,0 +1,156 @@
+#include "JobSystem.h"
+#include "../Engine/Engine.h"
+#include "../Engine/EngineContext.h"
+
+namespace CGEngine {
+	//Whether the current thread is running a job
+	static thread_local bool inJob = false;
+
+	JobSystem::JobSystem() {
+		init();
+	}
+
+	JobSystem::~JobSystem() {
+		stop();
+	}
+
+	void JobSystem::start(size_t threadCount) {
+		if (running) return;
+		if (threadCount == 0) {
+			threadCount = max((size_t)thread::hardware_concurrency(), (size_t)1);
+		}
+
+		running = true;
+		steals = 0;
+		queues.clear();
+		for (size_t i = 0; i < threadCount; i++) {
+			queues.push_back(make_unique<JobQueue>());
+		}
+		for (size_t i = 0; i + 1 < threadCount; i++) {
+			workers.emplace_back(&JobSystem::workerLoop, this, i, &EngineContext::current());
+		}
+		log(this, LogInfo, "Started JobSystem with {} threads", threadCount);
+	}
+
+	void JobSystem::stop() {
+		if (!running) return;
+		{
+			lock_guard<mutex> lock(wakeMutex);
+			running = false;
+		}
+		wakeCondition.notify_all();
+		for (thread& worker : workers) {
+			worker.join();
+		}
+		workers.clear();
+		queues.clear();
+	}
+
+	bool JobSystem::isRunning() const {
+		return running;
+	}
+
+	size_t JobSystem::getThreadCount() const {
+		return running ? workers.size() + 1 : 1;
+	}
+
+	size_t JobSystem::getStealCount() const {
+		return steals;
+	}
+
+	bool JobSystem::isInJob() {
+		return inJob;
+	}
+
+	void JobSystem::parallelFor(size_t count, size_t grainSize, function<void(size_t, size_t)> job) {
+		if (count == 0) return;
+		grainSize = max(grainSize, (size_t)1);
+		//Nested or single chunk work runs inline
+		if (!running || inJob || count <= grainSize) {
+			job(0, count);
+			return;
+		}
+
+		lock_guard<mutex> callerLock(callerMutex);
+		size_t chunkCount = (count + grainSize - 1) / grainSize;
+		atomic<size_t> remaining(chunkCount);
+		//The first exception thrown by a chunk, rethrown on the calling thread once every chunk has finished
+		exception_ptr failure;
+		mutex failureMutex;
+
+		{
+			lock_guard<mutex> lock(wakeMutex);
+			queuedJobs += chunkCount;
+		}
+		//Deal the chunks out round-robin so every thread starts with work of its own
+		for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+			size_t begin = chunk * grainSize;
+			size_t end = min(begin + grainSize, count);
+			JobQueue& queue = *queues[chunk % queues.size()];
+			lock_guard<mutex> lock(queue.queueMutex);
+			queue.jobs.push_back([&job, &remaining, &failure, &failureMutex, begin, end]() {
+				try {
+					job(begin, end);
+				} catch (...) {
+					lock_guard<mutex> lock(failureMutex);
+					if (!failure) failure = current_exception();
+				}
+				remaining.fetch_sub(1, memory_order_release);
+			});
+		}
+		wakeCondition.notify_all();
+
+		//The calling thread works through its own queue, then steals, until every chunk has finished
+		size_t callerIndex = queues.size() - 1;
+		while (remaining.load(memory_order_acquire) > 0) {
+			if (!runJob(callerIndex)) {
+				this_thread::yield();
+			}
+		}
+		if (failure) {
+			rethrow_exception(failure);
+		}
+	}
+
+	void JobSystem::workerLoop(size_t queueIndex, EngineContext* context) {
+		//Jobs use the engine names of the context that started the workers. If it's being destroyed, the other threads run the jobs.
+		if (!context->makeCurrent()) return;
+		while (running) {
+			if (runJob(queueIndex)) continue;
+			unique_lock<mutex> lock(wakeMutex);
+			wakeCondition.wait(lock, [this]() { return !running || queuedJobs > 0; });
+		}
+	}
+
+	bool JobSystem::runJob(size_t queueIndex) {
+		function<void()> job;
+		if (!popJob(queueIndex, false, job)) {
+			bool stolen = false;
+			for (size_t offset = 1; offset < queues.size() && !stolen; offset++) {
+				stolen = popJob((queueIndex + offset) % queues.size(), true, job);
+			}
+			if (!stolen) return false;
+			steals++;
+		}
+		queuedJobs--;
+
+		inJob = true;
+		job();
+		inJob = false;
+		return true;
+	}
+
+	bool JobSystem::popJob(size_t queueIndex, bool steal, function<void()>& job) {
+		JobQueue& queue = *queues[queueIndex];
+		lock_guard<mutex> lock(queue.queueMutex);
+		if (queue.jobs.empty()) return false;
+		if (steal) {
+			job = move(queue.jobs.front());
+			queue.jobs.pop_front();
+		} else {
+			job = move(queue.jobs.back());
+			queue.jobs.pop_back();
+		}
+		return true;
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../Engine/EngineSystem.h"
+
+using namespace std;
+
+namespace CGEngine {
+	class EngineContext;
+
+	/// <summary>
+	/// A work-stealing thread pool. Each worker thread (and the thread waiting on a parallelFor) owns a queue of jobs, taking new jobs
+	/// from the back of its own queue and stealing from the front of the others' queues when its own queue is empty.
+	/// </summary>
+	class JobSystem : public EngineSystem {
+	public:
+		JobSystem();
+		~JobSystem();
+		/// <summary>
+		/// Start the worker threads. The thread calling parallelFor also runs jobs, so threadCount - 1 workers are created.
+		/// </summary>
+		/// <param name="threadCount">The total number of threads to run jobs on. If 0, the hardware concurrency is used.</param>
+		void start(size_t threadCount = 0);
+		/// <summary>
+		/// Stop and join the worker threads
+		/// </summary>
+		void stop();
+		bool isRunning() const;
+		/// <summary>
+		/// Return the number of threads jobs run on, including the calling thread
+		/// </summary>
+		/// <returns>The number of threads</returns>
+		size_t getThreadCount() const;
+		/// <summary>
+		/// Split [0, count) into chunks of grainSize and run job on each chunk across the worker threads and the calling thread,
+		/// returning once every chunk has finished. Runs on the calling thread alone if the JobSystem isn't running. If a chunk throws, the
+		/// other chunks still run and the first exception is rethrown on the calling thread.
+		/// </summary>
+		/// <param name="count">The number of items</param>
+		/// <param name="grainSize">The maximum number of items per job</param>
+		/// <param name="job">The function to call with the beginning and end of each chunk</param>
+		void parallelFor(size_t count, size_t grainSize, function<void(size_t, size_t)> job);
+		/// <summary>
+		/// Return whether the current thread is running a job, in which case structural World changes must be deferred
+		/// </summary>
+		/// <returns>True if called from inside a job</returns>
+		static bool isInJob();
+		/// <summary>
+		/// Return the number of jobs taken from another thread's queue since the JobSystem was started
+		/// </summary>
+		/// <returns>The number of stolen jobs</returns>
+		size_t getStealCount() const;
+	private:
+		struct JobQueue {
+			mutex queueMutex;
+			deque<function<void()>> jobs;
+		};
+
+		vector<thread> workers;
+		//One queue per worker, followed by the queue of the thread calling parallelFor
+		vector<unique_ptr<JobQueue>> queues;
+		atomic<bool> running{ false };
+		atomic<size_t> queuedJobs{ 0 };
+		atomic<size_t> steals{ 0 };
+		mutex wakeMutex;
+		condition_variable wakeCondition;
+		//Serializes parallelFor calls, since the calling thread's queue is shared
+		mutex callerMutex;
+
+		void workerLoop(size_t queueIndex, EngineContext* context);
+		//Run one job from the queue at queueIndex, or one stolen from another queue. Returns false if there were no jobs.
+		bool runJob(size_t queueIndex);
+		bool popJob(size_t queueIndex, bool steal, function<void()>& job);
+	};
+}
@@ -11,7 +11,7 @@ namespace CGEngine {
 	}
 
 	void Logging::findUniqueFilepath() {
-		string systemTime = time.getSystemmTimeNowString();
+		string systemTime = time->getSystemmTimeNowString();
 		string dot = ".";
 		filepath.append(logDirectory).append(logFilename).append(".").append(systemTime).append(".txt");
 	}
@@ -38,8 +38,10 @@ namespace CGEngine {
 			//Build log message
 			string logMsg = string(logLevelPrompt).append(callerPrompt).append(formattedMsg).append("\n");
 			//Print and queue message
+			sec_t timestamp = time->getElapsedSec();
+			lock_guard<mutex> lock(logMutex);
 			cout << logMsg;
-			queueMsg(LogEvent(time.getElapsedSec(), logMsg));
+			logQueue.push(LogEvent(timestamp, logMsg));
 		}
 	}
 
@@ -62,10 +64,12 @@ namespace CGEngine {
 	}
 
 	void Logging::queueMsg(LogEvent msgEvt) {
+		lock_guard<mutex> lock(logMutex);
 		logQueue.push(msgEvt);
 	}
 
 	void Logging::writeQueue() {
+		lock_guard<mutex> lock(logMutex);
 		vector<char> msgBuffer;
 		while (logQueue.size()) {
 			LogEvent logEvt = logQueue.front();
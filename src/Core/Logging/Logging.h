@@ -7,6 +7,7 @@
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <mutex>
 #include "../Types/Types.h"
 #include "../Engine/EngineSystem.h"
 using std::string;
@@ -15,6 +16,7 @@ using std::queue;
 using std::ofstream;
 using std::ios;
 using std::stringstream;
+using std::mutex;
 namespace fs = std::filesystem;
 
 namespace CGEngine {
@@ -92,6 +94,8 @@ namespace CGEngine {
 		string logDirectory = "logs/";
 		bool active = true;
 		size_t precision = 2;
+		//Serializes the console and the log queue, since jobs may log from worker threads
+		mutex logMutex;
 		void log(LogLevel level, string caller, string msg, vector<string> args, size_t precision = 2);
 		string format(string msg, vector<string> args);
 		void findUniqueFilepath();
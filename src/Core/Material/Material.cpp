@@ -4,31 +4,32 @@
 namespace CGEngine {
 	Material::Material(ShaderProgramPath shaderPath) {
 		//TODO: Should materials using the same two shaders also use the same shader ref?
-		if (renderer.setGLWindowState(true)) {
+		//Created on the render thread while pipelined, before it draws the next frame
+		renderer->runGL([this, shaderPath]() {
 			shaderProgram = new Program(shaderPath);
-		}
+		});
 	}
 
 	Material::Material() { }
 
 	Material::Material(SurfaceParameters params) :Material() {
-		optional<id_t> diffuseTextureId = assets.load<TextureResource>(params.diffuseTexturePath);
-		optional<id_t> specularTextureId = assets.load<TextureResource>(params.specularTexturePath);
-		optional<id_t> opacityTextureId = assets.load<TextureResource>(params.opacityTexturePath);
+		optional<id_t> diffuseTextureId = assets->load<TextureResource>(params.diffuseTexturePath);
+		optional<id_t> specularTextureId = assets->load<TextureResource>(params.specularTexturePath);
+		optional<id_t> opacityTextureId = assets->load<TextureResource>(params.opacityTexturePath);
 		if (diffuseTextureId.has_value()) {
-			TextureResource* diffuseTexture = assets.get<TextureResource>(diffuseTextureId.value());
+			TextureResource* diffuseTexture = assets->get<TextureResource>(diffuseTextureId.value());
 			if (diffuseTexture) {
 				setParameter("diffuseTexture", diffuseTexture->getTexture(), ParamType::Texture2D);
 			}
 		}
 		if (specularTextureId.has_value()) {
-			TextureResource* specularTexture = assets.get<TextureResource>(specularTextureId.value());
+			TextureResource* specularTexture = assets->get<TextureResource>(specularTextureId.value());
 			if (specularTexture) {
 				setParameter("specularTexture", specularTexture->getTexture(), ParamType::Texture2D);
 			}
 		}
 		if (opacityTextureId.has_value()) {
-			TextureResource* opacityTexture = assets.get<TextureResource>(opacityTextureId.value());
+			TextureResource* opacityTexture = assets->get<TextureResource>(opacityTextureId.value());
 			if (opacityTexture) {
 				setParameter("opacityTexture", opacityTexture->getTexture(), ParamType::Texture2D);
 			}
@@ -64,23 +65,23 @@ namespace CGEngine {
 	}
 
 	Material::Material(SurfaceParameters params, ShaderProgramPath shaderPath) : Material(shaderPath) {
-		optional<id_t> diffuseTextureId = assets.load<TextureResource>(params.diffuseTexturePath);
-		optional<id_t> specularTextureId = assets.load<TextureResource>(params.specularTexturePath);
-		optional<id_t> opacityTextureId = assets.load<TextureResource>(params.opacityTexturePath);
+		optional<id_t> diffuseTextureId = assets->load<TextureResource>(params.diffuseTexturePath);
+		optional<id_t> specularTextureId = assets->load<TextureResource>(params.specularTexturePath);
+		optional<id_t> opacityTextureId = assets->load<TextureResource>(params.opacityTexturePath);
 		if (diffuseTextureId.has_value()) {
-			TextureResource* diffuseTexture = assets.get<TextureResource>(diffuseTextureId.value());
+			TextureResource* diffuseTexture = assets->get<TextureResource>(diffuseTextureId.value());
 			if (diffuseTexture) {
 				setParameter("diffuseTexture", diffuseTexture->getTexture(), ParamType::Texture2D);
 			}
 		}
 		if (specularTextureId.has_value()) {
-			TextureResource* specularTexture = assets.get<TextureResource>(specularTextureId.value());
+			TextureResource* specularTexture = assets->get<TextureResource>(specularTextureId.value());
 			if (specularTexture) {
 				setParameter("specularTexture", specularTexture->getTexture(), ParamType::Texture2D);
 			}
 		}
 		if (opacityTextureId.has_value()) {
-			TextureResource* opacityTexture = assets.get<TextureResource>(opacityTextureId.value());
+			TextureResource* opacityTexture = assets->get<TextureResource>(opacityTextureId.value());
 			if (opacityTexture) {
 				setParameter("opacityTexture", opacityTexture->getTexture(), ParamType::Texture2D);
 			}
@@ -116,23 +117,23 @@ namespace CGEngine {
 	}
 
 	Material::Material(SurfaceParameters params, Program* program) : shaderProgram(program) {
-		optional<id_t> diffuseTextureId = assets.load<TextureResource>(params.diffuseTexturePath);
-		optional<id_t> specularTextureId = assets.load<TextureResource>(params.specularTexturePath);
-		optional<id_t> opacityTextureId = assets.load<TextureResource>(params.opacityTexturePath);
+		optional<id_t> diffuseTextureId = assets->load<TextureResource>(params.diffuseTexturePath);
+		optional<id_t> specularTextureId = assets->load<TextureResource>(params.specularTexturePath);
+		optional<id_t> opacityTextureId = assets->load<TextureResource>(params.opacityTexturePath);
 		if (diffuseTextureId.has_value()) {
-			TextureResource* diffuseTexture = assets.get<TextureResource>(diffuseTextureId.value());
+			TextureResource* diffuseTexture = assets->get<TextureResource>(diffuseTextureId.value());
 			if (diffuseTexture) {
 				setParameter("diffuseTexture", diffuseTexture->getTexture(), ParamType::Texture2D);
 			}
 		}
 		if (specularTextureId.has_value()) {
-			TextureResource* specularTexture = assets.get<TextureResource>(specularTextureId.value());
+			TextureResource* specularTexture = assets->get<TextureResource>(specularTextureId.value());
 			if (specularTexture) {
 				setParameter("specularTexture", specularTexture->getTexture(), ParamType::Texture2D);
 			}
 		}
 		if (opacityTextureId.has_value()) {
-			TextureResource* opacityTexture = assets.get<TextureResource>(opacityTextureId.value());
+			TextureResource* opacityTexture = assets->get<TextureResource>(opacityTextureId.value());
 			if (opacityTexture) {
 				setParameter("opacityTexture", opacityTexture->getTexture(), ParamType::Texture2D);
 			}
@@ -2,10 +2,10 @@
 
 namespace CGEngine {
 	Mesh::Mesh(MeshData* meshData, Transformation3D transformation, vector<id_t> materials, RenderParameters renderParams, string importPath) : meshData(meshData), transformation(transformation), renderParameters(renderParams), materials(materials), importPath(importPath) {
-		renderer.getModelData(this);
+		renderer->getModelData(this);
 	};
 
-	Mesh::Mesh(string importPath, Transformation3D transformation, vector<id_t> materials, RenderParameters renderParams) : Mesh(assets.get<MeshData>(assets.create<MeshData>("").value()), transformation, materials, renderParams, importPath) {
+	Mesh::Mesh(string importPath, Transformation3D transformation, vector<id_t> materials, RenderParameters renderParams) : Mesh(assets->get<MeshData>(assets->create<MeshData>("").value()), transformation, materials, renderParams, importPath) {
 	
 	};
 
@@ -18,7 +18,7 @@ namespace CGEngine {
 	}
 
 	void Mesh::render(Transform transform) {
-		renderer.pullGL();
+		renderer->pullGL();
 
 		//Combine SFML entity transform components with 3D transformation components
 		Vector2f position2d = world->getGlobalPosition(transform);
@@ -31,12 +31,12 @@ namespace CGEngine {
 		Vector3f scale = { scale2d.x * transformation.scale.x,scale2d.y * transformation.scale.y, transformation.scale.z };
 		Transformation3D combinedTransformation = Transformation3D(position, rotation, scale);
 
-		renderer.renderMesh(this, meshData, combinedTransformation);
-		renderer.commitGL();
+		renderer->renderMesh(this, meshData, combinedTransformation);
+		renderer->commitGL();
 	}
 
 	void Mesh::bindTexture(Texture* texture) {
-		if (renderer.setGLWindowState(true)) {
+		renderer->runGL([texture]() {
 			//Generate texture mipmaps and bind or clear
 			if (texture != nullptr) {
 				(void)texture->generateMipmap();
@@ -45,8 +45,7 @@ namespace CGEngine {
 			else {
 				Texture::bind(nullptr);
 			}
-			renderer.setGLWindowState(false);
-		}
+		});
 	}
 
 	void Mesh::setPosition(Vector3f pos) {
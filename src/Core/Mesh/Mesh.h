@@ -31,6 +31,7 @@ namespace CGEngine {
 		MeshData* getMeshData();
 		void setMeshData(MeshData* model);
 		vector<id_t> getMaterials();
+		Transformation3D getTransformation() const { return transformation; }
 		id_t addMaterial(id_t materialId);
 		void clearMaterials();
 		string getMeshName() const;
@@ -7,7 +7,7 @@ namespace CGEngine {
 		init();
 		//Import the model using the MeshImporter
 		log(this, LogInfo, "Importing Model: {}", sourcePath);
-		ImportResult importResult = renderer.import(sourcePath, skeletonName);
+		ImportResult importResult = renderer->import(sourcePath, skeletonName);
 		if (!importResult.rootNode) {
 			log(this, LogError, "Failed to import model from '{}'", sourcePath);
 			return;
@@ -40,11 +40,11 @@ namespace CGEngine {
 		//If the model has bones, create a skeleton and animator
 		if (modelBones.size() > 0) {
 			//If skeletonName is empty or if that skeleton exists but doesn't have matching bones, use a name that will create a new skeleton
-			string newSkeletonName = (skeletonName.empty() || (!skeletonName.empty() && !assets.get<Skeleton>(skeletonName)->equals(modelBones))) ? name.append("_Skeleton") : skeletonName;
+			string newSkeletonName = (skeletonName.empty() || (!skeletonName.empty() && !assets->get<Skeleton>(skeletonName)->equals(modelBones))) ? name.append("_Skeleton") : skeletonName;
 			//Get the Skeleton with newSkeletonName, if it exists, or create a Skeleton from model bones
-			optional<id_t> skeletonId = assets.create<Skeleton>(newSkeletonName, modelBones);
+			optional<id_t> skeletonId = assets->create<Skeleton>(newSkeletonName, modelBones);
 			if (skeletonId.has_value()) {
-				modelSkeleton = assets.get<Skeleton>(skeletonId.value());
+				modelSkeleton = assets->get<Skeleton>(skeletonId.value());
 				//Create animator if skeletal
 				if (modelSkeleton && modelSkeleton->isValid()) {
 					modelAnimator = createAnimator();
@@ -120,13 +120,13 @@ namespace CGEngine {
 		// Ensure we have at least one material
 		if (materialsToUse.empty() && modelMaterials.empty()) {
 			log(this, LogWarn, "No materials to use during instantiation. Using fallback material.");
-			modelMaterials.push_back(renderer.getFallbackMaterial()->materialId); //TODO: Ensure renderer fallback uses AssetManager
+			modelMaterials.push_back(renderer->getFallbackMaterial()->materialId); //TODO: Ensure renderer fallback uses AssetManager
 		}
 
 		// Create null Mesh Body root
-		optional<id_t> rootId = assets.create<Body>(sourcePath.append(".Root"), new Mesh(nullptr));
+		optional<id_t> rootId = assets->create<Body>(sourcePath.append(".Root"), new Mesh(nullptr));
 		if (rootId.has_value()) {
-			Body* rootBody = assets.get<Body>(rootId.value());
+			Body* rootBody = assets->get<Body>(rootId.value());
 
 			//Apply root body as the first Model body
 			bodyCount = 1;
@@ -181,7 +181,7 @@ namespace CGEngine {
 		glm::decompose(node->localTransform, scale, rotation, translation, skew, perspective);
 		Transformation3D nodeTransform(
 			Vector3f(translation.x, translation.y, translation.z),
-			Vector3f(renderer.fromGlm(glm::degrees(glm::eulerAngles(rotation)))),
+			Vector3f(renderer->fromGlm(glm::degrees(glm::eulerAngles(rotation)))),
 			Vector3f(scale.x, scale.y, scale.z)
 		);
 
@@ -198,9 +198,9 @@ namespace CGEngine {
 		mesh->setModelId(getId());
 
 		// Create and attach child body
-		optional<id_t> bodyId = assets.create<Body>(sourcePath.append(node->nodeName), mesh);
+		optional<id_t> bodyId = assets->create<Body>(sourcePath.append(node->nodeName), mesh);
 		if (bodyId.has_value()) {
-			Body* body = assets.get<Body>(bodyId.value());
+			Body* body = assets->get<Body>(bodyId.value());
 			bodyCount++;
 			log(this, LogDebug, "  {}) {} (ID: {}) {}", bodyCount, node->nodeName, bodyId, node->meshData && !node->meshData->vertices.empty() ? " <Has Mesh>" : "");
 			//Attach child body to parent
@@ -233,7 +233,7 @@ namespace CGEngine {
 		vector<Material*> materials;
 		for (id_t materialId : modelMaterials) {
 			if (materialId > -1) {
-				Material* material = assets.get<Material>(materialId);
+				Material* material = assets->get<Material>(materialId);
 				if (material) {
 					materials.push_back(material);
 				}
@@ -0,0 +1,146 @@
+#include "Prefab.h"
+#include "../World/Renderer.h"
+#include "../Engine/Engine.h"
+
+namespace CGEngine {
+	Prefab::Prefab(Model* model, string name, vector<id_t> overrideMaterials) {
+		init();
+		if (!model || !model->getRootNode()) {
+			log(this, LogError, "Failed to create Prefab from invalid Model");
+			return;
+		}
+
+		prefabName = name.empty() ? model->getModelPath() : name;
+		modelId = model->getId();
+
+		//Use override materials if provided, otherwise fall back to the node material indices
+		vector<id_t> materials = overrideMaterials;
+		if (materials.empty() && model->getMaterials().empty()) {
+			log(this, LogWarn, "No materials to use for Prefab. Using fallback material.");
+			materials.push_back(renderer->getFallbackMaterial()->materialId);
+		}
+
+		flattenNode(model->getRootNode(), nullopt, materials);
+		log(this, LogInfo, "Created Prefab '{}' with Node Count: {}", prefabName, nodes.size());
+	}
+
+	void Prefab::flattenNode(ModelNode* node, optional<size_t> parentIndex, const vector<id_t>& materials) {
+		if (!node) return;
+
+		PrefabNode prefabNode;
+		prefabNode.nodeName = node->nodeName;
+		prefabNode.bodyNameSuffix = "." + node->nodeName;
+		prefabNode.meshData = node->meshData;
+		prefabNode.parentIndex = parentIndex;
+		prefabNode.transform = decomposeTransform(node->localTransform);
+		if (node->meshData) {
+			prefabNode.materials.push_back(materials.empty() ? node->materialIndex : materials[0]);
+		}
+		nodes.push_back(prefabNode);
+
+		//Children are appended after their parent so instantiation can always attach to an existing Body
+		size_t nodeIndex = nodes.size() - 1;
+		for (ModelNode* childNode : node->children) {
+			flattenNode(childNode, nodeIndex, materials);
+		}
+	}
+
+	Transformation3D Prefab::decomposeTransform(const glm::mat4& localTransform) const {
+		glm::vec3 translation, scale, skew;
+		glm::quat rotation;
+		glm::vec4 perspective;
+		glm::decompose(localTransform, scale, rotation, translation, skew, perspective);
+		return Transformation3D(
+			Vector3f(translation.x, translation.y, translation.z),
+			Vector3f(renderer->fromGlm(glm::degrees(glm::eulerAngles(rotation)))),
+			Vector3f(scale.x, scale.y, scale.z)
+		);
+	}
+
+	void Prefab::addScript(size_t nodeIndex, string domain, ScriptEvent scriptEvent) {
+		if (nodeIndex >= nodes.size()) {
+			log(this, LogError, "Failed to add Prefab script to invalid node index {}", nodeIndex);
+			return;
+		}
+		prefabScripts.push_back({ nodeIndex, domain, scriptEvent });
+	}
+
+	void Prefab::addUpdateScript(size_t nodeIndex, ScriptEvent scriptEvent) {
+		addScript(nodeIndex, onUpdateEvent, scriptEvent);
+	}
+
+	optional<size_t> Prefab::getNodeIndex(const string& nodeName) const {
+		for (size_t i = 0; i < nodes.size(); i++) {
+			if (nodes[i].nodeName == nodeName) {
+				return i;
+			}
+		}
+		return nullopt;
+	}
+
+	optional<id_t> Prefab::instantiate(Transformation3D rootTransform) {
+		vector<id_t> rootIds = instantiate(vector<Transformation3D>{ rootTransform });
+		if (rootIds.empty()) {
+			return nullopt;
+		}
+		return rootIds[0];
+	}
+
+	vector<id_t> Prefab::instantiate(size_t count, Transformation3D rootTransform) {
+		return instantiate(vector<Transformation3D>(count, rootTransform));
+	}
+
+	vector<id_t> Prefab::instantiate(const vector<Transformation3D>& rootTransforms) {
+		vector<id_t> rootIds;
+		if (nodes.empty() || rootTransforms.empty()) {
+			log(this, LogError, "Failed to instantiate Prefab '{}'", prefabName);
+			return rootIds;
+		}
+
+		Clock instantiateClock;
+		size_t bodiesPerInstance = nodes.size() + 1;
+		size_t bodyCount = rootTransforms.size() * bodiesPerInstance;
+
+		//Create every Body for every instance before registering them with the AssetManager in one batch
+		vector<pair<string, unique_ptr<IResource>>> bodies;
+		bodies.reserve(bodyCount);
+		vector<Body*> instanceBodies(bodiesPerInstance, nullptr);
+		for (const Transformation3D& rootTransform : rootTransforms) {
+			string instanceName = prefabName + "[" + to_string(instanceCount++) + "]";
+
+			//Null Mesh root Body holds the instance transform, matching Model::instantiate
+			Mesh* rootMesh = new Mesh(nullptr);
+			rootMesh->setPosition(rootTransform.position);
+			rootMesh->setRotation(rootTransform.rotation);
+			rootMesh->setScale(rootTransform.scale);
+			Body* rootBody = new Body(rootMesh);
+			instanceBodies[0] = rootBody;
+			bodies.emplace_back(instanceName + ".Root", unique_ptr<IResource>(rootBody));
+
+			for (size_t i = 0; i < nodes.size(); i++) {
+				const PrefabNode& node = nodes[i];
+				Mesh* mesh = new Mesh(node.meshData, node.transform, node.materials);
+				mesh->setModelId(modelId);
+
+				//Parent index is offset by one for the instance root Body
+				Body* parentBody = instanceBodies[node.parentIndex.has_value() ? node.parentIndex.value() + 1 : 0];
+				Body* body = new Body(mesh, parentBody);
+				instanceBodies[i + 1] = body;
+				bodies.emplace_back(instanceName + node.bodyNameSuffix, unique_ptr<IResource>(body));
+			}
+
+			for (const PrefabScript& prefabScript : prefabScripts) {
+				instanceBodies[prefabScript.nodeIndex + 1]->addScript(prefabScript.domain, new Script(prefabScript.scriptEvent));
+			}
+		}
+
+		vector<id_t> bodyIds = assets->addBatch<Body>(bodies);
+		rootIds.reserve(rootTransforms.size());
+		for (size_t i = 0; i < bodyIds.size(); i += bodiesPerInstance) {
+			rootIds.push_back(bodyIds[i]);
+		}
+
+		log(this, LogInfo, "Instantiated {} copies of Prefab '{}' ({} Bodies) in {}ms", rootIds.size(), prefabName, bodyIds.size(), instantiateClock.getElapsedTime().asMicroseconds() / 1000.f);
+		return rootIds;
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Model.h"
+#include "../Scripts/Script.h"
+
+using namespace std;
+
+namespace CGEngine {
+	// A Prefab is a flattened, pre-processed copy of a Model hierarchy used to spawn many
+	// instances of the same Model quickly. Node transforms are decomposed, materials resolved and
+	// Body name suffixes built once when the Prefab is created, so instantiating only has to
+	// prefix each name with the instance name, allocate the Bodies and Meshes, attach them to
+	// their parents and register them with the AssetManager in a single batch. Scripts added to
+	// the Prefab are copied onto every instance.
+
+	struct PrefabNode {
+		string nodeName;
+		string bodyNameSuffix;                // "." + nodeName, appended to the instance name
+		MeshData* meshData = nullptr;         // Null if node has no mesh
+		optional<size_t> parentIndex;         // Index of the parent node in the Prefab nodes. Nullopt for the root
+		Transformation3D transform;
+		vector<id_t> materials;
+	};
+
+	struct PrefabScript {
+		size_t nodeIndex = 0;
+		string domain;
+		ScriptEvent scriptEvent;
+	};
+
+	class Prefab : public EngineSystem, public IResource {
+	public:
+		//Constructor to create a Prefab by flattening a Model's node hierarchy
+		Prefab(Model* model, string name = "", vector<id_t> overrideMaterials = {});
+		//Instantiate a single copy of the Prefab and return the root Body id
+		optional<id_t> instantiate(Transformation3D rootTransform = Transformation3D());
+		//Instantiate count copies of the Prefab, each with rootTransform, and return the root Body ids
+		vector<id_t> instantiate(size_t count, Transformation3D rootTransform = Transformation3D());
+		//Instantiate one copy of the Prefab per root transform and return the root Body ids
+		vector<id_t> instantiate(const vector<Transformation3D>& rootTransforms);
+		//Add a script to the node at nodeIndex that will be added to that Body's domain on every instance
+		void addScript(size_t nodeIndex, string domain, ScriptEvent scriptEvent);
+		//Add an update script to the node at nodeIndex that will be added to every instance
+		void addUpdateScript(size_t nodeIndex, ScriptEvent scriptEvent);
+		//Return the index of the first node named nodeName, if any
+		optional<size_t> getNodeIndex(const string& nodeName) const;
+		//Return the flattened Prefab nodes. Parents always precede their children.
+		const vector<PrefabNode>& getNodes() const { return nodes; }
+		//Return the number of Bodies created per instance
+		size_t getNodeCount() const { return nodes.size(); }
+		//Return the number of instances created by this Prefab
+		size_t getInstanceCount() const { return instanceCount; }
+		optional<id_t> getModelId() const { return modelId; }
+		string getPrefabName() const { return prefabName; }
+		bool isValid() const override { return !nodes.empty(); }
+	private:
+		string prefabName;
+		optional<id_t> modelId;
+		vector<PrefabNode> nodes;
+		vector<PrefabScript> prefabScripts;
+		size_t instanceCount = 0;
+
+		//Recursively append the node and its children to the flattened nodes
+		void flattenNode(ModelNode* node, optional<size_t> parentIndex, const vector<id_t>& materials);
+		//Convert a ModelNode local transform to a Transformation3D
+		Transformation3D decomposeTransform(const glm::mat4& localTransform) const;
+	};
+}
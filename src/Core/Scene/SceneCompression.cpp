@@ -0,0 +1,126 @@
+#include "SceneCompression.h"
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <optional>
+#include <algorithm>
+
+namespace CGEngine {
+	namespace {
+		constexpr size_t minMatch = 4;
+		//The last match must start this many bytes before the end of the block and the last bytes are always literals
+		constexpr size_t matchStartMargin = 12;
+		constexpr size_t lastLiterals = 5;
+		constexpr size_t maxOffset = 65535;
+		constexpr int hashBits = 12;
+
+		uint32_t hashSequence(const uint8_t* position) {
+			uint32_t sequence;
+			memcpy(&sequence, position, sizeof(sequence));
+			return (sequence * 2654435761U) >> (32 - hashBits);
+		}
+
+		void writeLength(vector<char>& out, size_t length) {
+			while (length >= 255) {
+				out.push_back((char)255);
+				length -= 255;
+			}
+			out.push_back((char)length);
+		}
+
+		void writeSequence(vector<char>& out, const uint8_t* literals, size_t literalLength, optional<size_t> offset, size_t matchLength) {
+			uint8_t token = (uint8_t)(min(literalLength, (size_t)15) << 4);
+			if (offset.has_value()) {
+				token |= (uint8_t)min(matchLength - minMatch, (size_t)15);
+			}
+			out.push_back((char)token);
+			if (literalLength >= 15) {
+				writeLength(out, literalLength - 15);
+			}
+			out.insert(out.end(), literals, literals + literalLength);
+			if (offset.has_value()) {
+				out.push_back((char)(offset.value() & 0xFF));
+				out.push_back((char)((offset.value() >> 8) & 0xFF));
+				if (matchLength - minMatch >= 15) {
+					writeLength(out, matchLength - minMatch - 15);
+				}
+			}
+		}
+
+		bool readLength(const uint8_t* source, size_t sourceSize, size_t& position, size_t& length) {
+			uint8_t next = 255;
+			while (next == 255) {
+				if (position >= sourceSize) return false;
+				next = source[position++];
+				length += next;
+			}
+			return true;
+		}
+	}
+
+	vector<char> compressBlock(const char* source, size_t sourceSize) {
+		vector<char> out;
+		out.reserve(sourceSize / 2 + 16);
+		const uint8_t* src = reinterpret_cast<const uint8_t*>(source);
+		array<int64_t, 1 << hashBits> hashTable;
+		hashTable.fill(-1);
+
+		size_t anchor = 0;
+		size_t position = 0;
+		size_t matchLimit = sourceSize > matchStartMargin ? sourceSize - matchStartMargin : 0;
+		while (position < matchLimit) {
+			uint32_t hash = hashSequence(src + position);
+			int64_t candidate = hashTable[hash];
+			hashTable[hash] = (int64_t)position;
+			if (candidate >= 0 && position - (size_t)candidate <= maxOffset && memcmp(src + candidate, src + position, minMatch) == 0) {
+				//Greedily extend the match, leaving the last bytes as literals
+				size_t matchLength = minMatch;
+				size_t maxLength = sourceSize - lastLiterals - position;
+				while (matchLength < maxLength && src[candidate + matchLength] == src[position + matchLength]) {
+					matchLength++;
+				}
+				writeSequence(out, src + anchor, position - anchor, position - (size_t)candidate, matchLength);
+				position += matchLength;
+				anchor = position;
+			} else {
+				position++;
+			}
+		}
+		writeSequence(out, src + anchor, sourceSize - anchor, nullopt, 0);
+		return out;
+	}
+
+	bool decompressBlock(const char* source, size_t sourceSize, char* destination, size_t destinationSize) {
+		const uint8_t* src = reinterpret_cast<const uint8_t*>(source);
+		size_t inPosition = 0;
+		size_t outPosition = 0;
+		while (inPosition < sourceSize) {
+			uint8_t token = src[inPosition++];
+			size_t literalLength = token >> 4;
+			if (literalLength == 15 && !readLength(src, sourceSize, inPosition, literalLength)) return false;
+			if (inPosition + literalLength > sourceSize || outPosition + literalLength > destinationSize) return false;
+			memcpy(destination + outPosition, src + inPosition, literalLength);
+			inPosition += literalLength;
+			outPosition += literalLength;
+
+			//The last sequence has literals only
+			if (inPosition >= sourceSize) break;
+
+			if (inPosition + 2 > sourceSize) return false;
+			size_t offset = (size_t)src[inPosition] | ((size_t)src[inPosition + 1] << 8);
+			inPosition += 2;
+			if (offset == 0 || offset > outPosition) return false;
+
+			size_t matchLength = token & 0x0F;
+			if (matchLength == 15 && !readLength(src, sourceSize, inPosition, matchLength)) return false;
+			matchLength += minMatch;
+			if (outPosition + matchLength > destinationSize) return false;
+			//Copy byte by byte since the match may overlap the bytes being written
+			for (size_t i = 0; i < matchLength; i++) {
+				destination[outPosition + i] = destination[outPosition - offset + i];
+			}
+			outPosition += matchLength;
+		}
+		return outPosition == destinationSize;
+	}
+}
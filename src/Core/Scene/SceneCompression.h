@@ -0,0 +1,12 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+namespace CGEngine {
+	//Compress the source bytes into an LZ4-compatible block (no frame header or checksum)
+	vector<char> compressBlock(const char* source, size_t sourceSize);
+	//Decompress an LZ4-compatible block into destination, which must be exactly destinationSize bytes. Returns false on malformed input.
+	bool decompressBlock(const char* source, size_t sourceSize, char* destination, size_t destinationSize);
+}
@@ -0,0 +1,637 @@
+#include "SceneSnapshot.h"
+#include "SceneCompression.h"
+#include "../Engine/Engine.h"
+#include <fstream>
+
+namespace CGEngine {
+	namespace {
+		template<typename T>
+		void appendValue(vector<char>& out, const T& value) {
+			const char* bytes = reinterpret_cast<const char*>(&value);
+			out.insert(out.end(), bytes, bytes + sizeof(T));
+		}
+
+		template<typename T>
+		void appendArray(vector<char>& out, const vector<T>& values) {
+			const char* bytes = reinterpret_cast<const char*>(values.data());
+			out.insert(out.end(), bytes, bytes + values.size() * sizeof(T));
+		}
+
+		//Bounds-checked reader over a loaded snapshot payload
+		struct SnapshotReader {
+			const char* data;
+			size_t size;
+			size_t position = 0;
+
+			template<typename T>
+			bool read(T& value) {
+				if (position + sizeof(T) > size) return false;
+				memcpy(&value, data + position, sizeof(T));
+				position += sizeof(T);
+				return true;
+			}
+
+			template<typename T>
+			bool readArray(vector<T>& values, size_t count) {
+				if (position + count * sizeof(T) > size) return false;
+				values.resize(count);
+				memcpy(values.data(), data + position, count * sizeof(T));
+				position += count * sizeof(T);
+				return true;
+			}
+
+			bool readBytes(const char*& bytes, size_t count) {
+				if (position + count > size) return false;
+				bytes = data + position;
+				position += count;
+				return true;
+			}
+		};
+
+		SnapshotTransform toSnapshotTransform(const Transformable* transformable) {
+			SnapshotTransform transform;
+			transform.position[0] = transformable->getPosition().x;
+			transform.position[1] = transformable->getPosition().y;
+			transform.rotation = transformable->getRotation().asDegrees();
+			transform.scale[0] = transformable->getScale().x;
+			transform.scale[1] = transformable->getScale().y;
+			transform.origin[0] = transformable->getOrigin().x;
+			transform.origin[1] = transformable->getOrigin().y;
+			return transform;
+		}
+
+		void applySnapshotTransform(Transformable* transformable, const SnapshotTransform& transform) {
+			transformable->setPosition({ transform.position[0], transform.position[1] });
+			transformable->setRotation(degrees(transform.rotation));
+			transformable->setScale({ transform.scale[0], transform.scale[1] });
+			transformable->setOrigin({ transform.origin[0], transform.origin[1] });
+		}
+	}
+
+	SceneSnapshot::SceneSnapshot() {
+		init();
+		registerDefaultDataTypes();
+		clear();
+	}
+
+	void SceneSnapshot::clear() {
+		bodies.clear();
+		entities.clear();
+		materials.clear();
+		timers.clear();
+		behaviorData.clear();
+		strings.clear();
+		stringOffsets.clear();
+		//Offset 0 is always the empty string
+		addString("");
+	}
+
+	uint32_t SceneSnapshot::addString(const string& value) {
+		auto iterator = stringOffsets.find(value);
+		if (iterator != stringOffsets.end()) {
+			return iterator->second;
+		}
+		uint32_t offset = (uint32_t)strings.size();
+		strings.insert(strings.end(), value.begin(), value.end());
+		strings.push_back('\0');
+		stringOffsets[value] = offset;
+		return offset;
+	}
+
+	string SceneSnapshot::getString(uint32_t offset) const {
+		if (offset >= strings.size()) return "";
+		return string(strings.data() + offset);
+	}
+
+	void SceneSnapshot::capture(Body* root) {
+		Clock captureClock;
+		clear();
+		if (root == nullptr) {
+			root = world->getRoot();
+		}
+		sec_t now = time->getElapsedSec();
+		for (Body* child : root->children) {
+			captureBody(child, -1, now);
+		}
+		log(this, LogInfo, "Captured {} Bodies in {}ms", bodies.size(), captureClock.getElapsedTime().asMicroseconds() / 1000.f);
+	}
+
+	void SceneSnapshot::captureBody(Body* body, int32_t parentIndex, sec_t now) {
+		//Destroyed Bodies (and terminated children) are not part of the scene anymore
+		if (body == nullptr || body->destroyed) return;
+
+		SnapshotBody record;
+		record.parentIndex = parentIndex;
+		record.name = addString(body->bodyParams.name);
+		if (body->getId().has_value()) {
+			optional<string> assetName = assets->getName<Body>(body->getId().value());
+			if (assetName.has_value()) {
+				record.assetName = addString(assetName.value());
+				record.registered = 1;
+			}
+		}
+		record.transform = toSnapshotTransform(body);
+		record.zOrder = body->zOrder;
+		record.scriptUpdateInterval = body->scriptUpdateInterval;
+		record.rendering = body->bodyParams.rendering;
+		record.intersecting = body->bodyParams.intersecting;
+		record.boundsRendering = body->bodyParams.boundsRendering;
+		record.entityIndex = captureEntity(body->entity);
+
+		uint32_t bodyIndex = (uint32_t)bodies.size();
+		bodies.push_back(record);
+
+		captureBehaviors(body, bodyIndex);
+
+		//Only timers that call a registered timer event can be restored
+		body->timers.forEach([this, bodyIndex, now](Timer* timer) {
+			if (timer->eventName.empty()) return;
+			SnapshotTimer timerRecord;
+			timerRecord.bodyIndex = bodyIndex;
+			timerRecord.name = addString(timer->name);
+			timerRecord.eventName = addString(timer->eventName);
+			timerRecord.remaining = max(timer->expiration - now, 0.f);
+			timerRecord.loopDuration = timer->loopDuration;
+			timerRecord.loopCount = timer->loopCount;
+			timers.push_back(timerRecord);
+		});
+
+		for (Body* child : body->children) {
+			captureBody(child, (int32_t)bodyIndex, now);
+		}
+	}
+
+	int32_t SceneSnapshot::captureEntity(Transformable* entity) {
+		if (entity == nullptr) return -1;
+
+		SnapshotEntityRecord record;
+		record.transform = toSnapshotTransform(entity);
+		if (Mesh* mesh = dynamic_cast<Mesh*>(entity)) {
+			record.kind = SnapshotEntity::Mesh;
+			MeshData* meshData = mesh->getMeshData();
+			if (meshData && meshData->getId().has_value()) {
+				record.meshDataName = addString(assets->getName<MeshData>(meshData->getId().value()).value_or(""));
+			}
+			vector<id_t> meshMaterials = mesh->getMaterials();
+			record.materialsIndex = (uint32_t)materials.size();
+			record.materialCount = (uint32_t)meshMaterials.size();
+			for (id_t materialId : meshMaterials) {
+				materials.push_back(addString(assets->getName<Material>(materialId).value_or("")));
+			}
+			Transformation3D transformation = mesh->getTransformation();
+			float transform3D[9] = { transformation.position.x, transformation.position.y, transformation.position.z,
+				transformation.rotation.x, transformation.rotation.y, transformation.rotation.z,
+				transformation.scale.x, transformation.scale.y, transformation.scale.z };
+			memcpy(record.transform3D, transform3D, sizeof(transform3D));
+		} else if (Shape* shape = dynamic_cast<Shape*>(entity)) {
+			if (RectangleShape* rectangle = dynamic_cast<RectangleShape*>(shape)) {
+				record.kind = SnapshotEntity::Rectangle;
+				record.size[0] = rectangle->getSize().x;
+				record.size[1] = rectangle->getSize().y;
+			} else if (CircleShape* circle = dynamic_cast<CircleShape*>(shape)) {
+				record.kind = SnapshotEntity::Circle;
+				record.radius = circle->getRadius();
+				record.pointCount = (uint32_t)circle->getPointCount();
+			} else {
+				log(this, LogWarn, "Unsupported Shape type will be captured without an entity");
+				return -1;
+			}
+			record.fillColor = shape->getFillColor().toInteger();
+			record.outlineColor = shape->getOutlineColor().toInteger();
+			record.outlineThickness = shape->getOutlineThickness();
+			if (const Texture* texture = shape->getTexture()) {
+				record.textureName = addString(assets->findName<TextureResource>([texture](TextureResource* resource) { return resource->getTexture() == texture; }).value_or(""));
+				IntRect textureRect = shape->getTextureRect();
+				int32_t rect[4] = { textureRect.position.x, textureRect.position.y, textureRect.size.x, textureRect.size.y };
+				memcpy(record.textureRect, rect, sizeof(rect));
+			}
+		} else if (Text* text = dynamic_cast<Text*>(entity)) {
+			record.kind = SnapshotEntity::Text;
+			record.text = addString(text->getString().toAnsiString());
+			const Font* font = &text->getFont();
+			record.fontName = addString(assets->findName<FontResource>([font](FontResource* resource) { return resource->getFont() == font; }).value_or(""));
+			record.characterSize = text->getCharacterSize();
+			record.fillColor = text->getFillColor().toInteger();
+			record.outlineColor = text->getOutlineColor().toInteger();
+			record.outlineThickness = text->getOutlineThickness();
+		} else if (Sprite* sprite = dynamic_cast<Sprite*>(entity)) {
+			record.kind = SnapshotEntity::Sprite;
+			const Texture* texture = &sprite->getTexture();
+			record.textureName = addString(assets->findName<TextureResource>([texture](TextureResource* resource) { return resource->getTexture() == texture; }).value_or(""));
+			IntRect textureRect = sprite->getTextureRect();
+			int32_t rect[4] = { textureRect.position.x, textureRect.position.y, textureRect.size.x, textureRect.size.y };
+			memcpy(record.textureRect, rect, sizeof(rect));
+			record.fillColor = sprite->getColor().toInteger();
+		} else {
+			log(this, LogWarn, "Unsupported entity type will be captured without an entity");
+			return -1;
+		}
+
+		entities.push_back(record);
+		return (int32_t)entities.size() - 1;
+	}
+
+	void SceneSnapshot::captureBehaviors(Body* body, uint32_t bodyIndex) {
+		unordered_map<type_index, string>& behaviorTypes = getBehaviorTypes();
+		unordered_map<type_index, SnapshotDataType>& dataTypes = getDataTypes();
+		body->behaviors.forEach([&](Behavior* behavior) {
+			if (behavior == nullptr) return;
+			auto typeIterator = behaviorTypes.find(type_index(typeid(*behavior)));
+			if (typeIterator == behaviorTypes.end()) return;
+
+			appendValue(behaviorData, bodyIndex);
+			appendValue(behaviorData, addString(typeIterator->second));
+			//Input and process DataMaps only keep values of registered data types
+			for (const DataMap& dataMap : { behavior->getInput(), behavior->getProcess() }) {
+				vector<char> entries;
+				uint32_t entryCount = 0;
+				for (const DataEntry& entry : dataMap.getEntries()) {
+					auto dataIterator = dataTypes.find(type_index(entry.value.type()));
+					if (dataIterator == dataTypes.end()) continue;
+					vector<char> bytes;
+					dataIterator->second.write(entry.value.toAny(), bytes);
+					appendValue(entries, addString(entry.key.getName()));
+					appendValue(entries, addString(dataIterator->second.typeName));
+					appendValue(entries, (uint32_t)bytes.size());
+					entries.insert(entries.end(), bytes.begin(), bytes.end());
+					entryCount++;
+				}
+				appendValue(behaviorData, entryCount);
+				behaviorData.insert(behaviorData.end(), entries.begin(), entries.end());
+			}
+		});
+	}
+
+	bool SceneSnapshot::save(const filesystem::path& path, bool compress) {
+		Clock saveClock;
+		SnapshotCounts counts;
+		counts.bodies = (uint32_t)bodies.size();
+		counts.entities = (uint32_t)entities.size();
+		counts.materials = (uint32_t)materials.size();
+		counts.timers = (uint32_t)timers.size();
+		counts.behaviorBytes = (uint32_t)behaviorData.size();
+		counts.stringBytes = (uint32_t)strings.size();
+
+		vector<char> payload;
+		payload.reserve(sizeof(SnapshotCounts) + bodies.size() * sizeof(SnapshotBody) + entities.size() * sizeof(SnapshotEntityRecord) + materials.size() * sizeof(uint32_t) + timers.size() * sizeof(SnapshotTimer) + behaviorData.size() + strings.size());
+		appendValue(payload, counts);
+		appendArray(payload, bodies);
+		appendArray(payload, entities);
+		appendArray(payload, materials);
+		appendArray(payload, timers);
+		appendArray(payload, behaviorData);
+		appendArray(payload, strings);
+
+		SnapshotHeader header;
+		header.rawSize = (uint32_t)payload.size();
+		if (compress) {
+			vector<char> compressed = compressBlock(payload.data(), payload.size());
+			//Keep the raw payload if compression doesn't help
+			if (compressed.size() < payload.size()) {
+				header.flags |= snapshotCompressed;
+				payload = move(compressed);
+			}
+		}
+		header.storedSize = (uint32_t)payload.size();
+
+		ofstream file(path, ios::binary | ios::trunc);
+		if (!file) {
+			log(this, LogError, "Failed to open '{}' to save snapshot", path.string());
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(payload.data(), payload.size());
+		if (!file) {
+			log(this, LogError, "Failed to write snapshot to '{}'", path.string());
+			return false;
+		}
+		log(this, LogInfo, "Saved {} Bodies to '{}' ({} bytes, {} raw) in {}ms", bodies.size(), path.string(), header.storedSize, header.rawSize, saveClock.getElapsedTime().asMicroseconds() / 1000.f);
+		return true;
+	}
+
+	bool SceneSnapshot::load(const filesystem::path& path) {
+		Clock loadClock;
+		ifstream file(path, ios::binary | ios::ate);
+		if (!file) {
+			log(this, LogError, "Failed to open snapshot '{}'", path.string());
+			return false;
+		}
+		size_t fileSize = (size_t)file.tellg();
+		file.seekg(0);
+		vector<char> fileData(fileSize);
+		file.read(fileData.data(), fileSize);
+
+		SnapshotHeader header;
+		SnapshotReader headerReader{ fileData.data(), fileData.size() };
+		if (!headerReader.read(header) || memcmp(header.magic, SnapshotHeader().magic, sizeof(header.magic)) != 0) {
+			log(this, LogError, "'{}' is not a scene snapshot", path.string());
+			return false;
+		}
+		if (header.version != snapshotVersion) {
+			log(this, LogError, "Unsupported snapshot version {} in '{}'", header.version, path.string());
+			return false;
+		}
+		if (headerReader.position + header.storedSize > fileData.size()) {
+			log(this, LogError, "Snapshot '{}' is truncated", path.string());
+			return false;
+		}
+
+		const char* storedPayload = fileData.data() + headerReader.position;
+		vector<char> payload;
+		if (header.flags & snapshotCompressed) {
+			payload.resize(header.rawSize);
+			if (!decompressBlock(storedPayload, header.storedSize, payload.data(), payload.size())) {
+				log(this, LogError, "Failed to decompress snapshot '{}'", path.string());
+				return false;
+			}
+		} else {
+			payload.assign(storedPayload, storedPayload + header.storedSize);
+		}
+
+		//Every section is a contiguous array that is copied directly into its record vector
+		clear();
+		strings.clear();
+		SnapshotCounts counts;
+		SnapshotReader reader{ payload.data(), payload.size() };
+		bool valid = reader.read(counts)
+			&& reader.readArray(bodies, counts.bodies)
+			&& reader.readArray(entities, counts.entities)
+			&& reader.readArray(materials, counts.materials)
+			&& reader.readArray(timers, counts.timers)
+			&& reader.readArray(behaviorData, counts.behaviorBytes)
+			&& reader.readArray(strings, counts.stringBytes);
+		if (!valid || strings.empty() || strings.back() != '\0') {
+			log(this, LogError, "Snapshot '{}' is corrupt", path.string());
+			clear();
+			return false;
+		}
+		log(this, LogInfo, "Loaded snapshot '{}' with {} Bodies in {}ms", path.string(), bodies.size(), loadClock.getElapsedTime().asMicroseconds() / 1000.f);
+		return true;
+	}
+
+	vector<Body*> SceneSnapshot::instantiate(Body* parent) {
+		Clock instantiateClock;
+		vector<Body*> created;
+		instantiateBodies(0, bodies.size(), parent, created);
+		finishInstantiate(created);
+		log(this, LogInfo, "Instantiated {} Bodies from snapshot in {}ms", created.size(), instantiateClock.getElapsedTime().asMicroseconds() / 1000.f);
+		return getTopLevelBodies(created);
+	}
+
+	void SceneSnapshot::instantiateBodies(size_t first, size_t last, Body* parent, vector<Body*>& created) {
+		created.resize(bodies.size(), nullptr);
+		last = min(last, bodies.size());
+		for (size_t i = first; i < last; i++) {
+			const SnapshotBody& record = bodies[i];
+			//Parents are always captured before their children
+			Body* parentBody = parent;
+			if (record.parentIndex >= 0 && (size_t)record.parentIndex < i) {
+				parentBody = created[record.parentIndex];
+			}
+			Transformable* entity = nullptr;
+			if (record.entityIndex >= 0 && (size_t)record.entityIndex < entities.size()) {
+				entity = createEntity(entities[record.entityIndex]);
+			}
+
+			Body* body = new Body(entity, parentBody);
+			applySnapshotTransform(body, record.transform);
+			body->setName(getString(record.name));
+			body->zOrder = record.zOrder;
+			body->scriptUpdateInterval = record.scriptUpdateInterval;
+			body->setRenderingEnabled(record.rendering);
+			body->setIntersectEnabled(record.intersecting);
+			body->setBoundsRenderingEnabled(record.boundsRendering);
+			created[i] = body;
+		}
+	}
+
+	void SceneSnapshot::finishInstantiate(const vector<Body*>& created) {
+		//Register the Bodies that were registered when captured in a single batch
+		vector<pair<string, unique_ptr<IResource>>> registered;
+		registered.reserve(created.size());
+		for (size_t i = 0; i < created.size() && i < bodies.size(); i++) {
+			if (bodies[i].registered && created[i] != nullptr) {
+				registered.emplace_back(getString(bodies[i].assetName), unique_ptr<IResource>(created[i]));
+			}
+		}
+		assets->addBatch<Body>(registered);
+
+		restoreBehaviors(created);
+
+		unordered_map<string, ScriptEvent>& timerEvents = getTimerEvents();
+		for (const SnapshotTimer& timerRecord : timers) {
+			if (timerRecord.bodyIndex >= created.size() || created[timerRecord.bodyIndex] == nullptr) continue;
+			string eventName = getString(timerRecord.eventName);
+			if (timerEvents.find(eventName) == timerEvents.end()) {
+				log(this, LogWarn, "Timer event '{}' is not registered", eventName);
+				continue;
+			}
+			//Timers that were due when captured fire on the next update
+			setTimer(created[timerRecord.bodyIndex], max(timerRecord.remaining, 0.0001f), eventName, timerRecord.loopCount, getString(timerRecord.name), timerRecord.loopDuration);
+		}
+	}
+
+	vector<Body*> SceneSnapshot::getTopLevelBodies(const vector<Body*>& created) const {
+		vector<Body*> topLevel;
+		for (size_t i = 0; i < created.size() && i < bodies.size(); i++) {
+			if (bodies[i].parentIndex < 0 && created[i] != nullptr) {
+				topLevel.push_back(created[i]);
+			}
+		}
+		return topLevel;
+	}
+
+	Transformable* SceneSnapshot::createEntity(const SnapshotEntityRecord& record) {
+		Transformable* entity = nullptr;
+		switch (record.kind) {
+		case SnapshotEntity::Rectangle:
+		case SnapshotEntity::Circle: {
+			Shape* shape = nullptr;
+			if (record.kind == SnapshotEntity::Rectangle) {
+				shape = new RectangleShape({ record.size[0], record.size[1] });
+			} else {
+				shape = new CircleShape(record.radius, record.pointCount);
+			}
+			shape->setFillColor(Color(record.fillColor));
+			shape->setOutlineColor(Color(record.outlineColor));
+			shape->setOutlineThickness(record.outlineThickness);
+			if (record.textureName != 0) {
+				if (TextureResource* texture = assets->get<TextureResource>(getString(record.textureName))) {
+					shape->setTexture(texture->getTexture());
+					shape->setTextureRect(IntRect({ record.textureRect[0], record.textureRect[1] }, { record.textureRect[2], record.textureRect[3] }));
+				}
+			}
+			entity = shape;
+			break;
+		}
+		case SnapshotEntity::Text: {
+			FontResource* font = assets->get<FontResource>(getString(record.fontName));
+			if (font == nullptr) {
+				font = assets->get<FontResource>(assets->defaultFontName);
+			}
+			if (font == nullptr) return nullptr;
+			Text* text = new Text(*font->getFont(), getString(record.text), record.characterSize);
+			text->setFillColor(Color(record.fillColor));
+			text->setOutlineColor(Color(record.outlineColor));
+			text->setOutlineThickness(record.outlineThickness);
+			entity = text;
+			break;
+		}
+		case SnapshotEntity::Sprite: {
+			TextureResource* texture = assets->get<TextureResource>(getString(record.textureName));
+			if (texture == nullptr) {
+				texture = assets->get<TextureResource>(assets->defaultTextureName);
+			}
+			if (texture == nullptr) return nullptr;
+			Sprite* sprite = new Sprite(*texture->getTexture(), IntRect({ record.textureRect[0], record.textureRect[1] }, { record.textureRect[2], record.textureRect[3] }));
+			sprite->setColor(Color(record.fillColor));
+			entity = sprite;
+			break;
+		}
+		case SnapshotEntity::Mesh: {
+			MeshData* meshData = record.meshDataName != 0 ? assets->get<MeshData>(getString(record.meshDataName)) : nullptr;
+			vector<id_t> meshMaterials;
+			for (uint32_t i = 0; i < record.materialCount && record.materialsIndex + i < materials.size(); i++) {
+				optional<id_t> materialId = assets->getId<Material>(getString(materials[record.materialsIndex + i]));
+				meshMaterials.push_back(materialId.value_or(0));
+			}
+			const float* t = record.transform3D;
+			Transformation3D transformation(Vector3f(t[0], t[1], t[2]), Vector3f(t[3], t[4], t[5]), Vector3f(t[6], t[7], t[8]));
+			entity = new Mesh(meshData, transformation, meshMaterials.empty() ? vector<id_t>{ 0 } : meshMaterials);
+			break;
+		}
+		default:
+			return nullptr;
+		}
+		applySnapshotTransform(entity, record.transform);
+		return entity;
+	}
+
+	void SceneSnapshot::restoreBehaviors(const vector<Body*>& created) {
+		unordered_map<string, function<Behavior*(Body*)>>& factories = getBehaviorFactories();
+		unordered_map<string, type_index>& dataTypeNames = getDataTypeNames();
+		unordered_map<type_index, SnapshotDataType>& dataTypes = getDataTypes();
+
+		SnapshotReader reader{ behaviorData.data(), behaviorData.size() };
+		while (reader.position < reader.size) {
+			uint32_t bodyIndex = 0;
+			uint32_t typeName = 0;
+			if (!reader.read(bodyIndex) || !reader.read(typeName)) break;
+
+			DataMap dataMaps[2];
+			bool valid = true;
+			for (DataMap& dataMap : dataMaps) {
+				uint32_t entryCount = 0;
+				valid = valid && reader.read(entryCount);
+				for (uint32_t i = 0; valid && i < entryCount; i++) {
+					uint32_t key = 0;
+					uint32_t dataTypeName = 0;
+					uint32_t byteCount = 0;
+					const char* bytes = nullptr;
+					valid = reader.read(key) && reader.read(dataTypeName) && reader.read(byteCount) && reader.readBytes(bytes, byteCount);
+					if (!valid) break;
+					auto nameIterator = dataTypeNames.find(getString(dataTypeName));
+					if (nameIterator == dataTypeNames.end()) continue;
+					any value = dataTypes[nameIterator->second].read(bytes, byteCount);
+					if (value.has_value()) {
+						dataMap.setData(getString(key), value);
+					}
+				}
+			}
+			if (!valid) {
+				log(this, LogError, "Snapshot Behavior data is corrupt");
+				break;
+			}
+
+			auto factoryIterator = factories.find(getString(typeName));
+			if (factoryIterator == factories.end() || bodyIndex >= created.size() || created[bodyIndex] == nullptr) {
+				log(this, LogWarn, "Behavior type '{}' is not registered", getString(typeName));
+				continue;
+			}
+			Behavior* behavior = factoryIterator->second(created[bodyIndex]);
+			if (behavior != nullptr) {
+				behavior->setInput(dataMaps[0]);
+				behavior->setProcess(dataMaps[1]);
+			}
+		}
+	}
+
+	timerId_t SceneSnapshot::setTimer(Body* body, sec_t duration, const string& eventName, int loopCount, string timerDisplayName, sec_t loopDuration) {
+		if (body == nullptr) return nullopt;
+		unordered_map<string, ScriptEvent>& timerEvents = getTimerEvents();
+		auto iterator = timerEvents.find(eventName);
+		if (iterator == timerEvents.end()) {
+			log(LogError, "SceneSnapshot", "Timer event '{}' is not registered", eventName);
+			return nullopt;
+		}
+		timerId_t timerId = body->timers.setTimer(body, duration, new Script(iterator->second), loopCount, timerDisplayName, loopDuration);
+		if (timerId.has_value()) {
+			body->timers.getTimer(timerId.value())->eventName = eventName;
+		}
+		return timerId;
+	}
+
+	void SceneSnapshot::registerBehavior(type_index typeId, const string& typeName, function<Behavior*(Body*)> factory) {
+		getBehaviorTypes()[typeId] = typeName;
+		getBehaviorFactories()[typeName] = factory;
+	}
+
+	void SceneSnapshot::registerDataType(type_index typeId, const string& typeName, function<void(const any&, vector<char>&)> write, function<any(const char*, size_t)> read) {
+		getDataTypes()[typeId] = SnapshotDataType{ typeName, write, read };
+		getDataTypeNames().insert_or_assign(typeName, typeId);
+	}
+
+	void SceneSnapshot::registerTimerEvent(const string& eventName, ScriptEvent timerEvent) {
+		getTimerEvents()[eventName] = timerEvent;
+	}
+
+	void SceneSnapshot::registerDefaultDataTypes() {
+		static bool registered = false;
+		if (registered) return;
+		registered = true;
+		registerDataType<bool>("bool");
+		registerDataType<int>("int");
+		registerDataType<unsigned int>("uint");
+		registerDataType<size_t>("size_t");
+		registerDataType<float>("float");
+		registerDataType<double>("double");
+		registerDataType<Vector2f>("Vector2f");
+		registerDataType<Vector2i>("Vector2i");
+		registerDataType<Vector3f>("Vector3f");
+		registerDataType<V2f>("V2f");
+		registerDataType<Color>("Color");
+		registerDataType(type_index(typeid(string)), "string",
+			[](const any& value, vector<char>& out) {
+				const string& typed = any_cast<const string&>(value);
+				out.insert(out.end(), typed.begin(), typed.end());
+			},
+			[](const char* bytes, size_t size) -> any {
+				return string(bytes, size);
+			});
+	}
+
+	unordered_map<type_index, string>& SceneSnapshot::getBehaviorTypes() {
+		static unordered_map<type_index, string> behaviorTypes;
+		return behaviorTypes;
+	}
+
+	unordered_map<string, function<Behavior*(Body*)>>& SceneSnapshot::getBehaviorFactories() {
+		static unordered_map<string, function<Behavior*(Body*)>> behaviorFactories;
+		return behaviorFactories;
+	}
+
+	unordered_map<type_index, SnapshotDataType>& SceneSnapshot::getDataTypes() {
+		static unordered_map<type_index, SnapshotDataType> dataTypes;
+		return dataTypes;
+	}
+
+	unordered_map<string, type_index>& SceneSnapshot::getDataTypeNames() {
+		static unordered_map<string, type_index> dataTypeNames;
+		return dataTypeNames;
+	}
+
+	unordered_map<string, ScriptEvent>& SceneSnapshot::getTimerEvents() {
+		static unordered_map<string, ScriptEvent> timerEvents;
+		return timerEvents;
+	}
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <any>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <typeindex>
+#include <type_traits>
+#include <unordered_map>
+#include "../Behavior/Behavior.h"
+#include "../Timers/TimerMap.h"
+#include "../Engine/EngineSystem.h"
+
+using namespace std;
+
+namespace CGEngine {
+	// A SceneSnapshot is a versioned binary copy of a Body hierarchy that can be saved to disk and loaded
+	// back without running any scene construction scripts. Bodies, entities and timers are stored as arrays of
+	// fixed-size records that are copied straight into memory on load, with every string (names, asset references,
+	// text) kept in a single string table and referenced by offset. Behaviors and timers are restored through
+	// registries: a Behavior is only captured if its type was registered with registerBehavior, its input and process
+	// DataMaps only keep values of types registered with registerDataType, and a timer is only captured if it was
+	// set with a registered timer event through SceneSnapshot::setTimer. The payload may be LZ4-style compressed.
+
+	constexpr uint32_t snapshotVersion = 1;
+	constexpr uint32_t snapshotCompressed = 1;
+
+	enum class SnapshotEntity : uint32_t { None, Rectangle, Circle, Text, Sprite, Mesh };
+
+	struct SnapshotHeader {
+		char magic[4] = { 'C','G','S','N' };
+		uint32_t version = snapshotVersion;
+		uint32_t flags = 0;
+		uint32_t rawSize = 0;
+		uint32_t storedSize = 0;
+	};
+
+	struct SnapshotCounts {
+		uint32_t bodies = 0;
+		uint32_t entities = 0;
+		uint32_t materials = 0;
+		uint32_t timers = 0;
+		uint32_t behaviorBytes = 0;
+		uint32_t stringBytes = 0;
+	};
+
+	struct SnapshotTransform {
+		float position[2] = { 0,0 };
+		float rotation = 0;
+		float scale[2] = { 1,1 };
+		float origin[2] = { 0,0 };
+	};
+
+	struct SnapshotBody {
+		int32_t parentIndex = -1;              // Index of the parent record. -1 for Bodies attached to the instantiation parent
+		uint32_t name = 0;                     // String table offset of the Body display name
+		uint32_t assetName = 0;                // String table offset of the AssetManager name
+		SnapshotTransform transform;
+		int32_t zOrder = 0;
+		float scriptUpdateInterval = -1;
+		uint8_t rendering = 1;
+		uint8_t intersecting = 0;
+		uint8_t boundsRendering = 0;
+		uint8_t registered = 0;                // Whether the Body was registered with the AssetManager
+		int32_t entityIndex = -1;              // Index of the entity record. -1 if the Body has no entity
+	};
+
+	struct SnapshotEntityRecord {
+		SnapshotEntity kind = SnapshotEntity::None;
+		SnapshotTransform transform;
+		float size[2] = { 0,0 };
+		float radius = 0;
+		uint32_t pointCount = 0;
+		uint32_t fillColor = 0xFFFFFFFF;
+		uint32_t outlineColor = 0xFFFFFFFF;
+		float outlineThickness = 0;
+		uint32_t textureName = 0;              // String table offset of the TextureResource name
+		int32_t textureRect[4] = { 0,0,0,0 };
+		uint32_t text = 0;                     // String table offset of the Text string
+		uint32_t fontName = 0;                 // String table offset of the FontResource name
+		uint32_t characterSize = 0;
+		uint32_t meshDataName = 0;             // String table offset of the MeshData name
+		uint32_t materialsIndex = 0;           // Index of the first material name in the material array
+		uint32_t materialCount = 0;
+		float transform3D[9] = { 0,0,0,0,0,0,1,1,1 };
+	};
+
+	struct SnapshotTimer {
+		uint32_t bodyIndex = 0;
+		uint32_t name = 0;                     // String table offset of the timer display name
+		uint32_t eventName = 0;                // String table offset of the registered timer event name
+		float remaining = 0;
+		float loopDuration = 0;
+		int32_t loopCount = 0;
+	};
+
+	static_assert(is_trivially_copyable_v<SnapshotBody> && is_trivially_copyable_v<SnapshotEntityRecord> && is_trivially_copyable_v<SnapshotTimer>, "Snapshot records must be trivially copyable");
+
+	struct SnapshotDataType {
+		string typeName;
+		function<void(const any&, vector<char>&)> write;
+		function<any(const char*, size_t)> read;
+	};
+
+	class SceneSnapshot : public EngineSystem {
+	public:
+		SceneSnapshot();
+		//Capture the descendants of root (but not root itself). The world root is used if root is null.
+		void capture(Body* root = nullptr);
+		//Save the captured snapshot to path, optionally compressing the payload
+		bool save(const filesystem::path& path, bool compress = true);
+		//Load a snapshot from path, replacing any captured data
+		bool load(const filesystem::path& path);
+		//Create the snapshot Bodies, Behaviors and timers under parent (or the world root) and return the top level Bodies
+		vector<Body*> instantiate(Body* parent = nullptr);
+		//Create the Bodies of records [first, last) into created, which is indexed by record. Used to spread instantiation across frames.
+		void instantiateBodies(size_t first, size_t last, Body* parent, vector<Body*>& created);
+		//Register the created Bodies with the AssetManager and restore their Behaviors and timers
+		void finishInstantiate(const vector<Body*>& created);
+		//Return the created Bodies that have no parent record
+		vector<Body*> getTopLevelBodies(const vector<Body*>& created) const;
+		//Clear the captured data
+		void clear();
+		//Return the number of captured Bodies
+		size_t getBodyCount() const { return bodies.size(); }
+
+		//Register a Behavior type so it's captured and restored by snapshots. The factory must attach the Behavior to the Body.
+		template<typename T>
+		static void registerBehavior(const string& typeName, function<Behavior*(Body*)> factory = [](Body* body) { return new T(body); }) {
+			registerBehavior(type_index(typeid(T)), typeName, factory);
+		}
+		static void registerBehavior(type_index typeId, const string& typeName, function<Behavior*(Body*)> factory);
+		//Register a trivially copyable DataMap value type so it's captured by snapshots
+		template<typename T>
+		static void registerDataType(const string& typeName) {
+			static_assert(is_trivially_copyable_v<T>, "Use the overload with write and read functions for types that aren't trivially copyable");
+			registerDataType(type_index(typeid(T)), typeName,
+				[](const any& value, vector<char>& out) {
+					const T& typed = any_cast<const T&>(value);
+					const char* bytes = reinterpret_cast<const char*>(&typed);
+					out.insert(out.end(), bytes, bytes + sizeof(T));
+				},
+				[](const char* bytes, size_t size) -> any {
+					if (size != sizeof(T)) return any();
+					T typed;
+					memcpy(&typed, bytes, sizeof(T));
+					return typed;
+				});
+		}
+		static void registerDataType(type_index typeId, const string& typeName, function<void(const any&, vector<char>&)> write, function<any(const char*, size_t)> read);
+		//Register a ScriptEvent that can be called by timers restored from a snapshot
+		static void registerTimerEvent(const string& eventName, ScriptEvent timerEvent);
+		//Set a timer on the Body that calls the registered timer event and can be captured by snapshots
+		static timerId_t setTimer(Body* body, sec_t duration, const string& eventName, int loopCount = 0, string timerDisplayName = "", sec_t loopDuration = 0);
+	private:
+		vector<SnapshotBody> bodies;
+		vector<SnapshotEntityRecord> entities;
+		vector<uint32_t> materials;
+		vector<SnapshotTimer> timers;
+		vector<char> behaviorData;
+		vector<char> strings;
+		unordered_map<string, uint32_t> stringOffsets;
+
+		//Recursively capture the Body and its children
+		void captureBody(Body* body, int32_t parentIndex, sec_t now);
+		//Capture the Body's entity and return its record index, or -1 if the Body has no entity
+		int32_t captureEntity(Transformable* entity);
+		//Capture the registered Behaviors of the Body
+		void captureBehaviors(Body* body, uint32_t bodyIndex);
+		//Create a Transformable entity from a captured record
+		Transformable* createEntity(const SnapshotEntityRecord& record);
+		//Restore the captured Behaviors onto the created Bodies
+		void restoreBehaviors(const vector<Body*>& created);
+
+		//Add a string to the string table and return its offset
+		uint32_t addString(const string& value);
+		//Return the string at the string table offset
+		string getString(uint32_t offset) const;
+
+		static unordered_map<type_index, string>& getBehaviorTypes();
+		static unordered_map<string, function<Behavior*(Body*)>>& getBehaviorFactories();
+		static unordered_map<type_index, SnapshotDataType>& getDataTypes();
+		static unordered_map<string, type_index>& getDataTypeNames();
+		static unordered_map<string, ScriptEvent>& getTimerEvents();
+		static void registerDefaultDataTypes();
+	};
+}
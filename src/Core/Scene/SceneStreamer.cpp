@@ -0,0 +1,201 @@
+#include "SceneStreamer.h"
+#include "../Engine/Engine.h"
+#include "../Engine/EngineContext.h"
+
+namespace CGEngine {
+	SceneStreamer::SceneStreamer() {
+		init();
+	}
+
+	SceneStreamer::~SceneStreamer() {
+		//Wait for any snapshot or asset still loading on a worker thread
+		scenes.clear();
+	}
+
+	void SceneStreamer::beginScene(string sceneName) {
+		if (!scenes.empty()) {
+			log(this, LogInfo, "Scene '{}' is still streaming. Queueing '{}' after it.", scenes.back().name, sceneName);
+		}
+		if (stagingRoot == nullptr) {
+			stagingRoot = new Body("SceneStaging");
+		}
+		scenes.push_back({ sceneName, {}, false });
+		if (!transitioning) {
+			transitioning = true;
+			transitionFrames = 0;
+			worstFrameMs = 0;
+		}
+		log(this, LogInfo, "Streaming scene '{}'", sceneName);
+	}
+
+	void SceneStreamer::addSnapshot(const filesystem::path& snapshotPath) {
+		//The snapshot file is read and decompressed on a worker thread while the current scene runs
+		shared_ptr<SceneSnapshot> snapshot = make_shared<SceneSnapshot>();
+		shared_ptr<future<bool>> loaded = make_shared<future<bool>>(async(launch::async, [snapshot, snapshotPath, context = &EngineContext::current()]() {
+			//The snapshot is decoded with the names of the context that queued it, so it fails if that context is being destroyed
+			if (!context->makeCurrent()) return false;
+			return snapshot->load(snapshotPath);
+		}));
+		shared_ptr<vector<Body*>> created = make_shared<vector<Body*>>();
+		shared_ptr<size_t> next = make_shared<size_t>(0);
+
+		addTask([this, snapshot, loaded, created, next, snapshotPath](const Clock& frameClock) {
+			if (loaded->valid()) {
+				if (loaded->wait_for(chrono::seconds(0)) != future_status::ready) {
+					return StreamResult::Waiting;
+				}
+				if (!loaded->get()) {
+					log(this, LogError, "Failed to stream snapshot '{}'", snapshotPath.string());
+					return StreamResult::Done;
+				}
+			}
+
+			//Create the snapshot Bodies in small batches until the frame budget is spent
+			size_t bodyCount = snapshot->getBodyCount();
+			while (*next < bodyCount && !budgetSpent(frameClock)) {
+				size_t uninitializedStart = world->uninitialized.size();
+				size_t last = min(*next + instantiateBatchSize, bodyCount);
+				snapshot->instantiateBodies(*next, last, stagingRoot, *created);
+				holdUninitialized(uninitializedStart);
+				*next = last;
+			}
+			if (*next < bodyCount) {
+				return StreamResult::Working;
+			}
+
+			//Behaviors, timers and asset registration are restored when the scene is activated
+			activationCallbacks.push_back([snapshot, created]() { snapshot->finishInstantiate(*created); });
+			return StreamResult::Done;
+		});
+	}
+
+	void SceneStreamer::addStep(function<void(Body* stagingRoot)> step) {
+		addTask([this, step](const Clock&) {
+			size_t uninitializedStart = world->uninitialized.size();
+			step(stagingRoot);
+			holdUninitialized(uninitializedStart);
+			return StreamResult::Done;
+		});
+	}
+
+	void SceneStreamer::addTask(function<StreamResult(const Clock&)> run) {
+		if (scenes.empty()) {
+			log(this, LogError, "Scene work added without beginScene. The work was discarded.");
+			return;
+		}
+		scenes.back().tasks.push_back({ run });
+	}
+
+	void SceneStreamer::endScene() {
+		if (scenes.empty()) return;
+		scenes.back().ended = true;
+	}
+
+	bool SceneStreamer::isStreaming() const {
+		return !scenes.empty() || !unloadQueue.empty();
+	}
+
+	void SceneStreamer::setFrameBudget(float budgetMs) {
+		frameBudgetMs = max(budgetMs, 0.f);
+	}
+
+	void SceneStreamer::setUnloadBodiesPerFrame(size_t bodyCount) {
+		unloadBodiesPerFrame = max(bodyCount, (size_t)1);
+	}
+
+	bool SceneStreamer::budgetSpent(const Clock& frameClock) const {
+		return frameClock.getElapsedTime().asMicroseconds() / 1000.f >= frameBudgetMs;
+	}
+
+	void SceneStreamer::update() {
+		if (!transitioning) return;
+
+		//The delta of this frame is the duration of the last frame, which may have included streaming work
+		transitionFrames++;
+		worstFrameMs = max(worstFrameMs, time->getDeltaSec() * 1000.f);
+
+		Clock frameClock;
+		if (!scenes.empty()) {
+			runTasks(frameClock);
+			if (scenes.front().tasks.empty() && scenes.front().ended) {
+				activate();
+			}
+		} else if (!unloadQueue.empty()) {
+			unload(frameClock);
+		}
+
+		if (scenes.empty() && unloadQueue.empty()) {
+			transitioning = false;
+			log(this, LogInfo, "Scene '{}' transition finished in {} frames. Worst frame: {}ms", activeSceneName, transitionFrames, worstFrameMs);
+		}
+	}
+
+	void SceneStreamer::runTasks(const Clock& frameClock) {
+		deque<StreamTask>& tasks = scenes.front().tasks;
+		while (!tasks.empty() && !budgetSpent(frameClock)) {
+			StreamResult result = tasks.front().run(frameClock);
+			if (result == StreamResult::Done) {
+				tasks.pop_front();
+			} else {
+				break;
+			}
+		}
+	}
+
+	void SceneStreamer::activate() {
+		//Move the previous scene out of the World in the same frame the new scene is moved in
+		if (unloadingRoot == nullptr) {
+			unloadingRoot = new Body("SceneUnloading");
+		}
+		for (Body* body : activeBodies) {
+			if (body->isDestroyed()) continue;
+			body->drop();
+			unloadingRoot->attachBody(body);
+			unloadQueue.push_back(body);
+		}
+
+		activeBodies = stagingRoot->children;
+		for (Body* body : activeBodies) {
+			body->drop();
+			world->getRoot()->attachBody(body);
+		}
+		for (function<void()>& callback : activationCallbacks) {
+			callback();
+		}
+		activationCallbacks.clear();
+
+		//Staged Bodies are started with the other new Bodies at the start of the frame
+		world->uninitialized.insert(world->uninitialized.end(), stagedUninitialized.begin(), stagedUninitialized.end());
+		stagedUninitialized.clear();
+
+		activeSceneName = scenes.front().name;
+		scenes.pop_front();
+		log(this, LogInfo, "Activated scene '{}' with {} top level Bodies", activeSceneName, activeBodies.size());
+	}
+
+	void SceneStreamer::unload(const Clock& frameClock) {
+		//Destroyed Bodies are deleted in the World's batched end of frame pass
+		size_t destroyedCount = 0;
+		while (!unloadQueue.empty() && destroyedCount < unloadBodiesPerFrame && !budgetSpent(frameClock)) {
+			Body* body = unloadQueue.front();
+			//Queue the remaining children ahead of the Body, so each Body is destroyed on its own and the limit bounds the work
+			bool childrenQueued = false;
+			for (auto child = body->children.rbegin(); child != body->children.rend(); ++child) {
+				if ((*child)->isDestroyed()) continue;
+				unloadQueue.push_front(*child);
+				childrenQueued = true;
+			}
+			if (childrenQueued) continue;
+			unloadQueue.pop_front();
+			body->destroy(ChildrenTermination::Terminate);
+			destroyedCount++;
+		}
+	}
+
+	void SceneStreamer::holdUninitialized(size_t uninitializedStart) {
+		vector<Body*>& uninitialized = world->uninitialized;
+		if (uninitializedStart >= uninitialized.size()) return;
+		stagedUninitialized.insert(stagedUninitialized.end(), uninitialized.begin() + uninitializedStart, uninitialized.end());
+		uninitialized.erase(uninitialized.begin() + uninitializedStart, uninitialized.end());
+	}
+}
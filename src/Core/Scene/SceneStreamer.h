@@ -0,0 +1,110 @@
+#pragma once
+
+#include <deque>
+#include <future>
+#include <memory>
+#include "SceneSnapshot.h"
+#include "../Engine/Engine.h"
+
+using namespace std;
+
+namespace CGEngine {
+	// The SceneStreamer builds the next scene over several frames while the current scene keeps running. Work for the
+	// next scene (snapshot loads, asset requests and build steps) is queued between beginScene and endScene. Snapshot
+	// files are read and decoded on a worker thread, and everything that touches the World runs on the main thread
+	// under a per-frame millisecond budget. New Bodies are built under a hidden staging root that is neither updated
+	// nor rendered. Once all of the queued work is done, the new scene replaces the previous streamed scene in a single
+	// frame, and the previous scene is destroyed a few Bodies at a time over the following frames. A scene begun while
+	// another is streaming is queued and streamed once the other has been activated.
+
+	enum class StreamResult { Done, Working, Waiting };
+
+	class SceneStreamer : public EngineSystem {
+	public:
+		SceneStreamer();
+		~SceneStreamer();
+		//Begin queueing the work for a new scene. If a scene is already streaming, the new scene is streamed after it.
+		void beginScene(string sceneName);
+		//Queue a snapshot to be loaded off the main thread and instantiated into the new scene
+		void addSnapshot(const filesystem::path& snapshotPath);
+		//Queue a step that builds part of the new scene under the staging root
+		void addStep(function<void(Body* stagingRoot)> step);
+		//Queue an asset to be loaded before the new scene is activated. The file is read and decoded on a worker thread where
+		//the asset type's loader supports it, and the asset is added on the main thread once that's done.
+		template<typename T>
+		void requestAsset(const filesystem::path& assetPath, const string& assetName = "") {
+			//The worker only uses the AssetManager's loader, so it doesn't need a current EngineContext
+			shared_ptr<future<shared_ptr<void>>> prepared = make_shared<future<shared_ptr<void>>>(async(launch::async, [assetPath, manager = &assets.get()]() {
+				return manager->prepare<T>(assetPath);
+			}));
+			addTask([prepared, assetPath, assetName](const Clock& frameClock) {
+				if (prepared->wait_for(chrono::seconds(0)) != future_status::ready) {
+					return StreamResult::Waiting;
+				}
+				assets->load<T>(assetPath, assetName, prepared->get());
+				return StreamResult::Done;
+			});
+		}
+		//Finish queueing work for the new scene. It's activated as soon as all of its work is done.
+		void endScene();
+		//Process queued work, activation and unloading within the frame budget. Called by the World each frame.
+		void update();
+		//Return whether a scene is being loaded, activated or unloaded
+		bool isStreaming() const;
+		//Set the milliseconds of streaming work allowed per frame
+		void setFrameBudget(float budgetMs);
+		float getFrameBudget() const { return frameBudgetMs; }
+		//Set the maximum number of Bodies of the previous scene destroyed per frame
+		void setUnloadBodiesPerFrame(size_t bodyCount);
+		//Return the worst frame time (in milliseconds) of the current or last scene transition
+		float getWorstFrameMs() const { return worstFrameMs; }
+		//Return the name of the last activated scene
+		string getActiveSceneName() const { return activeSceneName; }
+	private:
+		struct StreamTask {
+			function<StreamResult(const Clock&)> run;
+		};
+		struct StreamScene {
+			string name;
+			deque<StreamTask> tasks;
+			bool ended = false;
+		};
+
+		float frameBudgetMs = 4.f;
+		size_t unloadBodiesPerFrame = 256;
+		//Number of snapshot Bodies created between budget checks
+		size_t instantiateBatchSize = 32;
+
+		string activeSceneName = "";
+		//Scenes waiting to be activated, in the order they were begun. Only the front scene's tasks are run.
+		deque<StreamScene> scenes;
+		//Called when the new scene is activated, after its Bodies are moved out of staging
+		vector<function<void()>> activationCallbacks;
+		//Bodies created while staging, started when the new scene is activated
+		vector<Body*> stagedUninitialized;
+		//Top level Bodies of the active streamed scene
+		vector<Body*> activeBodies;
+		//Bodies of the previous scene waiting to be destroyed. Children are queued ahead of their parent as it's reached.
+		deque<Body*> unloadQueue;
+		Body* stagingRoot = nullptr;
+		Body* unloadingRoot = nullptr;
+
+		//Transition statistics
+		bool transitioning = false;
+		size_t transitionFrames = 0;
+		float worstFrameMs = 0;
+
+		//Queue a task on the last begun scene
+		void addTask(function<StreamResult(const Clock&)> run);
+		//Run the front scene's queued tasks until the budget is spent or a task is waiting
+		void runTasks(const Clock& frameClock);
+		//Move the staged Bodies into the World and queue the previous scene for unloading
+		void activate();
+		//Destroy the previous scene's Bodies, leaves first, within the unload limit
+		void unload(const Clock& frameClock);
+		//Move Bodies created since uninitializedStart from the World's uninitialized list to the staged list
+		void holdUninitialized(size_t uninitializedStart);
+		//Return whether the frame budget is spent
+		bool budgetSpent(const Clock& frameClock) const;
+	};
+}
@@ -0,0 +1,13 @@
+#include "Actuator.h"
+#include "../Body/Body.h"
+
+namespace CGEngine {
+	//Called with the Body and Behavior the actuator was created for, rather than those passed by the InputMap
+	void Actuator::call(Body*, Behavior*, const ScriptPayload& payload) {
+		//Destroyed Bodies stop receiving input until they are deleted at the end of the frame
+		if (this->caller != nullptr && this->caller->isDestroyed()) return;
+		//Input wakes its caller
+		if (this->caller != nullptr) this->caller->wake();
+		scriptEvent(ScArgs(this, this->caller, this->behavior, payload));
+	}
+}
@@ -7,9 +7,8 @@ namespace CGEngine {
 	public:
 		Actuator(ScriptEvent s, Body* calling = nullptr, Behavior* behavior = nullptr) : caller(calling), behavior(behavior), Script(s) { }
 
-		void call(Body* caller = nullptr, Behavior* behavior = nullptr) override {
-			scriptEvent(ScArgs(this, this->caller, this->behavior)); 
-		}
+		using Script::call;
+		void call(Body* caller, Behavior* behavior, const ScriptPayload& payload) override;
 	protected:
 		Body* caller = nullptr;
 		Behavior* behavior = nullptr;
@@ -0,0 +1,251 @@
+#include "Coroutine.h"
+#include "../Engine/Engine.h"
+
+namespace CGEngine {
+	ScriptTask::ScriptTask(handle_type coroutine) : handle(coroutine) {}
+
+	ScriptTask::ScriptTask(ScriptTask&& other) noexcept : handle(other.handle) {
+		other.handle = nullptr;
+	}
+
+	ScriptTask& ScriptTask::operator=(ScriptTask&& other) noexcept {
+		if (this != &other) {
+			if (handle) handle.destroy();
+			handle = other.handle;
+			other.handle = nullptr;
+		}
+		return *this;
+	}
+
+	ScriptTask::~ScriptTask() {
+		//A task that was never started still owns its coroutine
+		if (handle) handle.destroy();
+	}
+
+	ScriptTask::handle_type ScriptTask::release() {
+		handle_type released = handle;
+		handle = nullptr;
+		return released;
+	}
+
+	void WaitAwaiter::await_suspend(ScriptTask::handle_type handle) {
+		handle.promise().scheduler->resumeAfter(handle.promise().id, seconds);
+	}
+
+	void NextFrameAwaiter::await_suspend(ScriptTask::handle_type handle) {
+		handle.promise().scheduler->resumeNextFrame(handle.promise().id);
+	}
+
+	void EventAwaiter::await_suspend(ScriptTask::handle_type handle) {
+		handle.promise().scheduler->resumeOnDomain(handle.promise().id, domainId);
+	}
+
+	WaitAwaiter wait(sec_t seconds) {
+		return WaitAwaiter{ seconds };
+	}
+
+	NextFrameAwaiter nextFrame() {
+		return NextFrameAwaiter{};
+	}
+
+	EventAwaiter event(domainId_t domainId) {
+		return EventAwaiter{ domainId };
+	}
+
+	EventAwaiter event(const string& domainName) {
+		return EventAwaiter{ DomainRegistry::intern(domainName) };
+	}
+
+	CoroutineScheduler::CoroutineScheduler() {
+		init();
+	}
+
+	CoroutineScheduler::~CoroutineScheduler() {
+		for (auto& [id, coroutine] : coroutines) {
+			coroutine.handle.destroy();
+		}
+	}
+
+	id_t CoroutineScheduler::start(ScriptTask task, Body* body) {
+		ScriptTask::handle_type handle = task.release();
+		if (!handle) return 0;
+		if (body == nullptr) {
+			body = world->getRoot();
+		}
+		id_t id = nextId++;
+		handle.promise().scheduler = this;
+		handle.promise().id = id;
+		Coroutine& coroutine = coroutines[id];
+		coroutine.handle = handle;
+		coroutine.body = body;
+		bodyCoroutines[body].push_back(id);
+		//Run the coroutine up to its first suspension
+		resume({ 0, beginWait(coroutine), id });
+		return id;
+	}
+
+	void CoroutineScheduler::stop(id_t coroutineId) {
+		auto found = coroutines.find(coroutineId);
+		if (found == coroutines.end()) return;
+		//A running coroutine can't be destroyed, so it is destroyed once it suspends
+		if (find(resumingIds.begin(), resumingIds.end(), coroutineId) != resumingIds.end()) {
+			found->second.stopped = true;
+			return;
+		}
+		destroy(coroutineId);
+	}
+
+	void CoroutineScheduler::stopAll(Body* body) {
+		auto found = bodyCoroutines.find(body);
+		if (found == bodyCoroutines.end()) return;
+		vector<id_t> ids = found->second;
+		for (id_t id : ids) {
+			stop(id);
+		}
+	}
+
+	bool CoroutineScheduler::isRunning(id_t coroutineId) const {
+		auto found = coroutines.find(coroutineId);
+		return found != coroutines.end() && !found->second.stopped;
+	}
+
+	void CoroutineScheduler::update() {
+		size_t resumed = 0;
+		//Coroutines that wait for the next frame while this one is resumed are kept for the next update
+		vector<PendingResume> dueThisFrame;
+		swap(dueThisFrame, frameResumes);
+		for (const PendingResume& pending : dueThisFrame) {
+			if (resume(pending)) resumed++;
+		}
+
+		sec_t now = time->getElapsedSec();
+		while (!timedResumes.empty() && timedResumes.top().due <= now) {
+			PendingResume pending = timedResumes.top();
+			timedResumes.pop();
+			if (resume(pending)) resumed++;
+		}
+		lastResumeCount = resumed;
+	}
+
+	void CoroutineScheduler::notifyDomain(Body* body, domainId_t domainId) {
+		if (domainResumes.empty()) return;
+		auto found = domainResumes.find(body);
+		if (found == domainResumes.end()) return;
+		if (JobSystem::isInJob()) {
+			world->defer([this, body, domainId]() { notifyDomain(body, domainId); });
+			return;
+		}
+
+		//Take the waits for the domain out first, so a coroutine that waits for the domain again is resumed by the next call
+		vector<PendingResume> due;
+		for (const PendingResume& pending : found->second) {
+			auto coroutine = coroutines.find(pending.id);
+			if (coroutine != coroutines.end() && coroutine->second.awaitedDomain == domainId) {
+				due.push_back(pending);
+			}
+		}
+		for (const PendingResume& pending : due) {
+			endDomainWait(pending.id, coroutines[pending.id]);
+		}
+		for (const PendingResume& pending : due) {
+			resume(pending);
+		}
+	}
+
+	size_t CoroutineScheduler::getCount() const {
+		return coroutines.size();
+	}
+
+	size_t CoroutineScheduler::getCount(Body* body) const {
+		auto found = bodyCoroutines.find(body);
+		return found != bodyCoroutines.end() ? found->second.size() : 0;
+	}
+
+	size_t CoroutineScheduler::getLastResumeCount() const {
+		return lastResumeCount;
+	}
+
+	void CoroutineScheduler::resumeAfter(id_t coroutineId, sec_t seconds) {
+		auto found = coroutines.find(coroutineId);
+		if (found == coroutines.end()) return;
+		timedResumes.push({ time->getElapsedSec() + seconds, beginWait(found->second), coroutineId });
+	}
+
+	void CoroutineScheduler::resumeNextFrame(id_t coroutineId) {
+		auto found = coroutines.find(coroutineId);
+		if (found == coroutines.end()) return;
+		frameResumes.push_back({ 0, beginWait(found->second), coroutineId });
+	}
+
+	void CoroutineScheduler::resumeOnDomain(id_t coroutineId, domainId_t domainId) {
+		auto found = coroutines.find(coroutineId);
+		if (found == coroutines.end()) return;
+		Coroutine& coroutine = found->second;
+		coroutine.awaitedDomain = domainId;
+		domainResumes[coroutine.body].push_back({ 0, beginWait(coroutine), coroutineId });
+		//The World only calls a domain on its subscribers, so the Body subscribes for as long as the coroutine waits
+		world->subscribe(coroutine.body, domainId);
+	}
+
+	uint64_t CoroutineScheduler::beginWait(Coroutine& coroutine) {
+		coroutine.waitSequence = nextSequence++;
+		return coroutine.waitSequence;
+	}
+
+	bool CoroutineScheduler::resume(const PendingResume& pending) {
+		auto found = coroutines.find(pending.id);
+		if (found == coroutines.end() || found->second.waitSequence != pending.sequence) return false;
+
+		ScriptTask::handle_type handle = found->second.handle;
+		resumingIds.push_back(pending.id);
+		handle.resume();
+		resumingIds.pop_back();
+
+		//The coroutine may have started others, so look it up again
+		Coroutine& coroutine = coroutines[pending.id];
+		if (handle.promise().exception != nullptr) {
+			try {
+				rethrow_exception(handle.promise().exception);
+			} catch (const exception& error) {
+				log(this, LogError, "Coroutine[{}] on '{}' threw: {}", pending.id, coroutine.body->getName(), error.what());
+			} catch (...) {
+				log(this, LogError, "Coroutine[{}] on '{}' threw", pending.id, coroutine.body->getName());
+			}
+		}
+		if (handle.done() || coroutine.stopped) {
+			destroy(pending.id);
+		}
+		return true;
+	}
+
+	void CoroutineScheduler::destroy(id_t coroutineId) {
+		auto found = coroutines.find(coroutineId);
+		if (found == coroutines.end()) return;
+		Coroutine& coroutine = found->second;
+		endDomainWait(coroutineId, coroutine);
+
+		auto owned = bodyCoroutines.find(coroutine.body);
+		if (owned != bodyCoroutines.end()) {
+			vector<id_t>& ids = owned->second;
+			ids.erase(remove(ids.begin(), ids.end(), coroutineId), ids.end());
+			if (ids.empty()) bodyCoroutines.erase(owned);
+		}
+		//Queued timed and frame resumes are skipped once the coroutine is gone
+		ScriptTask::handle_type handle = coroutine.handle;
+		coroutines.erase(found);
+		handle.destroy();
+	}
+
+	void CoroutineScheduler::endDomainWait(id_t coroutineId, Coroutine& coroutine) {
+		if (!coroutine.awaitedDomain.has_value()) return;
+		domainId_t domainId = coroutine.awaitedDomain.value();
+		coroutine.awaitedDomain = nullopt;
+		world->unsubscribe(coroutine.body, domainId);
+
+		auto found = domainResumes.find(coroutine.body);
+		if (found == domainResumes.end()) return;
+		vector<PendingResume>& waits = found->second;
+		waits.erase(remove_if(waits.begin(), waits.end(), [coroutineId](const PendingResume& pending) { return pending.id == coroutineId; }), waits.end());
+		if (waits.empty()) domainResumes.erase(found);
+	}
+}
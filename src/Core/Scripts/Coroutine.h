@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include "../Types/Types.h"
+#include "../Engine/EngineSystem.h"
+#include "DomainRegistry.h"
+using namespace std;
+
+namespace CGEngine {
+	class Body;
+	class CoroutineScheduler;
+
+	/// <summary>
+	/// The return type of a script coroutine. A coroutine suspends with co_await wait(seconds), co_await nextFrame() or co_await event(domain)
+	/// and is run by passing it to Body::startCoroutine. It doesn't run until it is started, and the World's CoroutineScheduler owns it from then on.
+	/// </summary>
+	class ScriptTask {
+	public:
+		struct promise_type {
+			CoroutineScheduler* scheduler = nullptr;
+			id_t id = 0;
+			exception_ptr exception = nullptr;
+
+			ScriptTask get_return_object() { return ScriptTask(handle_type::from_promise(*this)); }
+			suspend_always initial_suspend() noexcept { return {}; }
+			suspend_always final_suspend() noexcept { return {}; }
+			void return_void() {}
+			void unhandled_exception() { exception = current_exception(); }
+		};
+		using handle_type = coroutine_handle<promise_type>;
+
+		ScriptTask(ScriptTask&& other) noexcept;
+		ScriptTask& operator=(ScriptTask&& other) noexcept;
+		ScriptTask(const ScriptTask&) = delete;
+		ScriptTask& operator=(const ScriptTask&) = delete;
+		~ScriptTask();
+		//Give up ownership of the coroutine, returning its handle
+		handle_type release();
+	private:
+		explicit ScriptTask(handle_type coroutine);
+		handle_type handle;
+	};
+
+	//Suspends the coroutine until seconds of World time have passed. Waits of 0 or less don't suspend.
+	struct WaitAwaiter {
+		sec_t seconds = 0;
+		bool await_ready() const noexcept { return seconds <= 0; }
+		void await_suspend(ScriptTask::handle_type handle);
+		void await_resume() const noexcept {}
+	};
+
+	//Suspends the coroutine until the next frame
+	struct NextFrameAwaiter {
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(ScriptTask::handle_type handle);
+		void await_resume() const noexcept {}
+	};
+
+	//Suspends the coroutine until the domain is next called on its Body
+	struct EventAwaiter {
+		domainId_t domainId = 0;
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(ScriptTask::handle_type handle);
+		void await_resume() const noexcept {}
+	};
+
+	WaitAwaiter wait(sec_t seconds);
+	NextFrameAwaiter nextFrame();
+	EventAwaiter event(domainId_t domainId);
+	EventAwaiter event(const string& domainName);
+
+	/// <summary>
+	/// Runs the World's script coroutines. Suspended coroutines are only touched when they are due: timed waits are kept in a queue ordered
+	/// by resume time, next frame waits in a list that is swapped out each frame, and event waits with the Body they wait on. Nothing is polled.
+	/// </summary>
+	class CoroutineScheduler : public EngineSystem {
+	public:
+		CoroutineScheduler();
+		~CoroutineScheduler();
+		/// <summary>
+		/// Take ownership of the coroutine and run it until it first suspends
+		/// </summary>
+		/// <param name="task">The coroutine to run</param>
+		/// <param name="body">The Body the coroutine runs on, which its event waits listen to. If null, the World's root is used.</param>
+		/// <returns>The id of the coroutine</returns>
+		id_t start(ScriptTask task, Body* body);
+		/// <summary>
+		/// Destroy the coroutine at its suspension point. A coroutine that stops itself is destroyed when it next suspends.
+		/// </summary>
+		/// <param name="coroutineId">The id of the coroutine</param>
+		void stop(id_t coroutineId);
+		/// <summary>
+		/// Stop every coroutine running on the Body. Called when the Body is deleted.
+		/// </summary>
+		/// <param name="body">The Body to stop the coroutines of</param>
+		void stopAll(Body* body);
+		/// <summary>
+		/// Return whether the coroutine has been started and hasn't finished or been stopped
+		/// </summary>
+		bool isRunning(id_t coroutineId) const;
+		/// <summary>
+		/// Resume the coroutines waiting for this frame and those whose wait has passed. Called by the World each frame after the update scripts.
+		/// </summary>
+		void update();
+		/// <summary>
+		/// Resume the Body's coroutines waiting for the domain. Called by the Body when the domain is called on it.
+		/// </summary>
+		/// <param name="body">The Body the domain was called on</param>
+		/// <param name="domainId">The interned domain id</param>
+		void notifyDomain(Body* body, domainId_t domainId);
+		/// <summary>
+		/// Return the number of running coroutines, in total or on the Body
+		/// </summary>
+		size_t getCount() const;
+		size_t getCount(Body* body) const;
+		/// <summary>
+		/// Return the number of coroutines resumed by the last update
+		/// </summary>
+		size_t getLastResumeCount() const;
+
+		//Called by the awaiters when the coroutine suspends
+		void resumeAfter(id_t coroutineId, sec_t seconds);
+		void resumeNextFrame(id_t coroutineId);
+		void resumeOnDomain(id_t coroutineId, domainId_t domainId);
+	private:
+		struct Coroutine {
+			ScriptTask::handle_type handle;
+			Body* body = nullptr;
+			//The domain the coroutine waits for, if it is waiting for one
+			optional<domainId_t> awaitedDomain = nullopt;
+			//The sequence of the coroutine's current wait. Queued resumes with another sequence are stale and skipped.
+			uint64_t waitSequence = 0;
+			bool stopped = false;
+		};
+		struct PendingResume {
+			sec_t due = 0;
+			uint64_t sequence = 0;
+			id_t id = 0;
+			//Earlier resumes first, in the order they were queued
+			bool operator>(const PendingResume& other) const {
+				return due != other.due ? due > other.due : sequence > other.sequence;
+			}
+		};
+
+		unordered_map<id_t, Coroutine> coroutines;
+		//Ids of the coroutines running on each Body
+		unordered_map<Body*, vector<id_t>> bodyCoroutines;
+		priority_queue<PendingResume, vector<PendingResume>, greater<PendingResume>> timedResumes;
+		vector<PendingResume> frameResumes;
+		//Event waits of each Body
+		unordered_map<Body*, vector<PendingResume>> domainResumes;
+		id_t nextId = 1;
+		uint64_t nextSequence = 1;
+		//The coroutines being resumed. A coroutine can resume others, for example by calling a domain they wait for.
+		vector<id_t> resumingIds;
+		size_t lastResumeCount = 0;
+
+		//Start a new wait for the coroutine, returning its sequence
+		uint64_t beginWait(Coroutine& coroutine);
+		//Resume the coroutine if the queued resume is still its current wait
+		bool resume(const PendingResume& pending);
+		//Destroy the coroutine and forget it
+		void destroy(id_t coroutineId);
+		//Stop waiting for the coroutine's awaited domain
+		void endDomainWait(id_t coroutineId, Coroutine& coroutine);
+	};
+}
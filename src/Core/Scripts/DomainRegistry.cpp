@@ -0,0 +1,24 @@
+#include "DomainRegistry.h"
+
+namespace CGEngine {
+	StringInterner<domainId_t>& DomainRegistry::get() {
+		static StringInterner<domainId_t> registry({ "update", "fixedUpdate", "start", "delete", "intersect", "mousePress", "mouseRelease", "keyPress", "keyRelease", "load", "mouseEnter", "mouseExit" });
+		return registry;
+	}
+
+	domainId_t DomainRegistry::intern(const string& name) {
+		return get().intern(name);
+	}
+
+	optional<domainId_t> DomainRegistry::find(const string& name) {
+		return get().find(name);
+	}
+
+	const string& DomainRegistry::getName(domainId_t domainId) {
+		return get().getName(domainId);
+	}
+
+	size_t DomainRegistry::size() {
+		return get().size();
+	}
+}
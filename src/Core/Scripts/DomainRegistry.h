@@ -0,0 +1,45 @@
+#pragma once
+
+#include "../Types/Types.h"
+#include "../Types/StringInterner.h"
+
+namespace CGEngine {
+	//Ids of the engine's domains, which are interned first and in this order
+	constexpr domainId_t onUpdateDomain = 0;
+	constexpr domainId_t onFixedUpdateDomain = 1;
+	constexpr domainId_t onStartDomain = 2;
+	constexpr domainId_t onDeleteDomain = 3;
+	constexpr domainId_t onIntersectDomain = 4;
+	constexpr domainId_t onMousePressDomain = 5;
+	constexpr domainId_t onMouseReleaseDomain = 6;
+	constexpr domainId_t onKeyPressDomain = 7;
+	constexpr domainId_t onKeyReleaseDomain = 8;
+	constexpr domainId_t onLoadDomain = 9;
+	constexpr domainId_t onMouseEnterDomain = 10;
+	constexpr domainId_t onMouseExitDomain = 11;
+
+	/// <summary>
+	/// Interns ScriptDomain names to small dense ids, so ScriptMaps and the World can index their domains by id instead of hashing
+	/// and comparing names on every call. A name keeps its id for the life of the process. Safe to call from any thread.
+	/// </summary>
+	class DomainRegistry {
+	public:
+		/// <summary>
+		/// Return the id of the domain name, assigning the next id if the name hasn't been interned
+		/// </summary>
+		static domainId_t intern(const string& name);
+		/// <summary>
+		/// Return the id of the domain name if it has been interned. Lookups don't intern, so calling an unknown domain doesn't grow the registry.
+		/// </summary>
+		static optional<domainId_t> find(const string& name);
+		/// <summary>
+		/// Return the name of an interned domain id, or an empty string if the id hasn't been assigned
+		/// </summary>
+		static const string& getName(domainId_t domainId);
+		//Return the number of interned names, which is one past the largest id
+		static size_t size();
+	private:
+		//Created on first use, so domains can be interned during static initialization
+		static StringInterner<domainId_t>& get();
+	};
+}
@@ -5,4 +5,30 @@ namespace CGEngine {
 	Script::Script(ScriptEvent evt) {
 		scriptEvent = evt;
 	}
+
+	void Script::setThreadSafe(bool safe) {
+		threadSafe = safe;
+	}
+
+	bool Script::isThreadSafe() const {
+		return threadSafe;
+	}
+
+	void Script::declareAccess(vector<Body*> readBodies, vector<Body*> writeBodies) {
+		reads = readBodies;
+		writes = writeBodies;
+		accessDeclared = true;
+	}
+
+	bool Script::hasDeclaredAccess() const {
+		return accessDeclared;
+	}
+
+	const vector<Body*>& Script::getReadBodies() const {
+		return reads;
+	}
+
+	const vector<Body*>& Script::getWriteBodies() const {
+		return writes;
+	}
 }
\ No newline at end of file
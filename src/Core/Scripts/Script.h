@@ -2,6 +2,8 @@
 
 #include <functional>
 #include <optional>
+#include <type_traits>
+#include <vector>
 #include "../Types/Types.h"
 #include "../Types/DataMap.h"
 #include "../Types/DataControllers/InputDataController.h"
@@ -13,29 +15,97 @@ namespace CGEngine {
 	class Script;
 	class Behavior;
 
+	/// <summary>
+	/// A typed event passed to Scripts by reference for the duration of a call. Its type is identified by a tag unique to each event type,
+	/// so handlers check it without RTTI, any or allocating. Use DataMap input for dynamic data.
+	/// </summary>
+	struct ScriptPayload {
+		const void* event = nullptr;
+		const void* type = nullptr;
+
+		template<typename E>
+		static const void* typeTag() {
+			//Not const, so identical-data folding (such as MSVC's /OPT:ICF) can't merge the tags of different types
+			static char tag = 0;
+			return &tag;
+		}
+
+		template<typename E>
+		static ScriptPayload of(const E& event) {
+			return { &event, typeTag<remove_cv_t<E>>() };
+		}
+
+		//Return the event if it is of type E, or nullptr
+		template<typename E>
+		const E* get() const {
+			return type == typeTag<remove_cv_t<E>>() ? static_cast<const E*>(event) : nullptr;
+		}
+	};
+
 	struct ScArgs {
 	public:
-		ScArgs(Script* s, Body* b = nullptr, Behavior* beh = nullptr) {
+		ScArgs(Script* s, Body* b = nullptr, Behavior* beh = nullptr, ScriptPayload p = ScriptPayload()) {
 			script = s;
 			caller = b;
 			behavior = beh;
+			payload = p;
 		}
 		Script* script;
 		Body* caller = nullptr;
 		Behavior* behavior = nullptr;
+		ScriptPayload payload;
+
+		//Return the event the Script was called with if it is of type E, or nullptr
+		template<typename E>
+		const E* getEvent() const {
+			return payload.get<E>();
+		}
 	};
 
 	typedef function<void(ScArgs)> ScriptEvent;
 
+	template<typename E>
+	using TypedScriptEvent = function<void(ScArgs, const E&)>;
+
+	//Wrap a handler of E events as a ScriptEvent. Calls with no event, or an event of another type, are ignored.
+	template<typename E>
+	ScriptEvent typedEvent(TypedScriptEvent<E> handler) {
+		return [handler](ScArgs args) {
+			if (const E* event = args.getEvent<E>()) {
+				handler(args, *event);
+			}
+		};
+	}
+
 	class Script : public InputDataController, public OutputDataController {
 	public:
 		Script(ScriptEvent evt);
+		//Scripts are owned and deleted through Script pointers, such as a timer's onComplete Script
+		virtual ~Script() = default;
 
 		ScriptEvent scriptEvent;
 		optional<size_t> id;
 
-		virtual void call(Body* caller = nullptr, Behavior* behavior = nullptr) {
-			scriptEvent(ScArgs(this, caller, behavior));
+		void call(Body* caller = nullptr, Behavior* behavior = nullptr) {
+			call(caller, behavior, ScriptPayload());
 		}
+
+		virtual void call(Body* caller, Behavior* behavior, const ScriptPayload& payload) {
+			scriptEvent(ScArgs(this, caller, behavior, payload));
+		}
+
+		//Mark the script as safe to run on a job thread during a parallel update. A thread-safe script only reads and writes its caller.
+		void setThreadSafe(bool safe);
+		bool isThreadSafe() const;
+		//Declare the Bodies (besides its caller) the script reads and writes, so it can run on a job thread alongside scripts it doesn't conflict with
+		void declareAccess(vector<Body*> readBodies, vector<Body*> writeBodies);
+		bool hasDeclaredAccess() const;
+		const vector<Body*>& getReadBodies() const;
+		const vector<Body*>& getWriteBodies() const;
+	private:
+		bool threadSafe = false;
+		bool accessDeclared = false;
+		vector<Body*> reads;
+		vector<Body*> writes;
 	};
 }
\ No newline at end of file
@@ -2,17 +2,20 @@
 #include "../Engine/Engine.h"
 
 namespace CGEngine {
-    ScriptDomain::ScriptDomain(string name, string bodyName) {
-        domainName = name;
+    static atomic<uint64_t> nextInstanceId = 0;
+
+    ScriptDomain::ScriptDomain(domainId_t id, string bodyName) {
+        domainId = id;
+        instanceId = nextInstanceId.fetch_add(1, memory_order_relaxed);
+        domainName = DomainRegistry::getName(id);
         ownerName = bodyName;
         init();
-        setSystemName(ownerName.append(ownerName==""?"":" ").append("Domain(").append(name).append(")"));
+        setSystemName(ownerName.append(ownerName==""?"":" ").append("Domain(").append(domainName).append(")"));
     }
 
     ScriptDomain::~ScriptDomain() {
         clear();
-        for (const auto& [key, value] : scripts) {
-            Script* script = value;
+        for (Script* script : scripts) {
             delete script;
         }
     }
@@ -21,45 +24,61 @@ namespace CGEngine {
         return domainName;
     }
 
+    domainId_t ScriptDomain::getId() const {
+        return domainId;
+    }
+
+    uint64_t ScriptDomain::getInstanceId() const {
+        return instanceId;
+    }
+
     size_t ScriptDomain::addScript(Script* script) {
         size_t id = domainIds.receive(&script->id);
-        scripts[id] = script;
+        if (id >= slotById.size()) {
+            slotById.resize(id + 1, noSlot);
+        }
+        //Scripts added during a call are appended past the called slots, so they are first called on the next call
+        slotById[id] = scripts.size();
+        scripts.push_back(script);
+        scriptCount++;
         log(this, LogInfo, "Added Script Id {}", id);
         return id;
     }
 
     Script* ScriptDomain::getScript(size_t scriptId) {
-        auto iterator = scripts.find(scriptId);
-        if (iterator != scripts.end()) {
-            return (*iterator).second;
+        if (scriptId < slotById.size() && slotById[scriptId] != noSlot) {
+            return scripts[slotById[scriptId]];
         }
         return nullptr;
     }
 
     void ScriptDomain::removeScript(size_t scriptId, bool shouldLog) {
         if (Script* script = getScript(scriptId)) {
-            //Refund the script id & erase it from the map (if it has an id)
+            //Refund the script id & tombstone its slot (if it has an id)
             removeScript(script, shouldLog);
         }
     }
 
     void ScriptDomain::removeScript(Script* script, bool shouldLog) {
-        //Ignore scripts with no id
-        if (script->id.has_value()) {
+        //Ignore scripts with no id, or that aren't in this domain
+        if (script->id.has_value() && getScript(script->id.value()) == script) {
             size_t scriptId = script->id.value();
             if (shouldLog) {
                 log(this, LogInfo, "Removed Script Id {}", scriptId);
             }
-            //Refund the script id and erase it from the scripts map
+            //Tombstone the slot and refund the script id
+            scripts[slotById[scriptId]] = nullptr;
+            slotById[scriptId] = noSlot;
+            scriptCount--;
+            tombstoneCount++;
             domainIds.refund(&script->id);
-            scripts.erase(scriptId);
         }
     }
 
     void ScriptDomain::eraseScript(size_t scriptId) {
         //Ignore invalid script ids
         if (Script* script = getScript(scriptId)) {
-            //Refund the script id & erase it from the map
+            //Refund the script id & tombstone its slot
             removeScript(script, false);
             //Delete it
             deleteScript(script, scriptId);
@@ -70,7 +89,7 @@ namespace CGEngine {
         //Ignore null scripts (and scripts with no id)
         if (script != nullptr) {
             optional<id_t> scriptId = script->id;
-            //Refund the script id & erase it from the map (if it has an id)
+            //Refund the script id & tombstone its slot (if it has an id)
             removeScript(script, false);
             //Delete it
             deleteScript(script, scriptId);
@@ -78,96 +97,152 @@ namespace CGEngine {
     }
 
     bool ScriptDomain::isEmpty() {
-        return scripts.size() <= 0;
+        return scriptCount == 0;
+    }
+
+    size_t ScriptDomain::getScriptCount() const {
+        return scriptCount;
     }
 
     void ScriptDomain::clear() {
-        vector<size_t> keys = getScriptIds();
-        for (int i = 0; i < keys.size(); i++) {
-            auto iterator = scripts.find(keys[i]);
-            if (iterator != scripts.end()) {
-                Script* script = (*iterator).second;
+        for (size_t slot = 0; slot < scripts.size(); slot++) {
+            if (Script* script = scripts[slot]) {
                 removeScript(script);
             }
         }
-        scripts.clear();
+        if (callDepth == 0) {
+            compact();
+        }
     }
 
     vector<size_t> ScriptDomain::getScriptIds() {
         vector<size_t> keys;
-        for (const auto& [key, value] : scripts) { keys.push_back(key); }
+        keys.reserve(scriptCount);
+        forEachScript([&keys](Script* script) { keys.push_back(script->id.value()); });
         return keys;
     }
 
-    void ScriptDomain::callDomain(Body* caller, Behavior* behavior) {
-        vector<size_t> keys = getScriptIds();
+    size_t ScriptDomain::beginCall() {
+        if (callDepth == 0 && tombstoneCount > 0) {
+            compact();
+        }
+        callDepth++;
+        return scripts.size();
+    }
 
-        for (int i = 0; i < keys.size(); i++) {
-            auto iterator = scripts.find(keys[i]);
-            if (iterator != scripts.end()) {
-                Script* script = (*iterator).second;
+    void ScriptDomain::endCall() {
+        callDepth--;
+        if (callDepth == 0 && deletePending) {
+            deleteDomain();
+        }
+    }
+
+    void ScriptDomain::compact() {
+        size_t live = 0;
+        for (size_t slot = 0; slot < scripts.size(); slot++) {
+            if (Script* script = scripts[slot]) {
+                scripts[live] = script;
+                slotById[script->id.value()] = live;
+                live++;
+            }
+        }
+        scripts.resize(live);
+        tombstoneCount = 0;
+    }
+
+    void ScriptDomain::callDomain(Body* caller, Behavior* behavior) {
+        PROFILE_DOMAIN_CALL(this, caller, behavior);
+        //Scripts may add or remove Scripts in this domain while it is called. Removed Scripts are skipped and added Scripts wait for the next call.
+        size_t slotCount = beginCall();
+        for (size_t slot = 0; slot < slotCount; slot++) {
+            if (Script* script = scripts[slot]) {
+                PROFILE_SCRIPT_CALL(this, script->id, caller, behavior);
                 script->call(caller, behavior);
             }
         }
+        endCall();
     }
 
     void ScriptDomain::callDomain(Body* caller, Behavior* behavior, optional<DataMap> input) {
-        vector<size_t> keys = getScriptIds();
-
-        for (int i = 0; i < keys.size(); i++) {
-            auto iterator = scripts.find(keys[i]);
-            if (iterator != scripts.end()) {
-                Script* script = (*iterator).second;
+        PROFILE_DOMAIN_CALL(this, caller, behavior);
+        size_t slotCount = beginCall();
+        for (size_t slot = 0; slot < slotCount; slot++) {
+            if (Script* script = scripts[slot]) {
+                PROFILE_SCRIPT_CALL(this, script->id, caller, behavior);
                 if (input != nullopt) {
                     script->setInput(input.value());
                 }
                 script->call(caller, behavior);
             }
         }
+        endCall();
     }
 
-    void ScriptDomain::setDomainInput(DataMap data) {
-        vector<size_t> keys = getScriptIds();
-
-        for (int i = 0; i < keys.size(); i++) {
-            auto iterator = scripts.find(keys[i]);
-            if (iterator != scripts.end()) {
-                Script* script = (*iterator).second;
-                script->setInput(data);
+    void ScriptDomain::callDomainWithEvent(Body* caller, Behavior* behavior, const ScriptPayload& payload) {
+        PROFILE_DOMAIN_CALL(this, caller, behavior);
+        size_t slotCount = beginCall();
+        for (size_t slot = 0; slot < slotCount; slot++) {
+            if (Script* script = scripts[slot]) {
+                PROFILE_SCRIPT_CALL(this, script->id, caller, behavior);
+                script->call(caller, behavior, payload);
             }
         }
+        endCall();
+    }
+
+    void ScriptDomain::setDomainInput(DataMap data) {
+        forEachScript([&data](Script* script) { script->setInput(data); });
     }
+
     void ScriptDomain::setScriptInput(size_t scriptId, DataMap data) {
-        auto iterator = scripts.find(scriptId);
-        if (iterator != scripts.end()) {
-            Script* script = (*iterator).second;
+        if (Script* script = getScript(scriptId)) {
             script->setInput(data);
         }
     }
 
     void ScriptDomain::callScript(size_t scriptId, Body* caller, Behavior* behavior) {
         if (Script* script = getScript(scriptId)) {
+            PROFILE_SCRIPT_CALL(this, scriptId, caller, behavior);
+            beginCall();
             script->call(caller, behavior);
+            endCall();
         }
     }
 
     void ScriptDomain::callScript(size_t scriptId, Body* caller, DataMap input, Behavior* behavior) {
         if (Script* script = getScript(scriptId)) {
+            PROFILE_SCRIPT_CALL(this, scriptId, caller, behavior);
             script->setInput(input);
+            beginCall();
             script->call(caller, behavior);
+            endCall();
         }
     }
 
     void ScriptDomain::deleteDomain() {
-        vector<size_t> keys = getScriptIds();
-        for (int i = 0; i < keys.size(); i++) {
-            auto iterator = scripts.find(keys[i]);
-            if (iterator != scripts.end()) {
-                Script* script = (*iterator).second;
+        if (callDepth > 0) {
+            //A Script is deleting the Domain it was called from. The Scripts are removed so the calls in progress skip them, and are
+            //deleted with the Domain once the outermost call returns.
+            if (deletePending) return;
+            deletePending = true;
+            for (size_t slot = 0; slot < scripts.size(); slot++) {
+                if (Script* script = scripts[slot]) {
+                    removeScript(script, false);
+                    pendingDeleteScripts.push_back(script);
+                }
+            }
+            return;
+        }
+        for (Script* script : pendingDeleteScripts) {
+            deleteScript(script);
+        }
+        pendingDeleteScripts.clear();
+        for (size_t slot = 0; slot < scripts.size(); slot++) {
+            if (Script* script = scripts[slot]) {
                 eraseScript(script);
             }
         }
-        if (scripts.size() > 0) {
+        if (scriptCount > 0) {
             log(this, LogWarn, "Scripts remain after deletion");
             clear();
         }
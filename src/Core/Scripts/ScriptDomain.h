@@ -5,22 +5,40 @@
 #include "../Types/UniqueIntegerStack.h"
 #include "../Types/Types.h"
 #include "../Logging/Logging.h"
+#include "DomainRegistry.h"
+#include "ScriptProfiler.h"
 using namespace std;
 
 namespace CGEngine {
     class ScriptDomain : public EngineSystem {
     public:
-        ScriptDomain(string name, string bodyName = "");
+        ScriptDomain(domainId_t id, string bodyName = "");
         ~ScriptDomain();
         string getName();
+        domainId_t getId() const;
+        /// <summary>
+        /// Return an id unique to this ScriptDomain for the life of the process. Unlike its address, it isn't reused once the domain is deleted.
+        /// </summary>
+        uint64_t getInstanceId() const;
         /// <summary>
         /// For each domain script (by key array), refund its id, remove it from the map and delete it. Finally, clear the domain's script map.
+        /// If the domain is being called, its Scripts are removed now and the domain is deleted when the outermost call returns.
         /// </summary>
         void deleteDomain();
         bool isEmpty();
+        size_t getScriptCount() const;
         void clear();
         Script* getScript(size_t scriptId);
         vector<size_t> getScriptIds();
+        /// <summary>
+        /// Call the function with each Script in the Domain, in the order they were added, without allocating
+        /// </summary>
+        template<typename ScriptFunction>
+        void forEachScript(ScriptFunction function) {
+            for (size_t slot = 0; slot < scripts.size(); slot++) {
+                if (scripts[slot] != nullptr) function(scripts[slot]);
+            }
+        }
         size_t addScript(Script* script);
         void removeScript(size_t scriptId, bool shouldLog = true);
         void removeScript(Script* script, bool shouldLog = true);
@@ -41,6 +59,13 @@ namespace CGEngine {
         /// <param name="input">The DataStack to pass as input</param>
         void callDomain(Body* caller, Behavior* behavior, optional<DataMap> input);
         /// <summary>
+        /// Call each Script in the Domain with a typed event, which the Scripts read through ScArgs::getEvent. Nothing is copied or allocated.
+        /// </summary>
+        /// <param name="caller">The Body calling the script</param>
+        /// <param name="behavior">The Behavior calling the script</param>
+        /// <param name="payload">The event to pass</param>
+        void callDomainWithEvent(Body* caller, Behavior* behavior, const ScriptPayload& payload);
+        /// <summary>
         /// Call the Script from the Domain, passing caller and others as arguments and passing the predecessor script's output DataStack as input
         /// </summary>
         /// <param name="scriptId">The id of the script in the domain to call</param>
@@ -68,10 +93,30 @@ namespace CGEngine {
         /// <param name="data">The DataStack to pass as input</param>
         void setScriptInput(size_t scriptId, DataMap data);
     private:
+        domainId_t domainId;
+        uint64_t instanceId;
         string domainName;
         string ownerName = "";
-        map<size_t, Script*> scripts;
+        //Scripts in the order they were added. A removed Script leaves a null tombstone so calls in progress keep their place,
+        //and the tombstones are compacted away before the next outermost call.
+        vector<Script*> scripts;
+        //Slot of each script id in scripts, or noSlot
+        vector<size_t> slotById;
+        static constexpr size_t noSlot = SIZE_MAX;
+        size_t scriptCount = 0;
+        size_t tombstoneCount = 0;
+        //Number of calls in progress, counting nested calls of the Domain from its own Scripts
+        size_t callDepth = 0;
+        //Set when a Script deletes the Domain while it is called. Its removed Scripts are kept until the outermost call returns, since one of them is running.
+        bool deletePending = false;
+        vector<Script*> pendingDeleteScripts;
         UniqueIntegerStack<size_t> domainIds = UniqueIntegerStack<size_t>(1000U);
         void deleteScript(Script* script, optional<id_t> scriptId = nullopt);
+        //Return the number of slots to call and start a call, compacting first if no other call is in progress
+        size_t beginCall();
+        //End a call, deleting the Domain if it was deleted during the outermost call. Nothing may use the Domain after it returns.
+        void endCall();
+        //Remove the tombstones, moving the remaining Scripts down in order
+        void compact();
     };
 }
\ No newline at end of file
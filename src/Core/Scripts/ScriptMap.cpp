@@ -18,57 +18,90 @@ namespace CGEngine {
 		setSystemName(ownerName.append(ownerName!=""?" ":"").append("ScriptMap"));
 	}
 
-	size_t ScriptMap::addScript(string domainName, Script* script) {
-		ScriptDomain* domain = getDomain(domainName);
+	size_t ScriptMap::addScript(domainId_t domainId, Script* script) {
+		ScriptDomain* domain = getDomain(domainId);
 		if (domain == nullptr) {
-			domain = addDomain(domainName);
+			domain = addDomain(domainId);
 		}
 		if (domain != nullptr) {
 			size_t scriptId = domain->addScript(script);
+			updateSubscription(domainId);
 			return scriptId;
 		}
 		return 0U;
 	}
 
-	void ScriptMap::removeScript(string domainName, size_t scriptId, bool shouldDelete) {
-		if (ScriptDomain* domain = getDomain(domainName)) {
+	size_t ScriptMap::addScript(string domainName, Script* script) {
+		return addScript(DomainRegistry::intern(domainName), script);
+	}
+
+	void ScriptMap::removeScript(domainId_t domainId, size_t scriptId, bool shouldDelete) {
+		if (ScriptDomain* domain = getDomain(domainId)) {
 			domain->removeScript(scriptId);
 			if (shouldDelete && domain->isEmpty()) {
 				deleteDomain(domain);
+			} else {
+				updateSubscription(domainId);
 			}
 		}
 	}
 
+	void ScriptMap::removeScript(string domainName, size_t scriptId, bool shouldDelete) {
+		if (optional<domainId_t> domainId = DomainRegistry::find(domainName)) {
+			removeScript(domainId.value(), scriptId, shouldDelete);
+		}
+	}
+
 	void ScriptMap::removeScript(string domainName, Script* script, bool shouldDelete) {
 		if (ScriptDomain* domain = getDomain(domainName)) {
 			domain->removeScript(script);
 			if (shouldDelete && domain->isEmpty()) {
 				deleteDomain(domain);
+			} else {
+				updateSubscription(domain->getId());
 			}
 		}
 	}
 
-	void ScriptMap::eraseScript(string domainName, size_t scriptId, bool shouldDelete) {
-		if (ScriptDomain* domain = getDomain(domainName)) {
+	void ScriptMap::eraseScript(domainId_t domainId, size_t scriptId, bool shouldDelete) {
+		if (ScriptDomain* domain = getDomain(domainId)) {
 			domain->eraseScript(scriptId);
 			if (shouldDelete && domain->isEmpty()) {
 				deleteDomain(domain);
+			} else {
+				updateSubscription(domainId);
 			}
 		}
 	}
+
+	void ScriptMap::eraseScript(string domainName, size_t scriptId, bool shouldDelete) {
+		if (optional<domainId_t> domainId = DomainRegistry::find(domainName)) {
+			eraseScript(domainId.value(), scriptId, shouldDelete);
+		}
+	}
+
 	void ScriptMap::eraseScript(string domainName, Script* script, bool shouldDelete) {
 		if (ScriptDomain* domain = getDomain(domainName)) {
 			domain->eraseScript(script);
 			if (shouldDelete && domain->isEmpty()) {
 				deleteDomain(domain);
+			} else {
+				updateSubscription(domain->getId());
 			}
 		}
 	}
 
-	void ScriptMap::clearDomain(string domainName) {
-		log(this, LogInfo, "Clearing Domain '{}'", domainName);
-		if (ScriptDomain* domain = getDomain(domainName)) {
+	void ScriptMap::clearDomain(domainId_t domainId) {
+		log(this, LogInfo, "Clearing Domain '{}'", DomainRegistry::getName(domainId));
+		if (ScriptDomain* domain = getDomain(domainId)) {
 			domain->clear();
+			updateSubscription(domainId);
+		}
+	}
+
+	void ScriptMap::clearDomain(string domainName) {
+		if (optional<domainId_t> domainId = DomainRegistry::find(domainName)) {
+			clearDomain(domainId.value());
 		}
 	}
 
@@ -76,17 +109,29 @@ namespace CGEngine {
 		deleteDomains();
 		//Domains have been deleted, so clear their pointers
 		domains.clear();
+		for (domainId_t domainId : subscribedDomains) {
+			if (owner != nullptr && world != nullptr) {
+				world->unsubscribe(owner, domainId);
+			}
+		}
+		subscribedDomains.clear();
 	}
 
-	void ScriptMap::callDomain(string domainName, Behavior* behavior, bool logUpdate) {
-		if (ScriptDomain* domain = getDomain(domainName)) {
-			if (domainName != onUpdateEvent || logUpdate) {
+	void ScriptMap::callDomain(domainId_t domainId, Behavior* behavior, bool logUpdate) {
+		if (ScriptDomain* domain = getDomain(domainId)) {
+			if (domainId != onUpdateDomain || logUpdate) {
 				log(this, LogInfo, "Calling Domain '{}'", domain->getName());
 			}
 			domain->callDomain(owner, behavior);
 		}
 	}
 
+	void ScriptMap::callDomain(string domainName, Behavior* behavior, bool logUpdate) {
+		if (optional<domainId_t> domainId = DomainRegistry::find(domainName)) {
+			callDomain(domainId.value(), behavior, logUpdate);
+		}
+	}
+
 	void ScriptMap::callScript(string domainName, size_t scriptId, Behavior* behavior) {
 		if (ScriptDomain* domain = getDomain(domainName)) {
 			log(this, LogInfo, "Calling Script '{}'.'{}'", domain->getName(), to_string(scriptId));
@@ -94,15 +139,21 @@ namespace CGEngine {
 		}
 	}
 
-	void ScriptMap::callDomainWithData(string domainName, Behavior* behavior, DataMap input, bool logUpdate) {
-		if (ScriptDomain* domain = getDomain(domainName)) {
-			if (domainName != onUpdateEvent || logUpdate) {
+	void ScriptMap::callDomainWithData(domainId_t domainId, Behavior* behavior, DataMap input, bool logUpdate) {
+		if (ScriptDomain* domain = getDomain(domainId)) {
+			if (domainId != onUpdateDomain || logUpdate) {
 				log(this, LogInfo, "Calling Domain '{}'", domain->getName());
 			}
 			domain->callDomain(owner, behavior, input);
 		}
 	}
 
+	void ScriptMap::callDomainWithData(string domainName, Behavior* behavior, DataMap input, bool logUpdate) {
+		if (optional<domainId_t> domainId = DomainRegistry::find(domainName)) {
+			callDomainWithData(domainId.value(), behavior, input, logUpdate);
+		}
+	}
+
 	void ScriptMap::callScriptWithData(string domainName, size_t scriptId, Behavior* behavior, DataMap input) {
 		if (ScriptDomain* domain = getDomain(domainName)) {
 			log(this, LogInfo, "Calling Script '{}'.'{}'", domain->getName(), to_string(scriptId));
@@ -110,40 +161,100 @@ namespace CGEngine {
 		}
 	}
 
+	void ScriptMap::callDomainWithEvent(domainId_t domainId, const ScriptPayload& payload, Behavior* behavior) {
+		if (ScriptDomain* domain = getDomain(domainId)) {
+			domain->callDomainWithEvent(owner, behavior, payload);
+		}
+	}
+
+	void ScriptMap::callDomainWithEvent(const string& domainName, const ScriptPayload& payload, Behavior* behavior) {
+		if (ScriptDomain* domain = getDomain(domainName)) {
+			domain->callDomainWithEvent(owner, behavior, payload);
+		}
+	}
+
+	void ScriptMap::deleteDomain(domainId_t domainId) {
+		if (ScriptDomain* domain = getDomain(domainId)) {
+			deleteDomain(domain);
+		}
+	}
+
 	void ScriptMap::deleteDomain(string domainName) {
 		if (ScriptDomain* domain = getDomain(domainName)) {
 			deleteDomain(domain);
 		}
 	}
 
-	ScriptDomain* ScriptMap::addDomain(string domainName) {
-		domains[domainName] = new ScriptDomain(domainName, ownerName);
-		log(this, LogInfo, "Added Domain '{}'", domainName);
-		return domains[domainName];
+	bool ScriptMap::getDomainAccess(domainId_t domainId, vector<Body*>& reads, vector<Body*>& writes) {
+		ScriptDomain* domain = getDomain(domainId);
+		if (domain == nullptr) return true;
+		bool parallel = true;
+		domain->forEachScript([&parallel, &reads, &writes](Script* script) {
+			if (!parallel) return;
+			if (script->hasDeclaredAccess()) {
+				reads.insert(reads.end(), script->getReadBodies().begin(), script->getReadBodies().end());
+				writes.insert(writes.end(), script->getWriteBodies().begin(), script->getWriteBodies().end());
+			} else if (!script->isThreadSafe()) {
+				parallel = false;
+			}
+		});
+		return parallel;
 	}
 
-	ScriptDomain* ScriptMap::getDomain(string domainName) {
-		if (domains.find(domainName) != domains.end()) {
-			return domains[domainName];
+	bool ScriptMap::getDomainAccess(const string& domainName, vector<Body*>& reads, vector<Body*>& writes) {
+		optional<domainId_t> domainId = DomainRegistry::find(domainName);
+		return !domainId.has_value() || getDomainAccess(domainId.value(), reads, writes);
+	}
+
+	ScriptDomain* ScriptMap::addDomain(domainId_t domainId) {
+		if (domainId >= domains.size()) {
+			domains.resize((size_t)domainId + 1, nullptr);
 		}
-		return nullptr;
+		domains[domainId] = new ScriptDomain(domainId, ownerName);
+		log(this, LogInfo, "Added Domain '{}'", DomainRegistry::getName(domainId));
+		return domains[domainId];
+	}
+
+	ScriptDomain* ScriptMap::getDomain(domainId_t domainId) {
+		return domainId < domains.size() ? domains[domainId] : nullptr;
+	}
+
+	ScriptDomain* ScriptMap::getDomain(const string& domainName) {
+		optional<domainId_t> domainId = DomainRegistry::find(domainName);
+		return domainId.has_value() ? getDomain(domainId.value()) : nullptr;
 	}
 
 	void ScriptMap::deleteDomains() {
-		for (auto iterator = domains.begin(); iterator != domains.end(); iterator++) {
-			ScriptDomain* domain = (*iterator).second;
+		for (ScriptDomain* domain : domains) {
 			//Refunds script ids, erases them from its map & deletes them, then clear the map. Prints a warning if scripts remain
-			domain->deleteDomain();
+			if (domain != nullptr) domain->deleteDomain();
 		}
 	}
 
 	void ScriptMap::deleteDomain(ScriptDomain* domain) {
 		if (domain != nullptr) {
-			string domainName = domain->getName();
-			//Find and erase the domain from the domains map
-			if (domains.find(domainName) != domains.end()) domains.erase(domainName);
+			domainId_t domainId = domain->getId();
+			//Erase the domain from the domains table
+			if (getDomain(domainId) == domain) domains[domainId] = nullptr;
 			//Refunds script ids, erase them from the domain's scripts map & delete them, then clear the map. Prints a warning if scripts remain
 			domain->deleteDomain();
+			updateSubscription(domainId);
+		}
+	}
+
+	void ScriptMap::updateSubscription(domainId_t domainId) {
+		if (owner == nullptr || world == nullptr) return;
+		//Script changes wake the owner
+		owner->wake();
+		ScriptDomain* domain = getDomain(domainId);
+		bool hasScripts = domain != nullptr && !domain->isEmpty();
+		bool subscribed = subscribedDomains.count(domainId) > 0;
+		if (hasScripts && !subscribed) {
+			subscribedDomains.insert(domainId);
+			world->subscribe(owner, domainId);
+		} else if (!hasScripts && subscribed) {
+			subscribedDomains.erase(domainId);
+			world->unsubscribe(owner, domainId);
 		}
 	}
-}
\ No newline at end of file
+}
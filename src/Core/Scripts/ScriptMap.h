@@ -1,5 +1,6 @@
 #pragma once
 
+#include <set>
 #include "ScriptDomain.h"
 #include "../Logging/Logging.h"
 
@@ -7,28 +8,56 @@ namespace CGEngine {
 	class ScriptMap : public EngineSystem{
 	public:
 		ScriptMap(Body* o);
+		//Domains are indexed by their interned id. The overloads taking a domain name intern or look up the name, then forward.
+		size_t addScript(domainId_t domainId, Script* script);
 		size_t addScript(string domainName, Script* script);
+		void removeScript(domainId_t domainId, size_t scriptId, bool shouldDelete = false);
 		void removeScript(string domainName, size_t scriptId, bool shouldDelete = false);
 		void removeScript(string domainName, Script* script, bool shouldDelete = false);
+		void eraseScript(domainId_t domainId, size_t scriptId, bool shouldDelete = false);
 		void eraseScript(string domainName, size_t scriptId, bool shouldDelete = false);
 		void eraseScript(string domainName, Script* script, bool shouldDelete = false);
+		void clearDomain(domainId_t domainId);
 		void clearDomain(string domainName);
 		void clear();
+		void callDomain(domainId_t domainId, Behavior* behavior = nullptr, bool logUpdate = false);
 		void callDomain(string domainName, Behavior* behavior = nullptr, bool logUpdate = false);
 		void callScript(string domainName, size_t scriptId, Behavior* behavior = nullptr);
+		void callDomainWithData(domainId_t domainId, Behavior* behavior = nullptr, DataMap input = DataMap(), bool logUpdate = false);
 		void callDomainWithData(string domainName, Behavior* behavior = nullptr, DataMap input = DataMap(), bool logUpdate = false);
 		void callScriptWithData(string domainName, size_t scriptId, Behavior* behavior = nullptr, DataMap input = DataMap());
+		//Call the domain with a typed event that its Scripts read through ScArgs::getEvent, without copying it or allocating
+		void callDomainWithEvent(domainId_t domainId, const ScriptPayload& payload, Behavior* behavior = nullptr);
+		void callDomainWithEvent(const string& domainName, const ScriptPayload& payload, Behavior* behavior = nullptr);
+		template<typename E>
+		void callDomainWithEvent(domainId_t domainId, const E& event, Behavior* behavior = nullptr) {
+			callDomainWithEvent(domainId, ScriptPayload::of(event), behavior);
+		}
+		template<typename E>
+		void callDomainWithEvent(const string& domainName, const E& event, Behavior* behavior = nullptr) {
+			callDomainWithEvent(domainName, ScriptPayload::of(event), behavior);
+		}
+		void deleteDomain(domainId_t domainId);
 		void deleteDomain(string domainName);
+		//Return whether every script in the domain is thread-safe or declares its access, adding any declared Bodies to reads and writes
+		bool getDomainAccess(domainId_t domainId, vector<Body*>& reads, vector<Body*>& writes);
+		bool getDomainAccess(const string& domainName, vector<Body*>& reads, vector<Body*>& writes);
 	private:
 		friend class Body;
 		friend class Behavior;
 		Body* owner = nullptr;
 		string ownerName = "";
-		map<string, ScriptDomain*> domains;
+		//Domains by interned id. Ids without a domain in this map are null.
+		vector<ScriptDomain*> domains;
+		//Domains with at least one script, which the owner is subscribed to in the World
+		set<domainId_t> subscribedDomains;
+		//Subscribe or unsubscribe the owner when the domain gains its first script or loses its last
+		void updateSubscription(domainId_t domainId);
 		void initialize();
-		ScriptDomain* addDomain(string domainName);
-		ScriptDomain* getDomain(string domainName);
+		ScriptDomain* addDomain(domainId_t domainId);
+		ScriptDomain* getDomain(domainId_t domainId);
+		ScriptDomain* getDomain(const string& domainName);
 		void deleteDomains();
 		void deleteDomain(ScriptDomain* domain);
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,270 @@
+#include "ScriptProfiler.h"
+#include "../Engine/Engine.h"
+#include <bit>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CGENGINE_HAS_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CGENGINE_HAS_TSC
+#endif
+
+namespace CGEngine {
+	namespace {
+		//Timestamp ticks are bucketed by bit width, then converted to the microsecond buckets when results are read
+		constexpr size_t tickBuckets = 48;
+
+		struct ProfileKey {
+			uint64_t domain = 0;
+			size_t scriptId = 0;
+			const Body* caller = nullptr;
+			const Behavior* behavior = nullptr;
+			bool operator==(const ProfileKey& other) const {
+				return domain == other.domain && scriptId == other.scriptId && caller == other.caller && behavior == other.behavior;
+			}
+		};
+
+		struct ProfileKeyHash {
+			size_t operator()(const ProfileKey& key) const {
+				size_t hash = std::hash<uint64_t>()(key.domain);
+				hash = hash * 31 + key.scriptId;
+				hash = hash * 31 + std::hash<const void*>()(key.caller);
+				return hash * 31 + std::hash<const void*>()(key.behavior);
+			}
+		};
+
+		//Only the owning thread writes the counters, so they're updated with relaxed loads and stores rather than locked or read-modify-write
+		//operations. Results read while a call is being recorded may miss that call.
+		struct ProfileStats {
+			string bodyName;
+			string behaviorName;
+			string domainName;
+			optional<size_t> scriptId;
+			//The reset generation the counters were recorded in. Counters of an earlier generation are cleared by the next call.
+			atomic<uint64_t> generation = 0;
+			atomic<uint64_t> callCount = 0;
+			atomic<uint64_t> totalTicks = 0;
+			atomic<uint64_t> minTicks = UINT64_MAX;
+			atomic<uint64_t> maxTicks = 0;
+			array<atomic<uint64_t>, tickBuckets> histogram = {};
+		};
+
+		//A thread's own profile. The index is only used by its thread, and the lock is only taken to add stats or to read them, so recording
+		//a call that was recorded before takes no lock.
+		struct ThreadProfile {
+			mutex lock;
+			unordered_map<ProfileKey, size_t, ProfileKeyHash> index;
+			//A deque so stats keep their address as more are added
+			deque<ProfileStats> stats;
+		};
+
+		struct ProfileRegistry {
+			mutex lock;
+			vector<unique_ptr<ThreadProfile>> threads;
+			//Incremented by reset, which discards every thread's counters without touching them
+			atomic<uint64_t> generation = 0;
+			uint64_t epochTicks = 0;
+			chrono::steady_clock::time_point epochTime;
+		};
+
+		ProfileRegistry& getRegistry() {
+			static ProfileRegistry registry;
+			return registry;
+		}
+
+		ThreadProfile& getThreadProfile() {
+			thread_local ThreadProfile* profile = nullptr;
+			if (profile == nullptr) {
+				ProfileRegistry& registry = getRegistry();
+				lock_guard<mutex> guard(registry.lock);
+				registry.threads.push_back(make_unique<ThreadProfile>());
+				profile = registry.threads.back().get();
+			}
+			return *profile;
+		}
+
+		//Return the timestamp ticks per microsecond, measured since the profiler was first enabled
+		double getTicksPerMicrosecond() {
+			ProfileRegistry& registry = getRegistry();
+			uint64_t epochTicks;
+			chrono::steady_clock::time_point epochTime;
+			{
+				lock_guard<mutex> guard(registry.lock);
+				if (registry.epochTicks == 0) {
+					registry.epochTicks = ScriptProfiler::readTimestamp();
+					registry.epochTime = chrono::steady_clock::now();
+				}
+				epochTicks = registry.epochTicks;
+				epochTime = registry.epochTime;
+			}
+			//Measure over at least a few milliseconds so the rate is accurate
+			if (chrono::steady_clock::now() - epochTime < chrono::milliseconds(5)) {
+				this_thread::sleep_for(chrono::milliseconds(5));
+			}
+			double elapsedUs = chrono::duration<double, micro>(chrono::steady_clock::now() - epochTime).count();
+			return (ScriptProfiler::readTimestamp() - epochTicks) / elapsedUs;
+		}
+
+		string joinNames(const ScriptProfileEntry& entry) {
+			string name = entry.bodyName;
+			if (entry.behaviorName != "") name += "/" + entry.behaviorName;
+			name += "." + entry.domainName;
+			if (entry.scriptId.has_value()) name += "[" + to_string(entry.scriptId.value()) + "]";
+			return name;
+		}
+	}
+
+	void ScriptProfiler::setEnabled(bool enable) {
+		if (enable) {
+			ProfileRegistry& registry = getRegistry();
+			lock_guard<mutex> guard(registry.lock);
+			if (registry.epochTicks == 0) {
+				registry.epochTicks = readTimestamp();
+				registry.epochTime = chrono::steady_clock::now();
+			}
+		}
+		enabled.store(enable, memory_order_relaxed);
+	}
+
+	void ScriptProfiler::reset() {
+		//Slots are kept rather than removed, since calls in progress hold their slot
+		getRegistry().generation.fetch_add(1, memory_order_relaxed);
+	}
+
+	size_t ScriptProfiler::beginRecord(const ScriptDomain* domain, optional<size_t> scriptId, Body* caller, Behavior* behavior) {
+		ThreadProfile& profile = getThreadProfile();
+		ProfileKey key{ domain->getInstanceId(), scriptId.value_or(SIZE_MAX), caller, behavior };
+		auto found = profile.index.find(key);
+		if (found != profile.index.end()) return found->second;
+		//Names are resolved once, the first time the call is recorded
+		lock_guard<mutex> guard(profile.lock);
+		ProfileStats& stats = profile.stats.emplace_back();
+		stats.bodyName = caller != nullptr ? caller->getName() : "";
+		stats.behaviorName = behavior != nullptr ? behavior->getName() : "";
+		stats.domainName = DomainRegistry::getName(domain->getId());
+		stats.scriptId = scriptId;
+		stats.generation.store(getRegistry().generation.load(memory_order_relaxed), memory_order_relaxed);
+		profile.index.emplace(key, profile.stats.size() - 1);
+		return profile.stats.size() - 1;
+	}
+
+	void ScriptProfiler::endRecord(size_t slot, uint64_t ticks) {
+		ProfileStats& stats = getThreadProfile().stats[slot];
+		uint64_t generation = getRegistry().generation.load(memory_order_relaxed);
+		if (stats.generation.load(memory_order_relaxed) != generation) {
+			stats.callCount.store(0, memory_order_relaxed);
+			stats.totalTicks.store(0, memory_order_relaxed);
+			stats.minTicks.store(UINT64_MAX, memory_order_relaxed);
+			stats.maxTicks.store(0, memory_order_relaxed);
+			for (atomic<uint64_t>& bucket : stats.histogram) {
+				bucket.store(0, memory_order_relaxed);
+			}
+			stats.generation.store(generation, memory_order_relaxed);
+		}
+		stats.callCount.store(stats.callCount.load(memory_order_relaxed) + 1, memory_order_relaxed);
+		stats.totalTicks.store(stats.totalTicks.load(memory_order_relaxed) + ticks, memory_order_relaxed);
+		stats.minTicks.store(min(stats.minTicks.load(memory_order_relaxed), ticks), memory_order_relaxed);
+		stats.maxTicks.store(max(stats.maxTicks.load(memory_order_relaxed), ticks), memory_order_relaxed);
+		atomic<uint64_t>& bucket = stats.histogram[min((size_t)bit_width(ticks), tickBuckets - 1)];
+		bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+	}
+
+	vector<ScriptProfileEntry> ScriptProfiler::getResults() {
+		double ticksPerUs = getTicksPerMicrosecond();
+		//Merge the threads' stats of the same Body, Behavior, domain and Script
+		map<tuple<string, string, string, size_t>, ScriptProfileEntry> merged;
+		map<tuple<string, string, string, size_t>, uint64_t> minTicks;
+		ProfileRegistry& registry = getRegistry();
+		lock_guard<mutex> guard(registry.lock);
+		uint64_t generation = registry.generation.load(memory_order_relaxed);
+		for (unique_ptr<ThreadProfile>& thread : registry.threads) {
+			lock_guard<mutex> threadGuard(thread->lock);
+			for (const ProfileStats& stats : thread->stats) {
+				//Counters of an earlier generation were discarded by a reset
+				if (stats.generation.load(memory_order_relaxed) != generation) continue;
+				uint64_t callCount = stats.callCount.load(memory_order_relaxed);
+				if (callCount == 0) continue;
+				uint64_t statsMinTicks = stats.minTicks.load(memory_order_relaxed);
+				auto key = make_tuple(stats.bodyName, stats.behaviorName, stats.domainName, stats.scriptId.value_or(SIZE_MAX));
+				ScriptProfileEntry& entry = merged[key];
+				if (entry.callCount == 0) {
+					entry.bodyName = stats.bodyName;
+					entry.behaviorName = stats.behaviorName;
+					entry.domainName = stats.domainName;
+					entry.scriptId = stats.scriptId;
+					minTicks[key] = statsMinTicks;
+				}
+				entry.callCount += callCount;
+				entry.totalMs += stats.totalTicks.load(memory_order_relaxed) / ticksPerUs / 1000.0;
+				entry.maxMs = max(entry.maxMs, stats.maxTicks.load(memory_order_relaxed) / ticksPerUs / 1000.0);
+				minTicks[key] = min(minTicks[key], statsMinTicks);
+				entry.minMs = minTicks[key] / ticksPerUs / 1000.0;
+				for (size_t bucket = 0; bucket < tickBuckets; bucket++) {
+					uint64_t calls = stats.histogram[bucket].load(memory_order_relaxed);
+					if (calls == 0) continue;
+					//Place the tick bucket by its lower bound
+					uint64_t lowerTicks = bucket == 0 ? 0 : 1ull << (bucket - 1);
+					uint64_t microseconds = (uint64_t)(lowerTicks / ticksPerUs);
+					entry.histogram[min((size_t)bit_width(microseconds), profileHistogramBuckets - 1)] += calls;
+				}
+			}
+		}
+
+		vector<ScriptProfileEntry> results;
+		results.reserve(merged.size());
+		for (auto& [key, entry] : merged) {
+			results.push_back(entry);
+		}
+		sort(results.begin(), results.end(), [](const ScriptProfileEntry& a, const ScriptProfileEntry& b) { return a.totalMs > b.totalMs; });
+		return results;
+	}
+
+	string ScriptProfiler::formatResults(size_t count) {
+		vector<ScriptProfileEntry> results = getResults();
+		stringstream table;
+		table << fixed << setprecision(3);
+		table << left << setw(48) << "Body/Behavior.Domain[Script]" << right << setw(10) << "Calls" << setw(12) << "Total ms" << setw(10) << "Avg ms" << setw(10) << "Min ms" << setw(10) << "Max ms" << "\n";
+		for (size_t i = 0; i < results.size() && i < count; i++) {
+			const ScriptProfileEntry& entry = results[i];
+			table << left << setw(48) << joinNames(entry) << right << setw(10) << entry.callCount << setw(12) << entry.totalMs
+				<< setw(10) << entry.totalMs / max(entry.callCount, (size_t)1) << setw(10) << entry.minMs << setw(10) << entry.maxMs << "\n";
+		}
+		return table.str();
+	}
+
+	bool ScriptProfiler::exportCsv(const filesystem::path& path) {
+		ofstream file(path, ios::trunc);
+		if (!file) return false;
+		file << "body,behavior,domain,script,calls,totalMs,avgMs,minMs,maxMs";
+		for (size_t bucket = 0; bucket < profileHistogramBuckets; bucket++) {
+			if (bucket == profileHistogramBuckets - 1) {
+				file << ",ge" << (1ull << (bucket - 1)) << "us";
+			} else {
+				file << ",lt" << (1ull << bucket) << "us";
+			}
+		}
+		file << "\n";
+		for (const ScriptProfileEntry& entry : getResults()) {
+			file << entry.bodyName << "," << entry.behaviorName << "," << entry.domainName << "," << (entry.scriptId.has_value() ? to_string(entry.scriptId.value()) : "")
+				<< "," << entry.callCount << "," << entry.totalMs << "," << entry.totalMs / max(entry.callCount, (size_t)1) << "," << entry.minMs << "," << entry.maxMs;
+			for (size_t calls : entry.histogram) {
+				file << "," << calls;
+			}
+			file << "\n";
+		}
+		return (bool)file;
+	}
+
+	uint64_t ScriptProfiler::readTimestamp() {
+#ifdef CGENGINE_HAS_TSC
+		return __rdtsc();
+#else
+		return (uint64_t)chrono::steady_clock::now().time_since_epoch().count();
+#endif
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../Types/Types.h"
+using namespace std;
+
+//The profiler is compiled in when CGENGINE_PROFILE_SCRIPTS is defined (configure with -DPROFILE_SCRIPTS=ON). Otherwise the profiling
+//macros expand to nothing, so domain and script calls carry no profiling cost at all.
+#ifdef CGENGINE_PROFILE_SCRIPTS
+#define PROFILE_DOMAIN_CALL(domain, caller, behavior) ScriptProfiler::Scope domainProfileScope(domain, nullopt, caller, behavior)
+#define PROFILE_SCRIPT_CALL(domain, scriptId, caller, behavior) ScriptProfiler::Scope scriptProfileScope(domain, scriptId, caller, behavior)
+#else
+#define PROFILE_DOMAIN_CALL(domain, caller, behavior)
+#define PROFILE_SCRIPT_CALL(domain, scriptId, caller, behavior)
+#endif
+
+namespace CGEngine {
+	class Body;
+	class Behavior;
+	class ScriptDomain;
+
+	//Number of histogram buckets. Bucket 0 counts calls under 1 microsecond, bucket i calls from 2^(i-1) up to 2^i microseconds,
+	//and the last bucket every longer call.
+	constexpr size_t profileHistogramBuckets = 16;
+
+	/// <summary>
+	/// The profile of a domain (when scriptId is empty) or of one of its Scripts, called by a Body and Behavior
+	/// </summary>
+	struct ScriptProfileEntry {
+		string bodyName = "";
+		string behaviorName = "";
+		string domainName = "";
+		optional<size_t> scriptId = nullopt;
+		size_t callCount = 0;
+		double totalMs = 0;
+		double minMs = 0;
+		double maxMs = 0;
+		array<size_t, profileHistogramBuckets> histogram = {};
+	};
+
+	/// <summary>
+	/// Records the call count, total, minimum and maximum time and a duration histogram of each domain call and Script call, per Body and
+	/// Behavior. Calls are timed with the CPU timestamp counter and accumulated in the calling thread's own table without locking, and the
+	/// tables are merged when results are read. Domains are told apart by their instance id, so a deleted domain's address being reused
+	/// doesn't mix their calls. Recording is off until enabled, and a disabled profiler costs one flag check per call. Safe to call from any thread.
+	/// </summary>
+	class ScriptProfiler {
+	public:
+		static void setEnabled(bool enabled);
+		static bool isEnabled() { return enabled.load(memory_order_relaxed); }
+		/// <summary>
+		/// Return whether the profiler was compiled in. If not, nothing is ever recorded.
+		/// </summary>
+		static constexpr bool isCompiledIn() {
+#ifdef CGENGINE_PROFILE_SCRIPTS
+			return true;
+#else
+			return false;
+#endif
+		}
+		/// <summary>
+		/// Discard everything recorded so far
+		/// </summary>
+		static void reset();
+		/// <summary>
+		/// Return the merged profile of every thread, sorted by total time, longest first
+		/// </summary>
+		static vector<ScriptProfileEntry> getResults();
+		/// <summary>
+		/// Return a table of the entries with the longest total time
+		/// </summary>
+		/// <param name="count">The number of entries to include</param>
+		static string formatResults(size_t count = 20);
+		/// <summary>
+		/// Write the results to a CSV file with a row per entry
+		/// </summary>
+		/// <returns>False if the file couldn't be written</returns>
+		static bool exportCsv(const filesystem::path& path);
+		/// <summary>
+		/// Return the calling thread's slot for calls of the domain or Script, resolving their names the first time
+		/// </summary>
+		static size_t beginRecord(const ScriptDomain* domain, optional<size_t> scriptId, Body* caller, Behavior* behavior);
+		/// <summary>
+		/// Record a call's duration in timestamp ticks to the calling thread's slot
+		/// </summary>
+		static void endRecord(size_t slot, uint64_t ticks);
+		/// <summary>
+		/// Return the CPU timestamp counter, or a steady clock where there is none
+		/// </summary>
+		static uint64_t readTimestamp();
+
+		//Times a call from its construction to its destruction, if the profiler was enabled when it was constructed
+		class Scope {
+		public:
+			//The slot is found before the call, since the call may delete the domain, the caller or the Behavior
+			Scope(const ScriptDomain* domain, optional<size_t> scriptId, Body* caller, Behavior* behavior) {
+				if (isEnabled()) {
+					slot = beginRecord(domain, scriptId, caller, behavior);
+					start = readTimestamp();
+				}
+			}
+			~Scope() {
+				if (start != 0) endRecord(slot, readTimestamp() - start);
+			}
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		private:
+			size_t slot = 0;
+			uint64_t start = 0;
+		};
+	private:
+		inline static atomic<bool> enabled = false;
+	};
+}
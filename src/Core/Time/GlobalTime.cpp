@@ -1,11 +1,23 @@
 #include "GlobalTime.h"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 
 namespace CGEngine {
 	sec_t GlobalTime::getElapsedSec() {
-		return runningClock.getElapsedTime().asSeconds();
+		if (isSimulated()) {
+			return simulatedElapsedSec;
+		}
+		if (elapsedPerFrame) {
+			return currentFrameSec;
+		}
+		return getRunningElapsedSec();
+	}
+
+	sec_t GlobalTime::getRunningElapsedSec() const {
+		return runningClock.getElapsedTime().asSeconds() + runningClockOffsetSec;
 	}
 
 	sec_t GlobalTime::getLastFrameSec() {
@@ -13,13 +25,24 @@ namespace CGEngine {
 	}
 
 	sec_t GlobalTime::getDeltaSec() const {
-		return deltaSec;
+		return inFixedStep ? fixedStepSec : deltaSec;
 	}
 
 	void GlobalTime::updateDeltaTime() {
 		lastFrameSec = currentFrameSec;
-		currentFrameSec = getElapsedSec();
-		deltaSec = frameClock.restart().asSeconds();
+		if (isSimulated()) {
+			deltaSec = deltaLocked ? lockedDeltaSec : simulatedStepSec;
+			if (deltaLocked && lockedElapsedSec.has_value()) {
+				simulatedElapsedSec = lockedElapsedSec.value();
+			} else {
+				simulatedElapsedSec += deltaSec;
+			}
+			frameClock.restart();
+			currentFrameSec = simulatedElapsedSec;
+		} else {
+			deltaSec = frameClock.restart().asSeconds();
+			currentFrameSec = getRunningElapsedSec();
+		}
 		if (logFPS) {
 			if (frame++ % 60 == 0) {
 				string FPSStr;
@@ -68,4 +91,120 @@ namespace CGEngine {
 	void GlobalTime::stopLoggingFPS() {
 		logFPS = false;
 	}
+
+	void GlobalTime::setSimulatedStep(sec_t stepSec) {
+		//Continue from the current elapsed time so timers don't jump
+		bool wasSimulated = isSimulated();
+		if (!wasSimulated && stepSec > 0) {
+			simulatedElapsedSec = getElapsedSec();
+		}
+		simulatedStepSec = max(stepSec, 0.f);
+		if (wasSimulated && !isSimulated()) {
+			runningClockOffsetSec = simulatedElapsedSec - runningClock.getElapsedTime().asSeconds();
+		}
+	}
+
+	void GlobalTime::lockNextDelta(sec_t deltaSec, optional<sec_t> elapsedSec) {
+		if (!isSimulated()) {
+			simulatedElapsedSec = getElapsedSec();
+		}
+		deltaLocked = true;
+		lockedDeltaSec = max(deltaSec, 0.f);
+		lockedElapsedSec = elapsedSec;
+	}
+
+	void GlobalTime::unlockDelta() {
+		if (!deltaLocked) return;
+		deltaLocked = false;
+		lockedElapsedSec = nullopt;
+		if (!isSimulated()) {
+			runningClockOffsetSec = simulatedElapsedSec - runningClock.getElapsedTime().asSeconds();
+		}
+	}
+
+	void GlobalTime::setElapsedPerFrame(bool enabled) {
+		elapsedPerFrame = enabled;
+	}
+
+	bool GlobalTime::isSimulated() const {
+		return deltaLocked || simulatedStepSec > 0;
+	}
+
+	sec_t GlobalTime::getSimulatedStep() const {
+		return simulatedStepSec;
+	}
+
+	void GlobalTime::setFixedStep(sec_t stepSec) {
+		fixedStepSec = max(stepSec, 0.0001f);
+	}
+
+	sec_t GlobalTime::getFixedStep() const {
+		return fixedStepSec;
+	}
+
+	void GlobalTime::setMaxCatchUpSteps(size_t steps) {
+		maxCatchUpSteps = max(steps, (size_t)1);
+	}
+
+	size_t GlobalTime::getMaxCatchUpSteps() const {
+		return maxCatchUpSteps;
+	}
+
+	size_t GlobalTime::accumulateFixedSteps() {
+		accumulatorSec += deltaSec;
+		size_t steps = (size_t)(accumulatorSec / fixedStepSec);
+		if (steps > maxCatchUpSteps) {
+			//Drop the time that can't be caught up on, keeping the partial step for interpolation
+			steps = maxCatchUpSteps;
+			accumulatorSec = fmod(accumulatorSec, fixedStepSec);
+			droppedFrames++;
+		} else {
+			accumulatorSec -= steps * fixedStepSec;
+		}
+		if (steps > 1) {
+			catchUpEvents++;
+		}
+
+		rateWindowSec += deltaSec;
+		rateWindowSteps += steps;
+		if (rateWindowSec >= 1.f) {
+			fixedStepRate = rateWindowSteps / rateWindowSec;
+			rateWindowSec = 0.f;
+			rateWindowSteps = 0;
+		}
+		return steps;
+	}
+
+	void GlobalTime::beginFixedStep() {
+		fixedStepCount++;
+		inFixedStep = true;
+	}
+
+	void GlobalTime::endFixedStep() {
+		inFixedStep = false;
+	}
+
+	bool GlobalTime::isInFixedStep() const {
+		return inFixedStep;
+	}
+
+	float GlobalTime::getInterpolationAlpha() const {
+		return clamp(accumulatorSec / fixedStepSec, 0.f, 1.f);
+	}
+
+	size_t GlobalTime::getFixedStepCount() const {
+		return fixedStepCount;
+	}
+
+	size_t GlobalTime::getCatchUpEventCount() const {
+		return catchUpEvents;
+	}
+
+	size_t GlobalTime::getDroppedFrameCount() const {
+		return droppedFrames;
+	}
+
+	float GlobalTime::getFixedStepRate() const {
+		return fixedStepRate;
+	}
 }
\ No newline at end of file
@@ -18,6 +18,40 @@ namespace CGEngine {
 		string getSystemmTimeNowString(string delimiter = "_");
 		void startLoggingFPS();
 		void stopLoggingFPS();
+		//Advance time by a fixed simulated step each frame instead of the measured frame time. A step of 0 returns to real time.
+		void setSimulatedStep(sec_t stepSec);
+		sec_t getSimulatedStep() const;
+		//Advance time by exactly deltaSec on the next frame, setting its elapsed time to elapsedSec if given. Used to replay recorded frame times.
+		void lockNextDelta(sec_t deltaSec, optional<sec_t> elapsedSec = nullopt);
+		//Return to the simulated step or real time after replaying frame times
+		void unlockDelta();
+		//If enabled, getElapsedSec returns the time sampled at the start of the frame rather than reading the running clock, so every read
+		//in a frame sees the same time. Enabled while recording input, since replays lock each frame's elapsed time.
+		void setElapsedPerFrame(bool enabled);
+
+		//Fixed Timestep
+		void setFixedStep(sec_t stepSec);
+		sec_t getFixedStep() const;
+		void setMaxCatchUpSteps(size_t steps);
+		size_t getMaxCatchUpSteps() const;
+		//Add the last frame's delta to the accumulator and return the number of fixed steps to run this frame. Time beyond the max catch-up steps is dropped.
+		size_t accumulateFixedSteps();
+		//Count a fixed step as started. Until endFixedStep, getDeltaSec returns the fixed step so fixed update scripts advance by it.
+		void beginFixedStep();
+		//Return getDeltaSec to the frame delta after running the fixed steps
+		void endFixedStep();
+		//Return whether a fixed step is running
+		bool isInFixedStep() const;
+		//Return how far the accumulator is between the last fixed step and the next, from 0 to 1
+		float getInterpolationAlpha() const;
+		//Return the number of fixed steps run since the start
+		size_t getFixedStepCount() const;
+		//Return the number of frames that ran more than one fixed step to catch up
+		size_t getCatchUpEventCount() const;
+		//Return the number of frames that dropped simulation time after hitting the max catch-up steps
+		size_t getDroppedFrameCount() const;
+		//Return the fixed steps run per second, measured over the last second
+		float getFixedStepRate() const;
 	private:
 		Clock runningClock;
 		Clock frameClock;
@@ -26,5 +60,27 @@ namespace CGEngine {
 		sec_t lastFrameSec = 0.0f;
 		size_t frame = 0;
 		bool logFPS = false;
+		sec_t simulatedStepSec = 0.f;
+		sec_t simulatedElapsedSec = 0.f;
+		sec_t runningClockOffsetSec = 0.f;
+		bool deltaLocked = false;
+		sec_t lockedDeltaSec = 0.f;
+		optional<sec_t> lockedElapsedSec = nullopt;
+		bool elapsedPerFrame = false;
+		//Return the elapsed real time, read from the running clock
+		sec_t getRunningElapsedSec() const;
+		//Return whether elapsed time is advanced by simulated steps rather than the running clock
+		bool isSimulated() const;
+
+		sec_t fixedStepSec = 1.f / 60.f;
+		size_t maxCatchUpSteps = 5;
+		sec_t accumulatorSec = 0.f;
+		size_t fixedStepCount = 0;
+		bool inFixedStep = false;
+		size_t catchUpEvents = 0;
+		size_t droppedFrames = 0;
+		sec_t rateWindowSec = 0.f;
+		size_t rateWindowSteps = 0;
+		float fixedStepRate = 0.f;
 	};
 }
\ No newline at end of file
@@ -1,17 +1,45 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
+#include <string>
+#include "../Types/Types.h"
 using namespace std;
 
 namespace CGEngine {
+	class Body;
+	class Script;
+	class TimerMap;
+
 	class Timer {
 	public:
 		Timer(string n = "") {
 			name = n;
-			eventId = 0U;
 		}
 		optional<size_t> id = nullopt;
-		size_t eventId = 0U;
 		string name = "";
+		//The world time the timer expires at
+		sec_t expiration = 0;
+		//The duration of each loop after the first
+		sec_t loopDuration = 0;
+		//The remaining loop count (0 or 1 is a single run, < 0 loops forever)
+		int loopCount = 0;
+		//The name of the registered ScriptEvent called on completion, if the timer can be saved in a SceneSnapshot
+		string eventName = "";
+		//The Body the timer is set on, and the TimerMap that owns it
+		Body* body = nullptr;
+		TimerMap* owner = nullptr;
+		//The Script called on completion, owned by the timer
+		Script* onComplete = nullptr;
+	private:
+		friend class TimerWheel;
+		//The TimerWheel slot list the timer is linked into, if it is scheduled
+		Timer** wheelSlot = nullptr;
+		Timer* wheelPrev = nullptr;
+		Timer* wheelNext = nullptr;
+		//The wheel tick the timer fires on
+		uint64_t wheelTick = 0;
+		//Whether the timer is collected to fire in the wheel's current tick
+		bool wheelFiring = false;
 	};
-}
\ No newline at end of file
+}
@@ -6,101 +6,107 @@ namespace CGEngine {
         init();
     }
 
-    timerId_t TimerMap::setTimer(Body* body, sec_t duration, Script* onCompleteEvent, int loopCount, string timerDisplayName) {
+    timerId_t TimerMap::setTimer(Body* body, sec_t duration, Script* onCompleteEvent, int loopCount, string timerDisplayName, sec_t loopPeriod) {
         if (body == nullptr) return nullopt;
         if (duration <= 0) {
             log(this, LogLevel::LogWarn, "Timer not set. Duration must be > 0 but it was {}", duration);
             return nullopt;
         }
 
-        //Get world time
-        sec_t expiration = time.getElapsedSec() + duration;
         //Create new timer
         Timer* timer = new Timer(timerDisplayName);
         //Take a unique id for the timer and assign it to the timer
         id_t id = timers.add(timer);
         timer->id = id;
         log(this, LogInfo, "'{}'[{}] SET({} sec)", timer->name, id, duration);
-        //Get the timer domain name by its timer id
-        string timerDomain = "timer" + to_string(id);
-        //Add the onComplete event to the body's timer domain by timer id
-        id_t onCompleteEventId = body->addScript(timerDomain, onCompleteEvent);
+        timer->body = body;
+        timer->owner = this;
+        timer->onComplete = onCompleteEvent;
+        //Expire at the world time after the duration
+        timer->expiration = time->getElapsedSec() + duration;
         //Loop duration is used to check if this timer should loop as well as for setting the next loop duration
-        sec_t loopDuration = loopCount != 0 ? duration : 0;
-        //Add th timer update script to this body's update scripts
-        timer->eventId = body->addUpdateScript(new Script([this, id, expiration, loopDuration, loopCount, onCompleteEvent](ScArgs args) {
-            //OnUpdate: Check if the world time >= expiration time
-            if (time.getElapsedSec() >= expiration) {
-                log(this, LogInfo, "'{}'[{}] DONE", timers.get(id)->name, id);
-                //Get the timer domain name by its timer id
-                string timerDomainById = "timer" + to_string(id);
-                string timerName = timers.get(id)->name;
-                //Call all the scripts with this timer's domain by its id
-                args.caller->callScripts(timerDomainById);
-                if ((loopCount == 0 || loopCount == 1) || loopDuration <= 0) {
-                    //If not looping, delete the domain and its scripts
-                    args.caller->deleteDomain(timerDomainById);
-                }
-                else {
-                    //If looping, clear the domain without deleting the scripts
-                    args.caller->clearDomain(timerDomainById);
-                }
-                //Delete the timer
-                size_t updateEventId = timers.get(id)->eventId;
-                deleteTimer(id);
-                //Start the next loop, if looping
-                if ((loopCount < 0 || loopCount > 1) && loopDuration > 0) {
-                    setTimer(args.caller, loopDuration, onCompleteEvent, loopCount > 0 ? loopCount - 1 : loopCount, timerName);
-                }
-                //Delete this timer's update script
-                args.caller->eraseUpdateScript(updateEventId, false);
-            }
-        }));
+        timer->loopDuration = loopCount != 0 ? (loopPeriod > 0 ? loopPeriod : duration) : 0;
+        timer->loopCount = loopCount;
+        if (JobSystem::isInJob()) {
+            //The wheel is only changed on the main thread
+            world->defer([timer]() { world->getTimerWheel().schedule(timer); });
+        } else {
+            world->getTimerWheel().schedule(timer);
+        }
         log(this, LogInfo, "'{}'[{}] START({} sec)", timer->name, id, duration);
         return id;
     }
 
-    void TimerMap::cancelTimer(Body* body, size_t timerId) {
+    void TimerMap::fire(Timer* timer) {
+        //Destroyed Bodies' timers are deleted with them at the end of the frame
+        if (timer->body->isDestroyed()) return;
+        size_t id = timer->id.value();
+        log(this, LogInfo, "'{}'[{}] DONE", timer->name, id);
+        //If the Script cancelled its own timer or deleted its Body, the wheel has deleted the timer, and this TimerMap may be gone with the Body
+        if (!world->getTimerWheel().call(timer)) return;
+        if ((timer->loopCount < 0 || timer->loopCount > 1) && timer->loopDuration > 0) {
+            //Schedule the next loop from this loop's expiration. If that has passed too, the wheel fires it again this frame to catch up.
+            if (timer->loopCount > 0) timer->loopCount--;
+            timer->expiration += timer->loopDuration;
+            world->getTimerWheel().schedule(timer);
+            log(this, LogInfo, "'{}'[{}] START({} sec)", timer->name, id, timer->loopDuration);
+        } else {
+            deleteTimer(id);
+        }
+    }
+
+    void TimerMap::cancelTimer(size_t timerId) {
         Timer* timer = timers.get(timerId);
+        if (timer == nullptr) return;
         log(this, LogInfo, "'{}'[{}] STOP", timer->name, timerId);
-        //Delete the domain for the timer id
-        body->deleteDomain("timer" + to_string(timerId));
-        //Remove this timer's update script
-        body->eraseUpdateScript(timer->eventId);
-        //Refund the timer id, delete the timer and erase it from the timer map
+        //Refund the timer id, erase it from the timer map and delete it
         timers.remove(timerId);
-        delete timer;
+        release(timer);
     }
 
-    void TimerMap::cancelTimer(Body* body, timerId_t* timerId) {
+    void TimerMap::cancelTimer(timerId_t* timerId) {
         if (timerId->has_value()) {
-            id_t id = timerId->value();
-            Timer* timer = timers.get(id);
-            log(this, LogInfo, "'{}'[{}] STOP", timer->name, id);
-            //Delete the domain for the timer id
-            body->deleteDomain("timer" + to_string(id));
-            //Remove this timer's update script
-            body->eraseUpdateScript(timer->eventId);
-            //Refund the timer id, delete the timer and erase it from the timer map and set the timerId optional to nullopt
-            timers.remove(id);
-            delete timer;
+            cancelTimer(timerId->value());
             *timerId = nullopt;
         }
     }
 
-    void TimerMap::deleteTimers(Body* body) {
-        timers.forEach([this, &body](Timer* timer) {
-            delete timer;
+    void TimerMap::deleteTimers() {
+        timers.forEach([this](Timer* timer) {
+            release(timer);
         });
+        timers.clear();
     }
 
     void TimerMap::deleteTimer(size_t timerId) {
         Timer* timer = timers.get(timerId);
         timers.remove(timerId);
+        release(timer);
+    }
+
+    void TimerMap::release(Timer* timer) {
+        if (JobSystem::isInJob()) {
+            world->defer([timer]() { release(timer); });
+            return;
+        }
+        if (world->getTimerWheel().release(timer)) return;
+        delete timer->onComplete;
         delete timer;
     }
 
     void TimerMap::clear() {
         timers.clear();
     }
-}
\ No newline at end of file
+
+    Timer* TimerMap::getTimer(size_t timerId) {
+        return timers.get(timerId);
+    }
+
+    void TimerMap::forEach(function<void(Timer*)> function) {
+        timers.forEach(function);
+    }
+
+    size_t TimerMap::getTimerCount() {
+        return timers.size();
+    }
+}
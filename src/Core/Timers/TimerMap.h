@@ -14,48 +14,79 @@ namespace CGEngine {
 	class Body;
 	class Script;
 
+	/// <summary>
+	/// The timers set on a Body. The timers are scheduled in the World's TimerWheel, which calls their onComplete Script when they expire,
+	/// so a pending timer costs nothing per frame. Timers set from parallel update jobs are scheduled once the jobs finish.
+	/// </summary>
 	class TimerMap : public EngineSystem {
 	public:
 		TimerMap();
 		/// <summary>
 		/// Set a timer on the indicated body for the duration, calling the onCompleteEvent when the duration expires and resetting
-		/// the timer up to loopCount timers when it is completed
+		/// the timer up to loopCount timers when it is completed. Each loop expires loopDuration after the last expiration, rather than after
+		/// the frame it fired in, so loops don't drift.
 		/// </summary>
 		/// <param name="body">The body to set the timer on and the body passed to the Script when the timer expires</param>
 		/// <param name="duration">The time before the timer expires</param>
-		/// <param name="onCompleteScript">The Script to be called when the timer expires</param>
+		/// <param name="onCompleteScript">The Script to be called when the timer expires. The timer takes ownership of it.</param>
 		/// <param name="loopCount">The number of times to reset the timer</param>
 		/// <param name="timerDisplayName">The printed display name of the timer</param>
+		/// <param name="loopDuration">The duration of each loop after the first. If 0, duration is used.</param>
 		/// <returns></returns>
-		timerId_t setTimer(Body* body, sec_t duration, Script* onCompleteScript, int loopCount = 0, string timerDisplayName = "");
+		timerId_t setTimer(Body* body, sec_t duration, Script* onCompleteScript, int loopCount = 0, string timerDisplayName = "", sec_t loopDuration = 0);
 		/// <summary>
-		/// Cancel the timer with the indicated timer id on the Body
+		/// Cancel the timer with the indicated timer id
 		/// </summary>
-		/// <param name="body">The Body to cancel the timer on</param>
 		/// <param name="timerId">The id of the timer to cancel</param>
-		void cancelTimer(Body* body, size_t timerId);
+		void cancelTimer(size_t timerId);
 		/// <summary>
-		/// Cancel the timer with the indicated timer id on the Body
+		/// Cancel the timer with the indicated timer id and clear the id
 		/// </summary>
-		/// <param name="body">The Body to cancel the timer on</param>
 		/// <param name="timerId">The id of the timer to cancel</param>
-		void cancelTimer(Body* body, timerId_t* timerId);
+		void cancelTimer(timerId_t* timerId);
 		/// <summary>
-		/// Delete all timers on the Body (but doesn't erase them from the TimerMap)
+		/// Delete all timers and erase them from the TimerMap
 		/// </summary>
-		/// <param name="body">The Body to delete the timers on</param>
-		void deleteTimers(Body* body);
+		void deleteTimers();
 		/// <summary>
 		/// Clear all timer entries (but doesn't delete them)
 		/// </summary>
 		void clear();
+		/// <summary>
+		/// Return the timer with the indicated id
+		/// </summary>
+		/// <param name="timerId">The id of the timer</param>
+		/// <returns>The timer, or nullptr if there is no timer with the id</returns>
+		Timer* getTimer(size_t timerId);
+		/// <summary>
+		/// Call the function on each active timer
+		/// </summary>
+		/// <param name="function">The function to call with each timer</param>
+		void forEach(function<void(Timer*)> function);
+		/// <summary>
+		/// Return the number of active timers
+		/// </summary>
+		/// <returns>The number of timers</returns>
+		size_t getTimerCount();
 	private:
+		friend class TimerWheel;
+		/// <summary>
+		/// Call the expired timer's onComplete Script, then schedule its next loop or delete it. Called by the TimerWheel.
+		/// </summary>
+		/// <param name="timer">The expired timer</param>
+		void fire(Timer* timer);
 		/// <summary>
 		/// Delete the timer with the indicated id and erase it from the TimerMap
 		/// </summary>
 		/// <param name="timerId">The id of the timer to delete</param>
 		void deleteTimer(size_t timerId);
 		/// <summary>
+		/// Unschedule the timer and delete it with its onComplete Script. The timer being fired is deleted by the TimerWheel once its Script
+		/// returns. Deferred until the parallel updates finish when called from a job, since the TimerWheel is only changed on the main thread.
+		/// </summary>
+		/// <param name="timer">The timer to release</param>
+		static void release(Timer* timer);
+		/// <summary>
 		/// A unique id list of timers
 		/// </summary>
 		UniqueDomain<size_t, Timer*> timers = UniqueDomain<size_t, Timer*>(1000U);
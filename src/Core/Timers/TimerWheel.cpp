@@ -0,0 +1,189 @@
+#include "TimerWheel.h"
+#include "../Engine/Engine.h"
+
+namespace CGEngine {
+	TimerWheel::TimerWheel() {
+		init();
+	}
+
+	void TimerWheel::schedule(Timer* timer) {
+		unschedule(timer);
+		//A timer never fires in a tick that has already been fired
+		timer->wheelTick = max(toTick(timer->expiration), currentTick + 1);
+		place(timer);
+		scheduledCount++;
+	}
+
+	void TimerWheel::unschedule(Timer* timer) {
+		if (timer->wheelFiring) {
+			//The timer is waiting to fire in the current tick, so it is skipped instead
+			replace(firing.begin(), firing.end(), timer, (Timer*)nullptr);
+			timer->wheelFiring = false;
+			return;
+		}
+		if (timer->wheelSlot == nullptr) return;
+		unlink(timer);
+		scheduledCount--;
+	}
+
+	void TimerWheel::advance(sec_t now) {
+		uint64_t target = (uint64_t)floor(max((double)now, 0.0) * ticksPerSec) + tickOffset;
+		lastFiredCount = 0;
+		if (target < currentTick) {
+			//The World time went back. Rather than firing timers early, the wheel stays at its tick and the new time is offset to match it.
+			tickOffset += currentTick - target;
+			return;
+		}
+		while (currentTick < target) {
+			//Jump to the next tick with work, and skip the rest if nothing is due by the target
+			uint64_t next = findNextTick();
+			if (next > target) {
+				currentTick = target;
+				break;
+			}
+			currentTick = next;
+			//Higher levels first, since their timers may be placed in the lower level's slot that is reached in the same tick
+			for (size_t level = levelCount - 1; level > 0; level--) {
+				size_t shift = slotBits * level;
+				if ((currentTick & ((1ull << shift) - 1)) == 0) {
+					cascade(level, (currentTick >> shift) & slotMask);
+				}
+			}
+			fireCurrentTick();
+		}
+	}
+
+	uint64_t TimerWheel::findNextTick() const {
+		if (scheduledCount == 0) return UINT64_MAX;
+		uint64_t next = UINT64_MAX;
+		//Level 0 holds the timers of the next slotCount ticks, each in the slot of its tick
+		for (uint64_t tick = currentTick + 1; tick < currentTick + slotCount; tick++) {
+			if (slots[0][tick & slotMask] != nullptr) {
+				next = tick;
+				break;
+			}
+		}
+		//Higher levels' slots are cascaded at the first tick of their span, so the earliest occupied one bounds the next tick
+		for (size_t level = 1; level < levelCount; level++) {
+			size_t shift = slotBits * level;
+			uint64_t first = ((currentTick >> shift) + 1) << shift;
+			for (uint64_t slot = 0; slot < slotCount; slot++) {
+				uint64_t tick = first + (slot << shift);
+				if (tick >= next) break;
+				if (slots[level][(tick >> shift) & slotMask] != nullptr) {
+					next = tick;
+					break;
+				}
+			}
+		}
+		return next;
+	}
+
+	size_t TimerWheel::getScheduledCount() const {
+		return scheduledCount;
+	}
+
+	size_t TimerWheel::getLastFiredCount() const {
+		return lastFiredCount;
+	}
+
+	void TimerWheel::place(Timer* timer) {
+		uint64_t delta = timer->wheelTick - currentTick;
+		for (size_t level = 0; level < levelCount; level++) {
+			size_t shift = slotBits * level;
+			if (delta < (1ull << (shift + slotBits))) {
+				link(slots[level][(timer->wheelTick >> shift) & slotMask], timer);
+				return;
+			}
+		}
+		//Beyond the wheel's span, so wait in the top level slot that is reached last
+		size_t shift = slotBits * (levelCount - 1);
+		link(slots[levelCount - 1][((currentTick >> shift) - 1) & slotMask], timer);
+	}
+
+	void TimerWheel::link(Timer*& head, Timer* timer) {
+		timer->wheelPrev = nullptr;
+		timer->wheelNext = head;
+		if (head != nullptr) head->wheelPrev = timer;
+		head = timer;
+		timer->wheelSlot = &head;
+	}
+
+	void TimerWheel::unlink(Timer* timer) {
+		if (timer->wheelPrev != nullptr) {
+			timer->wheelPrev->wheelNext = timer->wheelNext;
+		} else {
+			*timer->wheelSlot = timer->wheelNext;
+		}
+		if (timer->wheelNext != nullptr) timer->wheelNext->wheelPrev = timer->wheelPrev;
+		timer->wheelSlot = nullptr;
+		timer->wheelPrev = nullptr;
+		timer->wheelNext = nullptr;
+	}
+
+	void TimerWheel::cascade(size_t level, uint64_t slot) {
+		Timer* timer = slots[level][slot];
+		slots[level][slot] = nullptr;
+		while (timer != nullptr) {
+			Timer* next = timer->wheelNext;
+			place(timer);
+			timer = next;
+		}
+	}
+
+	void TimerWheel::fireCurrentTick() {
+		Timer*& head = slots[0][currentTick & slotMask];
+		if (head == nullptr) return;
+		firing.clear();
+		for (Timer* timer = head; timer != nullptr;) {
+			Timer* next = timer->wheelNext;
+			timer->wheelSlot = nullptr;
+			timer->wheelPrev = nullptr;
+			timer->wheelNext = nullptr;
+			timer->wheelFiring = true;
+			firing.push_back(timer);
+			timer = next;
+		}
+		head = nullptr;
+		scheduledCount -= firing.size();
+		//Timers are linked at the head, so reverse to fire timers of the same expiration in the order they were scheduled
+		reverse(firing.begin(), firing.end());
+		stable_sort(firing.begin(), firing.end(), [](const Timer* a, const Timer* b) { return a->expiration < b->expiration; });
+		//Timers fired earlier in the tick may unschedule later ones, which sets them to null
+		for (size_t i = 0; i < firing.size(); i++) {
+			Timer* timer = firing[i];
+			if (timer == nullptr) continue;
+			timer->wheelFiring = false;
+			lastFiredCount++;
+			timer->owner->fire(timer);
+		}
+		firing.clear();
+	}
+
+	bool TimerWheel::call(Timer* timer) {
+		calledTimer = timer;
+		calledReleased = false;
+		timer->onComplete->call(timer->body);
+		calledTimer = nullptr;
+		if (calledReleased) {
+			//The Script cancelled its timer or deleted its Body, which erased the timer but kept it until the call returned
+			delete timer->onComplete;
+			delete timer;
+			return false;
+		}
+		return true;
+	}
+
+	bool TimerWheel::release(Timer* timer) {
+		unschedule(timer);
+		if (timer == calledTimer) {
+			calledReleased = true;
+			return true;
+		}
+		return false;
+	}
+
+	uint64_t TimerWheel::toTick(sec_t time) const {
+		return (uint64_t)ceil(max((double)time, 0.0) * ticksPerSec) + tickOffset;
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Timer.h"
+#include "../Types/Types.h"
+#include "../Engine/EngineSystem.h"
+using namespace std;
+
+namespace CGEngine {
+	/// <summary>
+	/// Fires the World's timers. Timers are linked into a hierarchical timing wheel of 1 millisecond ticks: 4 levels of 256 slots, each level
+	/// spanning 256 ticks of the level below. Scheduling and cancelling a timer are constant time, and advancing jumps from one occupied slot
+	/// to the next, so pending timers cost nothing until they expire and empty stretches of time are skipped. Timers further away than the
+	/// wheel's span (about 49 days) wait in the last slot of the top level and are placed again each time it comes around.
+	/// </summary>
+	class TimerWheel : public EngineSystem {
+	public:
+		TimerWheel();
+		/// <summary>
+		/// Schedule the timer to fire when the World time reaches its expiration. A timer that has already expired fires on the next tick.
+		/// </summary>
+		/// <param name="timer">The timer to schedule. If it is already scheduled, it is moved to its new expiration.</param>
+		void schedule(Timer* timer);
+		/// <summary>
+		/// Stop the timer from firing, if it is scheduled
+		/// </summary>
+		/// <param name="timer">The timer to unschedule</param>
+		void unschedule(Timer* timer);
+		/// <summary>
+		/// Fire the timers that expire by the time, ordered by expiration within each tick. A looping timer rescheduled while firing fires again
+		/// in the same advance if its next expiration has also passed, so loops catch up after a long frame. If the time is earlier than the
+		/// last advance, as when a replay locks an earlier elapsed time, nothing fires and later expirations are measured from the new time.
+		/// Called by the World each frame before the update scripts.
+		/// </summary>
+		/// <param name="now">The World time to advance to</param>
+		void advance(sec_t now);
+		/// <summary>
+		/// Return the number of scheduled timers
+		/// </summary>
+		size_t getScheduledCount() const;
+		/// <summary>
+		/// Return the number of timers fired by the last advance
+		/// </summary>
+		size_t getLastFiredCount() const;
+
+		//The number of ticks in a second
+		static constexpr double ticksPerSec = 1000;
+	private:
+		static constexpr size_t slotBits = 8;
+		static constexpr size_t slotCount = 1 << slotBits;
+		static constexpr uint64_t slotMask = slotCount - 1;
+		static constexpr size_t levelCount = 4;
+
+		//The head of each slot's list of timers
+		array<array<Timer*, slotCount>, levelCount> slots = {};
+		//The last tick advanced to
+		uint64_t currentTick = 0;
+		//Added to World time ticks, so the wheel's ticks keep increasing when the World time goes back
+		uint64_t tickOffset = 0;
+		size_t scheduledCount = 0;
+		size_t lastFiredCount = 0;
+		//The timers of the tick being fired. Timers unscheduled while it fires are set to null.
+		vector<Timer*> firing;
+		//The timer whose onComplete Script is being called, and whether the call released it. Kept by the wheel rather than the timer's
+		//TimerMap, since the call may delete the timer's Body and its TimerMap with it.
+		Timer* calledTimer = nullptr;
+		bool calledReleased = false;
+
+		friend class TimerMap;
+		//Call the timer's onComplete Script. Returns false if the call released the timer, in which case it has been deleted.
+		bool call(Timer* timer);
+		//Unschedule a timer that is being deleted. Returns true if it is the timer whose Script is being called, which is deleted once the call returns instead.
+		bool release(Timer* timer);
+
+		//Link the timer into the slot of its tick
+		void place(Timer* timer);
+		void link(Timer*& head, Timer* timer);
+		void unlink(Timer* timer);
+		//Place the timers of a higher level's slot again, now that the wheel has reached it
+		void cascade(size_t level, uint64_t slot);
+		//Fire the timers of the current tick
+		void fireCurrentTick();
+		//Return the next tick with a level 0 slot to fire or a higher level slot to cascade, or UINT64_MAX if there are no timers
+		uint64_t findNextTick() const;
+		uint64_t toTick(sec_t time) const;
+	};
+}
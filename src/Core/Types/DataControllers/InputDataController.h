@@ -14,16 +14,17 @@ namespace CGEngine {
 		}
 
 		template<typename T>
-		T getInputData(string key) {
+		T getInputData(DataKey key) {
 			return input.getData<T>(key);
 		}
 
 		template<typename T>
-		T* getInputDataPtr(string key) {
+		T* getInputDataPtr(DataKey key) {
 			return input.getDataPtr<T>(key);
 		}
 
-		void setInputData(string key, any value) {
+		template<typename T>
+		void setInputData(DataKey key, const T& value) {
 			input.setData(key, value);
 		}
 	protected:
@@ -14,16 +14,17 @@ namespace CGEngine {
 		}
 
 		template<typename T>
-		T getOutputData(string key) {
+		T getOutputData(DataKey key) {
 			return output.getData<T>(key);
 		}
 
 		template<typename T>
-		T* getOutputDataPtr(string key) {
+		T* getOutputDataPtr(DataKey key) {
 			return output.getDataPtr<T>(key);
 		}
 
-		void setOutputData(string key, any value) {
+		template<typename T>
+		void setOutputData(DataKey key, const T& value) {
 			output.setData(key, value);
 		}
 	protected:
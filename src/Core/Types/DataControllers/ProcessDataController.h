@@ -14,16 +14,17 @@ namespace CGEngine {
 		}
 
 		template<typename T>
-		T getProcessData(string key) {
+		T getProcessData(DataKey key) {
 			return process.getData<T>(key);
 		}
 
 		template<typename T>
-		T* getProcessDataPtr(string key) {
+		T* getProcessDataPtr(DataKey key) {
 			return process.getDataPtr<T>(key);
 		}
 
-		void setProcessData(string key, any value) {
+		template<typename T>
+		void setProcessData(DataKey key, const T& value) {
 			process.setData(key, value);
 		}
 	protected:
@@ -0,0 +1,20 @@
+#include "DataKey.h"
+#include "StringInterner.h"
+
+namespace CGEngine {
+	namespace {
+		//Created on first use, so keys can be interned during static initialization
+		StringInterner<uint32_t>& getRegistry() {
+			static StringInterner<uint32_t> registry;
+			return registry;
+		}
+	}
+
+	DataKey::DataKey(const string& name) : id(getRegistry().intern(name)) {}
+
+	DataKey::DataKey(const char* name) : id(getRegistry().intern(name)) {}
+
+	const string& DataKey::getName() const {
+		return getRegistry().getName(id);
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+using namespace std;
+
+namespace CGEngine {
+	/// <summary>
+	/// An interned DataMap key. Constructing a key from a name interns it once, so a key kept in a variable is looked up in a DataMap
+	/// by comparing integers instead of strings. Names convert implicitly, so string keys still work at the cost of interning on each use.
+	/// </summary>
+	class DataKey {
+	public:
+		DataKey(const string& name);
+		DataKey(const char* name);
+		uint32_t getId() const { return id; }
+		//Return the name the key was interned from
+		const string& getName() const;
+		bool operator==(const DataKey& other) const { return id == other.id; }
+		bool operator!=(const DataKey& other) const { return id != other.id; }
+		bool operator<(const DataKey& other) const { return id < other.id; }
+	private:
+		uint32_t id;
+	};
+}
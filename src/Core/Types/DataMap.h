@@ -1,69 +1,184 @@
 #pragma once
 
+#include <algorithm>
 #include <any>
+#include <cstring>
 #include <optional>
 #include <map>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+#include "DataKey.h"
 using namespace std;
 
 namespace CGEngine {
+	/// <summary>
+	/// A DataMap value. Small trivially copyable values (vectors, rects, numbers, enums and pointers) are stored inline, and other values
+	/// are boxed in an any.
+	/// </summary>
+	class DataValue {
+	public:
+		static constexpr size_t inlineSize = 16;
+		template<typename T>
+		static constexpr bool isStoredInline = is_trivially_copyable_v<T> && sizeof(T) <= inlineSize && alignof(T) <= alignof(max_align_t);
+
+		DataValue() = default;
+
+		template<typename T>
+		void set(const T& value) {
+			//Stored decayed, as an any would store it, so a string literal is read back as a const char*
+			using Stored = decay_t<const T&>;
+			const Stored& stored = value;
+			if constexpr (is_same_v<Stored, any>) {
+				boxed = stored;
+				valueType = &stored.type();
+				toAnyFunction = nullptr;
+			} else if constexpr (isStoredInline<Stored>) {
+				boxed.reset();
+				memcpy(bytes, &stored, sizeof(Stored));
+				valueType = &typeid(Stored);
+				toAnyFunction = [](const unsigned char* inlineBytes) -> any {
+					return *reinterpret_cast<const Stored*>(inlineBytes);
+				};
+			} else {
+				boxed = stored;
+				valueType = &typeid(Stored);
+				toAnyFunction = nullptr;
+			}
+		}
+
+		//Return the value if it is a T, or nullptr
+		template<typename T>
+		const T* get() const {
+			if (*valueType != typeid(T)) return nullptr;
+			if constexpr (isStoredInline<T>) {
+				if (toAnyFunction != nullptr) {
+					return reinterpret_cast<const T*>(bytes);
+				}
+			}
+			return any_cast<T>(&boxed);
+		}
+
+		const type_info& type() const {
+			return *valueType;
+		}
+
+		//Return a copy of the value in an any
+		any toAny() const {
+			return toAnyFunction != nullptr ? toAnyFunction(bytes) : boxed;
+		}
+	private:
+		alignas(max_align_t) unsigned char bytes[inlineSize] = {};
+		//Converts the inline bytes back to an any. Null when the value is boxed.
+		any(*toAnyFunction)(const unsigned char*) = nullptr;
+		const type_info* valueType = &typeid(void);
+		any boxed;
+	};
+
+	struct DataEntry {
+		DataKey key;
+		DataValue value;
+	};
+
+	/// <summary>
+	/// A map of DataKeys to values, stored as a flat vector sorted by key id. Keys kept as DataKey variables are found without hashing or
+	/// comparing strings, and small trivially copyable values are read and written without allocating.
+	/// </summary>
 	class DataMap {
 	public:
-		DataMap(map<string, any> d = {}) : data(d) {};
+		DataMap(map<string, any> d = {}) {
+			entries.reserve(d.size());
+			for (const auto& [key, value] : d) {
+				setData(key, value);
+			}
+		}
 
-		void setData(string key, any val) {
-			data[key] = val;
+		template<typename T>
+		void setData(DataKey key, const T& val) {
+			auto iterator = find(key);
+			if (iterator == entries.end() || iterator->key != key) {
+				iterator = entries.insert(iterator, DataEntry{ key, DataValue() });
+			}
+			iterator->value.set(val);
 		}
 
-		void removeData(string key) {
-			if (data.find(key) != data.end()) {
-				data.erase(key);
+		void removeData(DataKey key) {
+			auto iterator = find(key);
+			if (iterator != entries.end() && iterator->key == key) {
+				entries.erase(iterator);
 			}
 		}
 
-		optional<any> getData(string key) {
-			if (data.find(key) != data.end()) {
-				return data[key];
+		bool hasData(DataKey key) const {
+			auto iterator = find(key);
+			return iterator != entries.end() && iterator->key == key;
+		}
+
+		optional<any> getData(DataKey key) const {
+			if (const DataValue* value = getValue(key)) {
+				return value->toAny();
 			}
 			return nullopt;
 		}
 
 		template<typename T>
-		T getData(string key) {
+		T getData(DataKey key) const {
 			static T test;
-			if (data.find(key) != data.end()) {
-				return any_cast<T>(data[key]);
+			if (const DataValue* value = getValue(key)) {
+				const T* typed = value->get<T>();
+				if (typed == nullptr) throw bad_any_cast();
+				return *typed;
 			}
 			return test;
 		}
 
 		template<typename T>
-		T* getDataPtr(string key) {
-			if (data.find(key) != data.end()) {
-				return any_cast<T*>(data[key]);
+		T* getDataPtr(DataKey key) const {
+			if (const DataValue* value = getValue(key)) {
+				T* const* typed = value->get<T*>();
+				if (typed == nullptr) throw bad_any_cast();
+				return *typed;
 			}
 			return nullptr;
 		}
 
-		optional<any> pullOutData(string key) {
-			if (data.find(key) != data.end()) {
-				any d = data[key];
-				data.erase(key);
-				return d;
-			}
-			return nullopt;
+		optional<any> pullOutData(DataKey key) {
+			optional<any> data = getData(key);
+			removeData(key);
+			return data;
 		}
 
 		template<typename T>
-		T pullOutData(string key) {
+		T pullOutData(DataKey key) {
 			static T test;
-			if (data.find(key) != data.end()) {
-				T d = any_cast<T>(data[key]);
-				data.erase(key);
-				return d;
-			}
-			return test;
+			if (!hasData(key)) return test;
+			T data = getData<T>(key);
+			removeData(key);
+			return data;
+		}
+
+		//Return the entries, sorted by key id
+		const vector<DataEntry>& getEntries() const {
+			return entries;
+		}
+
+		size_t size() const {
+			return entries.size();
 		}
 	private:
-		map<string, any> data;
+		vector<DataEntry> entries;
+
+		vector<DataEntry>::iterator find(DataKey key) {
+			return lower_bound(entries.begin(), entries.end(), key, [](const DataEntry& entry, DataKey key) { return entry.key < key; });
+		}
+
+		vector<DataEntry>::const_iterator find(DataKey key) const {
+			return lower_bound(entries.begin(), entries.end(), key, [](const DataEntry& entry, DataKey key) { return entry.key < key; });
+		}
+
+		const DataValue* getValue(DataKey key) const {
+			auto iterator = find(key);
+			return iterator != entries.end() && iterator->key == key ? &iterator->value : nullptr;
+		}
 	};
-}
\ No newline at end of file
+}
@@ -5,6 +5,10 @@ namespace CGEngine {
 		return scripts.addScript(domain, script);
 	}
 
+	id_t ScriptController::addScript(domainId_t domainId, Script* script) {
+		return scripts.addScript(domainId, script);
+	}
+
 	void ScriptController::addScriptEventsByDomain(map<string, ScriptEvent> sc) {
 		for (auto iterator = sc.begin(); iterator != sc.end(); ++iterator) {
 			string domain = (*iterator).first;
@@ -17,49 +21,69 @@ namespace CGEngine {
 	}
 
 	id_t ScriptController::addStartScript(Script* script) {
-		return scripts.addScript(onStartEvent, script);
+		return scripts.addScript(onStartDomain, script);
 	}
 
 	id_t ScriptController::addUpdateScript(Script* script) {
-		return scripts.addScript(onUpdateEvent, script);
+		return scripts.addScript(onUpdateDomain, script);
+	}
+
+	id_t ScriptController::addFixedUpdateScript(Script* script) {
+		return scripts.addScript(onFixedUpdateDomain, script);
 	}
 
 	id_t ScriptController::addDeleteScript(Script* script) {
-		return scripts.addScript(onDeleteEvent, script);
+		return scripts.addScript(onDeleteDomain, script);
 	}
 
 	void ScriptController::eraseScript(string domain, id_t scriptId, bool shouldDelete) {
 		scripts.eraseScript(domain, scriptId, shouldDelete);
 	}
 
+	void ScriptController::eraseScript(domainId_t domainId, id_t scriptId, bool shouldDelete) {
+		scripts.eraseScript(domainId, scriptId, shouldDelete);
+	}
+
 	void ScriptController::eraseScript(string domain, Script* script, bool shouldDelete) {
 		scripts.eraseScript(domain, script, shouldDelete);
 	}
 
 	void ScriptController::eraseStartScript(id_t scriptId, bool shouldDelete) {
-		eraseScript(onStartEvent, scriptId, shouldDelete);
+		eraseScript(onStartDomain, scriptId, shouldDelete);
 	}
 
 	void ScriptController::eraseUpdateScript(id_t scriptId, bool shouldDelete) {
-		eraseScript(onUpdateEvent, scriptId, shouldDelete);
+		eraseScript(onUpdateDomain, scriptId, shouldDelete);
 	}
 
 	void ScriptController::eraseDeleteScript(id_t scriptId, bool shouldDelete) {
-		eraseScript(onDeleteEvent, scriptId, shouldDelete);
+		eraseScript(onDeleteDomain, scriptId, shouldDelete);
 	}
 
 	void ScriptController::deleteDomain(string domain) {
 		scripts.deleteDomain(domain);
 	}
 
+	void ScriptController::deleteDomain(domainId_t domainId) {
+		scripts.deleteDomain(domainId);
+	}
+
 	void ScriptController::clearDomain(string domain) {
 		scripts.clearDomain(domain);
 	}
 
+	void ScriptController::clearDomain(domainId_t domainId) {
+		scripts.clearDomain(domainId);
+	}
+
 	void ScriptController::callDomain(string domain) {
 		scripts.callDomain(domain);
 	}
 
+	void ScriptController::callDomain(domainId_t domainId) {
+		scripts.callDomain(domainId);
+	}
+
 	void ScriptController::callDomainWithData(string domain, DataMap data) {
 		scripts.callDomainWithData(domain, nullptr, data);
 	}
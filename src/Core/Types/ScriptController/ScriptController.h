@@ -13,6 +13,7 @@ namespace CGEngine {
         /// <param name="script">The script to add to the domain</param>
         /// <returns>The unique id of the script within the domain</returns>
 		id_t addScript(string domain, Script* script);
+		id_t addScript(domainId_t domainId, Script* script);
         /// <summary>
         /// Add each script to the indicated ScriptDomain, creating the domain if it doesn't already exist
         /// </summary>
@@ -33,6 +34,12 @@ namespace CGEngine {
         /// <returns>The unique id of the script within the domain</returns>
 		id_t addUpdateScript(Script* script);
         /// <summary>
+        /// Add the script to the "fixedUpdate" ScriptDomain to be called each fixed simulation step. time->getDeltaSec() returns the fixed step while it runs.
+        /// </summary>
+        /// <param name="script">The script to add</param>
+        /// <returns>The unique id of the script within the domain</returns>
+		id_t addFixedUpdateScript(Script* script);
+        /// <summary>
         /// Add the script to the "delete" ScriptDomain to be called when the Body is deleted
         /// </summary>
         /// <param name="script">The script to add</param>
@@ -45,6 +52,7 @@ namespace CGEngine {
         /// <param name="scriptId">The unique id of the script to delete within the domain</param>
         /// <param name="shouldDelete">Whether the domain should be deleted if empty after the erase</param>
         void eraseScript(string domain, id_t scriptId, bool shouldDelete = false);
+        void eraseScript(domainId_t domainId, id_t scriptId, bool shouldDelete = false);
         /// <summary>
         /// Erase and delete the script with the id in the domain.
         /// </summary>
@@ -75,11 +83,13 @@ namespace CGEngine {
         /// </summary>
         /// <param name="domain">The name of the domain to delete</param>
         void deleteDomain(string domain);
+        void deleteDomain(domainId_t domainId);
         /// <summary>
         /// Erase and refund ids for all scripts in the domain, but don't delete the domain or the Scripts
         /// </summary>
         /// <param name="domain">The name of the domain to delete</param>
         void clearDomain(string domain);
+        void clearDomain(domainId_t domainId);
 		/// <summary>
 		/// Remove a Script from a domain without deleting the Script
 		/// </summary>
@@ -92,6 +102,7 @@ namespace CGEngine {
 		/// </summary>
 		/// <param name="domain">The name of the domain to call Scripts in</param>
 		void callDomain(string domain);
+		void callDomain(domainId_t domainId);
 		/// <summary>
 		/// Provide each Script with data, then call it
 		/// </summary>
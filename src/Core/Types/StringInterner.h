@@ -0,0 +1,76 @@
+#pragma once
+
+#include <deque>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+using namespace std;
+
+namespace CGEngine {
+	/// <summary>
+	/// Interns strings to small dense ids, assigned in the order they're first interned. A string keeps its id for the life of the
+	/// interner, and returned names stay valid as more are interned. Safe to call from any thread.
+	/// </summary>
+	template <typename IdType>
+	class StringInterner {
+	public:
+		/// <summary>
+		/// Create an interner with the names interned in order, so they have ids from 0
+		/// </summary>
+		StringInterner(initializer_list<const char*> initialNames = {}) {
+			for (const char* name : initialNames) {
+				intern(name);
+			}
+		}
+
+		/// <summary>
+		/// Return the id of the name, assigning the next id if the name hasn't been interned
+		/// </summary>
+		IdType intern(const string& name) {
+			{
+				shared_lock lock(internMutex);
+				auto found = ids.find(name);
+				if (found != ids.end()) return found->second;
+			}
+			unique_lock lock(internMutex);
+			auto [found, inserted] = ids.try_emplace(name, (IdType)names.size());
+			if (inserted) {
+				names.push_back(name);
+			}
+			return found->second;
+		}
+
+		/// <summary>
+		/// Return the id of the name if it has been interned, without interning it
+		/// </summary>
+		optional<IdType> find(const string& name) const {
+			shared_lock lock(internMutex);
+			auto found = ids.find(name);
+			if (found == ids.end()) return nullopt;
+			return found->second;
+		}
+
+		/// <summary>
+		/// Return the name of an interned id, or an empty string if the id hasn't been assigned
+		/// </summary>
+		const string& getName(IdType id) const {
+			static const string unknown = "";
+			shared_lock lock(internMutex);
+			return id < names.size() ? names[id] : unknown;
+		}
+
+		//Return the number of interned names, which is one past the largest id
+		size_t size() const {
+			shared_lock lock(internMutex);
+			return names.size();
+		}
+	private:
+		mutable shared_mutex internMutex;
+		unordered_map<string, IdType> ids;
+		//Names by id. A deque so returned names stay valid as more are interned.
+		deque<string> names;
+	};
+}
@@ -10,6 +10,8 @@ namespace CGEngine {
 
     typedef size_t id_t;
     typedef float sec_t;
+    //Interned ScriptDomain name. See DomainRegistry.
+    typedef uint32_t domainId_t;
     typedef const Event::MouseButtonPressed MousePressInput;
     typedef const Event::MouseButtonReleased MouseReleaseInput;
     typedef const Event::KeyReleased KeyReleaseInput;
@@ -17,6 +17,15 @@ namespace CGEngine {
 			return key;
 		}
 
+		//Add all values with their ids taken in one batch. Returns the keys in the order of the values.
+		vector<DomainKey> add(const vector<DomainValue>& values) {
+			vector<DomainKey> keys = ids.take(values.size());
+			for (size_t i = 0; i < keys.size(); i++) {
+				domain[keys[i]] = values[i];
+			}
+			return keys;
+		}
+
 		void remove(DomainKey key) {
 			if (domain.find(key) != domain.end()) {
 				ids.give(key);
@@ -24,19 +33,20 @@ namespace CGEngine {
 			}
 		}
 
-		DomainValue get(DomainKey key) {
-			if (domain.find(key) != domain.end()) {
-				return domain[key];
+		DomainValue get(DomainKey key) const {
+			auto iterator = domain.find(key);
+			if (iterator != domain.end()) {
+				return iterator->second;
 			}
-			static DomainValue def;
+			static const DomainValue def{};
 			return def;
 		}
 
-		bool has(DomainKey key) {
+		bool has(DomainKey key) const {
 			return (domain.find(key) != domain.end());
 		}
 
-		void forEach(function<void(DomainValue)> function) {
+		void forEach(function<void(DomainValue)> function) const {
 			for (auto iterator = domain.begin(); iterator != domain.end(); ++iterator) {
 				function((*iterator).second);
 			}
@@ -46,7 +56,7 @@ namespace CGEngine {
 			domain.clear();
 		}
 
-		size_t size() {
+		size_t size() const {
 			return domain.size();
 		}
 	private:
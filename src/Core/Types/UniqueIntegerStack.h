@@ -4,6 +4,7 @@
 #include <set>
 #include <optional>
 #include <iostream>
+#include <vector>
 #include "../Types/Types.h"
 using namespace std;
 
@@ -11,7 +12,7 @@ namespace CGEngine {
     template <typename IntType = id_t>
     class UniqueIntegerStack {
     public:
-        UniqueIntegerStack(IntType count) {
+        UniqueIntegerStack(IntType count) : nextId(count) {
             for (IntType i = 0; i < count; i++) {
                 uniqueIds.insert(i);
             }
@@ -25,6 +26,13 @@ namespace CGEngine {
                 mappedIds[reciever] = id;
                 removedIds.insert(id);
                 return id;
+            } else if (nextId > 0) {
+                //Grow the stack when the preallocated ids are exhausted
+                IntType id = nextId++;
+                *reciever = id;
+                mappedIds[reciever] = id;
+                removedIds.insert(id);
+                return id;
             }
             return 0U;
         }
@@ -35,10 +43,25 @@ namespace CGEngine {
                 uniqueIds.erase(id);
                 removedIds.insert(id);
                 return id;
+            } else if (nextId > 0) {
+                //Grow the stack when the preallocated ids are exhausted
+                IntType id = nextId++;
+                removedIds.insert(id);
+                return id;
             }
             return 0U;
         }
 
+        //Take count ids at once, growing the stack if there aren't enough free ids
+        vector<IntType> take(size_t count) {
+            vector<IntType> ids;
+            ids.reserve(count);
+            for (size_t i = 0; i < count; i++) {
+                ids.push_back(take());
+            }
+            return ids;
+        }
+
         void give(IntType key) {
             if (removedIds.find(key) != removedIds.end()) {
                 uniqueIds.insert(key);
@@ -60,5 +83,6 @@ namespace CGEngine {
         set<IntType> uniqueIds;
         set<IntType> removedIds;
         map<optional<IntType>*, IntType> mappedIds;
+        IntType nextId = 0;
     };
 }
\ No newline at end of file
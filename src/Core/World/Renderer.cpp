@@ -1,4 +1,5 @@
 #include "../Engine/Engine.h"
+#include "../Engine/EngineContext.h"
 #include "Renderer.h"
 #include "../../Standard/Models/CommonModels.h"
 #include "../Animation/Animator.h"
@@ -104,15 +105,18 @@ namespace CGEngine {
 	}
 
 	void Renderer::getModelData(Mesh* mesh) {
-		if (setGLWindowState(true)) {
-			MeshData* meshData = mesh->getMeshData();
-			//Don't throw an error because null Mesh Bodies are valid (but not rendered)
-			if (!meshData) return;
-
-			vector<id_t> meshMaterialIds = mesh->getMaterials();
-			Material* renderMaterial = assets.get<Material>(fallbackMaterialId);
+		MeshData* meshData = mesh->getMeshData();
+		//Don't throw an error because null Mesh Bodies are valid (but not rendered)
+		if (!meshData) return;
+		vector<id_t> meshMaterialIds = mesh->getMaterials();
+		//Queued with the Materials' program creation while pipelined, so the programs exist by the time the buffers are created
+		runGL([this, meshData, meshMaterialIds]() {
+			//MeshData shared between Meshes (e.g. Prefab instances) only needs its buffers created once
+			if (meshData->vao != 0U) return;
+
+			Material* renderMaterial = assets->get<Material>(fallbackMaterialId);
 			if (meshMaterialIds.size() > 0) {
-				Material* meshMaterial = assets.get<Material>(meshMaterialIds[0]);
+				Material* meshMaterial = assets->get<Material>(meshMaterialIds[0]);
 				if (meshMaterial && meshMaterial->getProgram()) {
 					renderMaterial = meshMaterial;
 				}
@@ -168,11 +172,36 @@ namespace CGEngine {
 					GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, weights)));
 			}
 			glBindVertexArray(0);
+		});
+	}
 
+	void Renderer::runGL(function<void()> command) {
+		if (pipelined) {
+			if (this_thread::get_id() == renderThreadId.load()) {
+				command();
+			} else {
+				lock_guard<mutex> lock(glCommandMutex);
+				glCommands.push_back(move(command));
+			}
+			return;
+		}
+		if (setGLWindowState(true)) {
+			command();
 			setGLWindowState(false);
 		}
 	}
 
+	void Renderer::drainGLCommands() {
+		vector<function<void()>> commands;
+		{
+			lock_guard<mutex> lock(glCommandMutex);
+			commands.swap(glCommands);
+		}
+		for (function<void()>& command : commands) {
+			command();
+		}
+	}
+
 	void Renderer::updateMaterialUBO(const MaterialUBO& materialData) {
 		glBindBuffer(GL_UNIFORM_BUFFER, materialUBO);
 		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(MaterialUBO), &materialData);
@@ -202,10 +231,15 @@ namespace CGEngine {
 	}
 
 	Material* Renderer::getFallbackMaterial() {
-		return assets.get<Material>(fallbackMaterialId);
+		return assets->get<Material>(fallbackMaterialId);
 	}
 
 	bool Renderer::setGLWindowState(bool state) {
+		//The render thread owns the OpenGL context while pipelined rendering is enabled
+		if (pipelined && this_thread::get_id() != renderThreadId.load()) {
+			log(this, LogWarn, "OpenGL calls are only made on the render thread while pipelined rendering is enabled");
+			return false;
+		}
 		// Make the window no longer the active window for OpenGL calls
 		bool success = window->setActive(state);
 		if (!success) {
@@ -240,7 +274,8 @@ namespace CGEngine {
 				setGLWindowState(false);
 				return false;
 			}
-			root->render(*window, root->getTransform());
+			updateAnimators();
+			collectRenderBodies();
 			//Sort and render Meshes and SFML entities
 			render(window);
 			endFrame();
@@ -265,6 +300,7 @@ namespace CGEngine {
 
 			window->display();
 			setGLWindowState(false);
+			recordFrameTime();
 			return true;
 		} catch (const exception& ex) {
 			log(this, LogError, "Exception in processRender: {}", ex.what());
@@ -277,6 +313,228 @@ namespace CGEngine {
 		}
 	}
 
+	bool Renderer::processPipelinedRender() {
+		Clock extractClock;
+		RenderSnapshot& snapshot = snapshots[1 - frontSnapshot];
+		extractSnapshot(snapshot);
+		float extractMs = extractClock.getElapsedTime().asMicroseconds() / 1000.f;
+
+		//The render thread is done with the back snapshot, but may still be drawing the front one
+		Clock waitClock;
+		unique_lock<mutex> lock(pipelineMutex);
+		pipelineCondition.wait(lock, [this]() { return !renderPending; });
+		if (renderFailed) return false;
+		float waitMs = waitClock.getElapsedTime().asMicroseconds() / 1000.f;
+
+		frontSnapshot = 1 - frontSnapshot;
+		renderPending = true;
+		size_t frames = ++pipelineStats.frames;
+		pipelineStats.extractMs += (extractMs - pipelineStats.extractMs) / frames;
+		pipelineStats.waitMs += (waitMs - pipelineStats.waitMs) / frames;
+		lock.unlock();
+		pipelineCondition.notify_all();
+		recordFrameTime();
+		return true;
+	}
+
+	void Renderer::setPipelinedEnabled(bool enabled) {
+		if (enabled == pipelined) return;
+		if (enabled) {
+			if (window == nullptr) {
+				log(this, LogWarn, "Pipelined rendering needs a window");
+				return;
+			}
+			//Hand the OpenGL context over to the render thread
+			setGLWindowState(false);
+			renderPending = false;
+			renderFailed = false;
+			stopRendering = false;
+			pipelineStats = PipelineStats();
+			pipelined = true;
+			renderThread = thread(&Renderer::runRenderThread, this, &EngineContext::current());
+			log(this, LogInfo, "Enabled pipelined rendering");
+		} else {
+			{
+				lock_guard<mutex> lock(pipelineMutex);
+				stopRendering = true;
+			}
+			pipelineCondition.notify_all();
+			renderThread.join();
+			pipelined = false;
+			log(this, LogInfo, "Disabled pipelined rendering after {} frames. Average extract: {}ms, wait: {}ms, render: {}ms, latency: {}ms. Average frame: {}ms (serial {}ms)",
+				pipelineStats.frames, pipelineStats.extractMs, pipelineStats.waitMs, pipelineStats.renderMs, pipelineStats.latencyMs, getAverageFrameMs(true), getAverageFrameMs(false));
+		}
+	}
+
+	bool Renderer::getPipelinedEnabled() const {
+		return pipelined;
+	}
+
+	PipelineStats Renderer::getPipelineStats() const {
+		return pipelineStats;
+	}
+
+	float Renderer::getAverageFrameMs(bool pipelinedFrames) const {
+		size_t mode = pipelinedFrames ? 1 : 0;
+		return frameCounts[mode] > 0 ? frameSec[mode] * 1000.f / frameCounts[mode] : 0.f;
+	}
+
+	void Renderer::recordFrameTime() {
+		size_t mode = pipelined ? 1 : 0;
+		frameSec[mode] += time->getDeltaSec();
+		frameCounts[mode]++;
+	}
+
+	void Renderer::runRenderThread(EngineContext* context) {
+		renderThreadId = this_thread::get_id();
+		//Drawing uses the engine names of the context that enabled pipelining
+		if (!context->makeCurrent() || !setGLWindowState(true)) {
+			lock_guard<mutex> lock(pipelineMutex);
+			renderFailed = true;
+			renderPending = false;
+			pipelineCondition.notify_all();
+			return;
+		}
+		unique_lock<mutex> lock(pipelineMutex);
+		while (true) {
+			pipelineCondition.wait(lock, [this]() { return renderPending || stopRendering; });
+			if (stopRendering) break;
+			RenderSnapshot& snapshot = snapshots[frontSnapshot];
+			lock.unlock();
+
+			Clock renderClock;
+			//Create the OpenGL resources queued from other threads before drawing the snapshot that may use them
+			drainGLCommands();
+			bool rendered = drawSnapshot(snapshot);
+			float renderMs = renderClock.getElapsedTime().asMicroseconds() / 1000.f;
+			float latencyMs = snapshot.extractClock.getElapsedTime().asMicroseconds() / 1000.f;
+
+			lock.lock();
+			size_t frames = max(pipelineStats.frames, (size_t)1);
+			pipelineStats.renderMs += (renderMs - pipelineStats.renderMs) / frames;
+			pipelineStats.latencyMs += (latencyMs - pipelineStats.latencyMs) / frames;
+			renderFailed = !rendered;
+			renderPending = false;
+			pipelineCondition.notify_all();
+			if (!rendered) break;
+		}
+		lock.unlock();
+		drainGLCommands();
+		setGLWindowState(false);
+	}
+
+	void Renderer::extractSnapshot(RenderSnapshot& snapshot) {
+		snapshot.clear();
+		clear();
+		updateAnimators();
+		collectRenderBodies();
+		if (zSortingEnabled) {
+			sortZ();
+		}
+
+		for (const RenderOrderEntry& entry : renderOrder) {
+			Body* body = assets->get<Body>(entry.bodyId);
+			SnapshotDrawItem item;
+			item.transform = entry.transform;
+			if (body->bodyParams.boundsRendering && body->boundsRect != nullptr) {
+				item.boundsIndex = (int)snapshot.bounds.size();
+				snapshot.bounds.push_back(*body->boundsRect);
+			}
+			if (body->bodyParams.rendering && body->entity != nullptr) {
+				if (body->components == ComponentMesh) {
+					Mesh* mesh = static_cast<Mesh*>(body->entity);
+					SnapshotMesh snapshotMesh;
+					snapshotMesh.meshData = mesh->getMeshData();
+					if (snapshotMesh.meshData != nullptr && !snapshotMesh.meshData->vertices.empty()) {
+						snapshotMesh.materials = mesh->getMaterials();
+						snapshotMesh.model = getBodyGlobalTransform(mesh->getBodyId());
+						//Animators are advanced on the main thread, and their bone matrices copied
+						if (Animator* animator = getAnimator(mesh)) {
+							snapshotMesh.animated = true;
+							snapshotMesh.bones = animator->getBoneMatrices();
+						}
+						item.kind = SnapshotDrawKind::Mesh;
+						item.index = snapshot.meshes.size();
+						snapshot.meshes.push_back(move(snapshotMesh));
+					}
+				} else if (body->components == ComponentSprite) {
+					item.kind = SnapshotDrawKind::Sprite;
+					item.index = snapshot.sprites.size();
+					snapshot.sprites.push_back(*static_cast<Sprite*>(body->entity));
+				} else if (body->components == ComponentText) {
+					item.kind = SnapshotDrawKind::Text;
+					item.index = snapshot.texts.size();
+					snapshot.texts.push_back(*static_cast<Text*>(body->entity));
+				} else if (body->components == ComponentShape) {
+					//Copy any Shape as a ConvexShape with the same points, so the snapshot doesn't depend on the Shape's concrete type
+					Shape* shape = static_cast<Shape*>(body->entity);
+					ConvexShape copy(shape->getPointCount());
+					for (size_t i = 0; i < shape->getPointCount(); i++) {
+						copy.setPoint(i, shape->getPoint(i));
+					}
+					copy.setTexture(shape->getTexture());
+					copy.setTextureRect(shape->getTextureRect());
+					copy.setFillColor(shape->getFillColor());
+					copy.setOutlineColor(shape->getOutlineColor());
+					copy.setOutlineThickness(shape->getOutlineThickness());
+					copy.setOrigin(shape->getOrigin());
+					copy.setPosition(shape->getPosition());
+					copy.setRotation(shape->getRotation());
+					copy.setScale(shape->getScale());
+					item.kind = SnapshotDrawKind::Shape;
+					item.index = snapshot.shapes.size();
+					snapshot.shapes.push_back(move(copy));
+				}
+			}
+			snapshot.items.push_back(item);
+		}
+		endFrame();
+
+		//The window's view is only set by the render thread while pipelined, so the Screen's view is copied instead
+		snapshot.view = *screen->getCurrentView();
+		snapshot.camera = currentCamera->getMatrix();
+		snapshot.cameraPosition = currentCamera->getPosition();
+		snapshot.elapsedSec = time->getElapsedSec();
+		snapshot.extractClock.restart();
+	}
+
+	bool Renderer::drawSnapshot(RenderSnapshot& snapshot) {
+		try {
+			clearGL(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			window->setView(snapshot.view);
+			for (const SnapshotDrawItem& item : snapshot.items) {
+				if (item.boundsIndex >= 0) {
+					window->draw(snapshot.bounds[item.boundsIndex], item.transform);
+				}
+				switch (item.kind) {
+				case SnapshotDrawKind::Shape:
+					window->draw(snapshot.shapes[item.index], item.transform);
+					break;
+				case SnapshotDrawKind::Sprite:
+					window->draw(snapshot.sprites[item.index], item.transform);
+					break;
+				case SnapshotDrawKind::Text:
+					window->draw(snapshot.texts[item.index], item.transform);
+					break;
+				case SnapshotDrawKind::Mesh: {
+					SnapshotMesh& mesh = snapshot.meshes[item.index];
+					pullGL();
+					drawMesh(mesh.meshData, mesh.materials, mesh.model, mesh.animated ? &mesh.bones : nullptr, snapshot.camera, snapshot.cameraPosition, snapshot.elapsedSec);
+					commitGL();
+					break;
+				}
+				default:
+					break;
+				}
+			}
+			window->display();
+			return true;
+		} catch (const exception& ex) {
+			log(this, LogError, "Exception in drawSnapshot: {}", ex.what());
+			return false;
+		}
+	}
+
 	void Renderer::renderMesh(Mesh* mesh, MeshData* meshData, Transformation3D transform) {
 		if (!meshData || meshData->vertices.empty()) return;	//Don;t log, null MeshData Meshes are empty Bodies
 		if (!mesh) {
@@ -290,51 +548,57 @@ namespace CGEngine {
 
 		// Only proceed with mesh rendering if we have mesh data
 		if (meshData && meshData->vertices.size() > 0) {
-			GL_CHECK(glBindVertexArray(meshData->vao));
-			boundTextures = 0;
-			
-			// Get materials Mesh, ensuring at least one material is present
-			vector<id_t> modelMaterials = mesh->getMaterials();
-			if (modelMaterials.empty()) {
-				log(this, LogWarn, "No model materials in renderer. Using fallback.");
-				modelMaterials.push_back(assets.getDefaultId<Material>().value());
-			}
-			Material* renderMaterial = assets.get<Material>(modelMaterials.at(0));
-
-			//Update each model's animator, if present, once per frame (instead of once per mesh per model per frame)
-			Animator* animator = updateAnimator(mesh);
-
-			//Get the renderMaterial's program and bind it
-			Program* program = useRenderProgram(renderMaterial);
-			if (!program) return;
-
-			//Set the standard material uniform values
-			MaterialUBO materialUBOData = MaterialUBO();
-			setMaterialUBOData(materialUBOData, modelMaterials, program);
-			LightUBO lightUBOData = LightUBO();
-			setLightUBOData(lightUBOData);
-			TransformUBO transformUBOData = TransformUBO();
-			setTransformUBOData(transformUBOData, getBodyGlobalTransform(mesh->getBodyId()));
-			//If the mesh has bones, set the bone uniform values
+			//Animators were advanced at the start of the frame
+			Animator* animator = getAnimator(mesh);
+			vector<glm::mat4> bones;
 			if (animator) {
-				BoneUBO boneUBOData = BoneUBO();
-				setBoneUBOData(boneUBOData, animator);
+				bones = animator->getBoneMatrices();
 			}
-			program->setUniform("cameraPosition", toGlm(currentCamera->getPosition()));
-			program->setUniform("timeSec", time.getElapsedSec());
+			drawMesh(meshData, mesh->getMaterials(), getBodyGlobalTransform(mesh->getBodyId()), animator ? &bones : nullptr, currentCamera->getMatrix(), currentCamera->getPosition(), time->getElapsedSec());
+		}
+	}
 
-			//Draw the MeshData by index, if available, or by vertices
-			if (meshData->indices.size()) {
-				GL_CHECK(glDrawElements(GL_TRIANGLES, meshData->indices.size(), GL_UNSIGNED_INT, 0));
-			} else {
-				GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, meshData->vertices.size() / 5));
-			}
+	void Renderer::drawMesh(MeshData* meshData, vector<id_t> modelMaterials, const glm::mat4& model, const vector<glm::mat4>* bones, const glm::mat4& camera, Vector3f cameraPosition, sec_t timeSec) {
+		GL_CHECK(glBindVertexArray(meshData->vao));
+		boundTextures = 0;
 
-			// Unbind varray, shaders, and texture
-			glBindVertexArray(0);
-			glActiveTexture(GL_TEXTURE0);
-			program->stop();
+		// Get materials Mesh, ensuring at least one material is present
+		if (modelMaterials.empty()) {
+			log(this, LogWarn, "No model materials in renderer. Using fallback.");
+			modelMaterials.push_back(assets->getDefaultId<Material>().value());
 		}
+		Material* renderMaterial = assets->get<Material>(modelMaterials.at(0));
+
+		//Get the renderMaterial's program and bind it
+		Program* program = useRenderProgram(renderMaterial);
+		if (!program) return;
+
+		//Set the standard material uniform values
+		MaterialUBO materialUBOData = MaterialUBO();
+		setMaterialUBOData(materialUBOData, modelMaterials, program);
+		LightUBO lightUBOData = LightUBO();
+		setLightUBOData(lightUBOData);
+		TransformUBO transformUBOData = TransformUBO();
+		setTransformUBOData(transformUBOData, model, camera);
+		//If the mesh has bones, set the bone uniform values
+		if (bones != nullptr) {
+			BoneUBO boneUBOData = BoneUBO();
+			setBoneUBOData(boneUBOData, *bones);
+		}
+		program->setUniform("cameraPosition", toGlm(cameraPosition));
+		program->setUniform("timeSec", timeSec);
+
+		//Draw the MeshData by index, if available, or by vertices
+		if (meshData->indices.size()) {
+			GL_CHECK(glDrawElements(GL_TRIANGLES, meshData->indices.size(), GL_UNSIGNED_INT, 0));
+		} else {
+			GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, meshData->vertices.size() / 5));
+		}
+
+		// Unbind varray, shaders, and texture
+		glBindVertexArray(0);
+		glActiveTexture(GL_TEXTURE0);
+		program->stop();
 	}
 
 	void Renderer::endFrame() {
@@ -344,7 +608,7 @@ namespace CGEngine {
 	glm::mat4 Renderer::getBodyGlobalTransform(optional<id_t> bodyId) {
 		//Get the Mesh Body's transformation matrix
 		if (!bodyId.has_value()) return glm::mat4(1.0);
-		Body* meshBody = assets.get<Body>(bodyId.value());
+		Body* meshBody = assets->get<Body>(bodyId.value());
 		if (!meshBody) {
 			log(this, LogError, "Mesh Body is null in renderMesh");
 			return glm::mat4(1.0);
@@ -356,9 +620,8 @@ namespace CGEngine {
 		glm::mat4 localTransform = glm::mat4(1.0f);
 
 		// Get mesh transform if available
-		Mesh* mesh = body->get<Mesh*>();
-		if (mesh) {
-			localTransform = mesh->getModelMatrix();
+		if (body->components == ComponentMesh) {
+			localTransform = static_cast<Mesh*>(body->entity)->getModelMatrix();
 		}
 
 		// Combine with parent transform
@@ -369,22 +632,24 @@ namespace CGEngine {
 		return localTransform;
 	};
 
-	Animator* Renderer::updateAnimator(Mesh* mesh) {
-		//Update each model's animator, if present, once per frame (instead of once per mesh per model per frame)
-		Animator* animator = nullptr;
-		optional<id_t> meshModelId = mesh->getModelId();
-		if (meshModelId.has_value()) {
-			Model* meshModel = assets.get<Model>(meshModelId.value());
-			// Only update animation once per model per frame
-			if (meshModel && updatedModels.find(meshModelId.value()) == updatedModels.end()) {
-				animator = meshModel->getAnimator();
-				if (animator) {
-					animator->updateAnimation(time.getDeltaSec());
-					updatedModels.insert(meshModelId.value());
-				}
+	void Renderer::updateAnimators() {
+		//Advance each rendered Model's animator once per frame, iterating the dense Mesh rows instead of the draw order
+		world->getArchetypes().forEach(ComponentMesh, [this](Body* body, Transformable* entity, const BodyFlags& flags) {
+			if (!flags.rendering || body->isDestroyed()) return;
+			optional<id_t> meshModelId = static_cast<Mesh*>(entity)->getModelId();
+			if (!meshModelId.has_value() || !updatedModels.insert(meshModelId.value()).second) return;
+			Model* meshModel = assets->get<Model>(meshModelId.value());
+			if (meshModel && meshModel->getAnimator()) {
+				meshModel->getAnimator()->updateAnimation(time->getDeltaSec());
 			}
-		}
-		return animator;
+		});
+	}
+
+	Animator* Renderer::getAnimator(Mesh* mesh) {
+		optional<id_t> meshModelId = mesh->getModelId();
+		if (!meshModelId.has_value()) return nullptr;
+		Model* meshModel = assets->get<Model>(meshModelId.value());
+		return meshModel ? meshModel->getAnimator() : nullptr;
 	}
 
 	Program* Renderer::useRenderProgram(Material* renderMaterial) {
@@ -414,9 +679,9 @@ namespace CGEngine {
 		static MaterialUBO previousMaterialUBOData;
 		bool materialChanged = false;
 		
-		for (int i = 0; i < modelMaterials.size(); ++i) {
+		for (size_t i = 0; i < modelMaterials.size(); ++i) {
 			//Get the material
-			Material* material = assets.get<Material>(modelMaterials.at(i));
+			Material* material = assets->get<Material>(modelMaterials.at(i));
 			if (!material) continue;
 			optional<ParamData> paramData = nullopt;
 			//For diffuse, specular and opacity textures: Get the texture data, if available, and bind it to the shader, then set the materialTextures[i].diff/spec/opacityTexture uniform
@@ -484,9 +749,9 @@ namespace CGEngine {
 		static LightUBO previousLightUBOData;
 		bool lightChanged = false;
 
-		lightUBOData.lightCount = assets.getResourceCount<Light>();
-		for (size_t i = 0; i < assets.getResourceCount<Light>(); ++i) {
-			Light* light = assets.get<Light>(i);
+		lightUBOData.lightCount = assets->getResourceCount<Light>();
+		for (size_t i = 0; i < assets->getResourceCount<Light>(); ++i) {
+			Light* light = assets->get<Light>(i);
 			lightUBOData.lights[i].position = light->position;
 			lightUBOData.lights[i].brightness = light->parameters.brightness;
 			lightUBOData.lights[i].intensities = glm::vec4(toGlm(light->parameters.colorIntensities), 1);
@@ -508,23 +773,22 @@ namespace CGEngine {
 		}
 	}
 
-	void Renderer::setBoneUBOData(BoneUBO boneUBOData, Animator* animator) {
-		vector<glm::mat4> transforms = animator->getBoneMatrices();
-		for (int i = 0; i < transforms.size(); ++i) {
+	void Renderer::setBoneUBOData(BoneUBO boneUBOData, const vector<glm::mat4>& transforms) {
+		for (size_t i = 0; i < transforms.size(); ++i) {
 			boneUBOData.boneMatrices[i] = transforms[i];
 		}
 		boneUBOData.boneCount = transforms.size();
 		updateBoneUBO(boneUBOData);
 	}
 
-	void Renderer::setTransformUBOData(TransformUBO transformUBOData, glm::mat4 combinedTransform) {
+	void Renderer::setTransformUBOData(TransformUBO transformUBOData, glm::mat4 combinedTransform, glm::mat4 camera) {
 		transformUBOData.model = combinedTransform;
-		transformUBOData.camera = currentCamera->getMatrix();
+		transformUBOData.camera = camera;
 		updateTransformUBO(transformUBOData);
 	}
 
 	void Renderer::setMaterialUniforms(id_t materialAssetId, Program* program, int materialId) {
-		Material* material = assets.get<Material>(materialAssetId);
+		Material* material = assets->get<Material>(materialAssetId);
 		if (!material) return;
 		for (auto iterator = material->materialParameters.begin(); iterator != material->materialParameters.end(); ++iterator) {
 			string paramName = (*iterator).first;
@@ -640,28 +904,54 @@ namespace CGEngine {
 		return ss.str();
 	}
 
+	void Renderer::collectRenderBodies() {
+		//Walk the World's flattened hierarchy, combining each global transform with its parent's already computed one
+		const vector<BodyTraversalEntry>& order = world->getTraversalOrder();
+		globalTransforms.resize(order.size());
+		//Bodies captured before the latest fixed step are drawn between their last two fixed step states
+		size_t lastFixedStep = time->getFixedStepCount();
+		bool interpolate = interpolationEnabled && lastFixedStep > 0;
+		float alpha = time->getInterpolationAlpha();
+		for (size_t i = 0; i < order.size();) {
+			const BodyTraversalEntry& entry = order[i];
+			Body* body = entry.body;
+			//Unregistered and destroyed Bodies are skipped along with their children
+			if (!body->getId().has_value() || body->destroyed) {
+				i += entry.subtreeSize;
+				continue;
+			}
+			//The root's transform is not applied to its children, matching Body::getGlobalTransform
+			globalTransforms[i] = interpolate && body->previousState.fixedStep == lastFixedStep ? body->getInterpolatedTransform(alpha) : body->getTransform();
+			if (entry.parentIndex > 0) {
+				globalTransforms[i].combine(globalTransforms[entry.parentIndex]);
+			}
+			add(body->getId().value(), globalTransforms[i]);
+			i++;
+		}
+	}
+
 	void Renderer::add(id_t bodyId, Transform transform) {
-		renderOrder.push_back(bodyId);
+		renderOrder.emplace_back(bodyId, transform);
 	}
 
 	int Renderer::zMax() {
-		Body* body = assets.get<Body>(renderOrder.back());
+		Body* body = assets->get<Body>(renderOrder.back().bodyId);
 		return body->zOrder;
 	}
 
 	int Renderer::zMin() {
-		Body* body = assets.get<Body>(renderOrder.back());
+		Body* body = assets->get<Body>(renderOrder.back().bodyId);
 		return body->zOrder;
 	}
 
 	vector<id_t> Renderer::getZBodies(int zIndex) {
 		vector<id_t> bodies;
 		bool found = false;
-		for (int i = 0; i < renderOrder.size(); ++i) {
-			Body* body = assets.get<Body>(renderOrder.at(i));
+		for (size_t i = 0; i < renderOrder.size(); ++i) {
+			Body* body = assets->get<Body>(renderOrder.at(i).bodyId);
 			if (body->zOrder == zIndex) {
 				found = true;
-				bodies.push_back(renderOrder.at(i));
+				bodies.push_back(renderOrder.at(i).bodyId);
 			}
 			else if (found) {
 				break;
@@ -672,11 +962,10 @@ namespace CGEngine {
 
 	vector<id_t> Renderer::getLowerZBodies(int zIndex) {
 		vector<id_t> bodies;
-		bool found = false;
-		for (int i = 0; i < renderOrder.size(); ++i) {
-			Body* body = assets.get<Body>(renderOrder.at(i));
+		for (size_t i = 0; i < renderOrder.size(); ++i) {
+			Body* body = assets->get<Body>(renderOrder.at(i).bodyId);
 			if (body->zOrder < zIndex) {
-				bodies.push_back(renderOrder.at(i));
+				bodies.push_back(renderOrder.at(i).bodyId);
 			}
 			else {
 				break;
@@ -687,11 +976,10 @@ namespace CGEngine {
 
 	vector<id_t> Renderer::getHigherZBodies(int zIndex) {
 		vector<id_t> bodies;
-		bool found = false;
 		for (int i = renderOrder.size() - 1; i >= 0; --i) {
-			Body* body = assets.get<Body>(renderOrder.at(i));
+			Body* body = assets->get<Body>(renderOrder.at(i).bodyId);
 			if (body->zOrder > zIndex) {
-				bodies.push_back(renderOrder.at(i));
+				bodies.push_back(renderOrder.at(i).bodyId);
 			}
 			else {
 				break;
@@ -705,7 +993,7 @@ namespace CGEngine {
 	}
 	
 	void Renderer::sortZ() {
-		sort(renderOrder.begin(), renderOrder.end(), [](id_t a, id_t b) { return (assets.get<Body>(a)->zOrder < assets.get<Body>(b)->zOrder); });
+		sort(renderOrder.begin(), renderOrder.end(), [](const RenderOrderEntry& a, const RenderOrderEntry& b) { return (assets->get<Body>(a.bodyId)->zOrder < assets->get<Body>(b.bodyId)->zOrder); });
 	}
 
 	void Renderer::render(RenderTarget* window) {
@@ -716,11 +1004,19 @@ namespace CGEngine {
 
 		//Draw each body with its calculated transform
 		for (auto iterator = renderOrder.begin(); iterator != renderOrder.end(); ++iterator) {
-			Body* body = assets.get<Body>(*iterator);
-			body->onDraw(*window, body->getGlobalTransform());
+			Body* body = assets->get<Body>(iterator->bodyId);
+			body->onDraw(*window, iterator->transform);
 		}
 	}
 
+	void Renderer::setInterpolationEnabled(bool enabled) {
+		interpolationEnabled = enabled;
+	}
+
+	bool Renderer::getInterpolationEnabled() const {
+		return interpolationEnabled;
+	}
+
 	Camera* Renderer::getCurrentCamera() {
 		return currentCamera.get();
 	}
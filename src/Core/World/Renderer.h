@@ -10,6 +10,11 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
 #include "../Body/Body.h"
 #include "../Camera/Camera.h"
 #include "../Shader/Shader.h"
@@ -30,6 +35,7 @@ namespace CGEngine {
 	class Animation;
 	class Animator;
 	class Model;
+	class EngineContext;
 
 	struct VertexData {
 		VertexData() {
@@ -106,6 +112,82 @@ namespace CGEngine {
 		float timeStamp;
 	};
 
+	/// <summary>
+	/// A Body in the render order, with the global transform it's drawn with this frame
+	/// </summary>
+	struct RenderOrderEntry {
+		RenderOrderEntry(id_t bodyId, const Transform& transform) :bodyId(bodyId), transform(transform) {};
+		id_t bodyId;
+		Transform transform;
+	};
+
+	enum class SnapshotDrawKind { None, Shape, Sprite, Text, Mesh };
+
+	/// <summary>
+	/// A Body to draw from a RenderSnapshot. The index refers to the snapshot's array for the kind.
+	/// </summary>
+	struct SnapshotDrawItem {
+		Transform transform;
+		int boundsIndex = -1;
+		SnapshotDrawKind kind = SnapshotDrawKind::None;
+		size_t index = 0;
+	};
+
+	/// <summary>
+	/// The Mesh state read when drawing, copied at extraction
+	/// </summary>
+	struct SnapshotMesh {
+		MeshData* meshData = nullptr;
+		vector<id_t> materials;
+		glm::mat4 model = glm::mat4(1.0f);
+		/// <summary>
+		/// The bone matrices of the Mesh's Model, if its animator was advanced for this Mesh
+		/// </summary>
+		bool animated = false;
+		vector<glm::mat4> bones;
+	};
+
+	/// <summary>
+	/// A copy of everything needed to draw a frame, extracted on the main thread at the end of the update so the render thread
+	/// can draw it while the next frame is simulated. Shapes are copied as ConvexShapes with the same points.
+	/// </summary>
+	struct RenderSnapshot {
+		vector<SnapshotDrawItem> items;
+		vector<RectangleShape> bounds;
+		vector<ConvexShape> shapes;
+		vector<Sprite> sprites;
+		vector<Text> texts;
+		vector<SnapshotMesh> meshes;
+		View view;
+		glm::mat4 camera = glm::mat4(1.0f);
+		Vector3f cameraPosition;
+		sec_t elapsedSec = 0;
+		/// <summary>
+		/// Restarted when the snapshot is extracted, to measure the latency until it's displayed
+		/// </summary>
+		Clock extractClock;
+
+		void clear() {
+			items.clear();
+			bounds.clear();
+			shapes.clear();
+			sprites.clear();
+			texts.clear();
+			meshes.clear();
+		}
+	};
+
+	/// <summary>
+	/// Average pipelined rendering timings, in milliseconds, since pipelining was enabled
+	/// </summary>
+	struct PipelineStats {
+		size_t frames = 0;
+		float extractMs = 0;
+		float waitMs = 0;
+		float renderMs = 0;
+		float latencyMs = 0;
+	};
+
 	/// <summary>
 	/// Responsible for ordering Bodies for rendering. Allows for default ordering (children render on top of parents)
 	/// modified with per-object Z-Order
@@ -118,13 +200,17 @@ namespace CGEngine {
 		}
 
 		~Renderer() {
-			glDeleteBuffers(1, &materialUBO);
-			glDeleteBuffers(1, &lightUBO);
-			glDeleteBuffers(1, &boneUBO);
-			glDeleteBuffers(1, &transformUBO);
+			setPipelinedEnabled(false);
+			//Headless contexts never create the buffers
+			if (transformUBO != 0) {
+				glDeleteBuffers(1, &materialUBO);
+				glDeleteBuffers(1, &lightUBO);
+				glDeleteBuffers(1, &boneUBO);
+				glDeleteBuffers(1, &transformUBO);
+			}
 		}
 		/// <summary>
-		/// Add the Body to the renderOrder and and it and its transform to the bodyTransform map for this frame
+		/// Add the Body and its transform to the renderOrder for this frame
 		/// </summary>
 		/// <param name="body">The Body to add to the Renderer</param>
 		/// <param name="transform">The transform of the Body</param>
@@ -160,14 +246,44 @@ namespace CGEngine {
 
 		void initializeOpenGL();
 		bool setGLWindowState(bool state);
+		/// <summary>
+		/// Run the OpenGL command with the window's context active. While pipelined rendering is enabled, commands from other threads are queued
+		/// and run on the render thread, in the order they were queued, before it draws the next snapshot.
+		/// </summary>
+		/// <param name="command">The OpenGL calls to make, such as creating buffers, textures or programs</param>
+		void runGL(function<void()> command);
 		bool clearGL(GLbitfield mask);
 		void commitGL();
 		void pullGL();
 
 		bool processRender();
+		/// <summary>
+		/// Extract a snapshot of the frame and hand it to the render thread, after it finishes drawing the previous frame
+		/// </summary>
+		/// <returns>False if the render thread failed to draw the previous frame</returns>
+		bool processPipelinedRender();
+		/// <summary>
+		/// If enabled, frames are drawn on a render thread from a snapshot extracted at the end of each update, so the next frame is
+		/// simulated while the previous one is drawn. Frames are displayed one frame later. OpenGL calls are only allowed on the render thread while enabled,
+		/// so OpenGL resources are created through runGL.
+		/// </summary>
+		/// <param name="enabled">Whether to render on a render thread</param>
+		void setPipelinedEnabled(bool enabled);
+		bool getPipelinedEnabled() const;
+		PipelineStats getPipelineStats() const;
+		/// <summary>
+		/// Return the average frame time (in milliseconds) with or without pipelined rendering, to compare their throughput
+		/// </summary>
+		float getAverageFrameMs(bool pipelined) const;
 		void setWindow(RenderWindow* window);
 		Camera* getCurrentCamera();
 		void setCurrentCamera(unique_ptr<Camera> camera);
+		/// <summary>
+		/// If enabled, Bodies moved by fixed update scripts are drawn between their last two fixed steps, so motion stays smooth when the frame rate and fixed step rate differ
+		/// </summary>
+		/// <param name="enabled">Whether to interpolate Body transforms</param>
+		void setInterpolationEnabled(bool enabled);
+		bool getInterpolationEnabled() const;
 
 		void renderMesh(Mesh* mesh, MeshData* meshData, Transformation3D transform);
 		void getModelData(Mesh* mesh);
@@ -193,7 +309,7 @@ namespace CGEngine {
 		/// </summary>
 		RenderWindow* window = nullptr;
 		/// <summary>
-		/// Clear the renderOrder and bodyTransform map
+		/// Clear the renderOrder
 		/// </summary>
 		void clear();
 		/// <summary>
@@ -205,15 +321,65 @@ namespace CGEngine {
 		/// </summary>
 		/// <param name="window">The RenderTarget to draw the Body in</param>
 		void render(RenderTarget* window);
+		/// <summary>
+		/// Add each rendered Body to the render order in a single pass over the World's flattened hierarchy
+		/// </summary>
+		void collectRenderBodies();
+		/// <summary>
+		/// Global transforms by flattened hierarchy index, reused each frame
+		/// </summary>
+		vector<Transform> globalTransforms;
+		bool interpolationEnabled = true;
+
+		//Pipelined rendering
+		bool pipelined = false;
+		thread renderThread;
+		atomic<thread::id> renderThreadId;
+		mutex pipelineMutex;
+		condition_variable pipelineCondition;
+		bool renderPending = false;
+		bool renderFailed = false;
+		bool stopRendering = false;
+		RenderSnapshot snapshots[2];
+		size_t frontSnapshot = 0;
+		PipelineStats pipelineStats;
+		/// <summary>
+		/// OpenGL commands queued from other threads while pipelined, run by the render thread
+		/// </summary>
+		vector<function<void()>> glCommands;
+		mutex glCommandMutex;
+		void drainGLCommands();
+		/// <summary>
+		/// Total frame seconds and frame counts without [0] and with [1] pipelined rendering
+		/// </summary>
+		sec_t frameSec[2] = { 0,0 };
+		size_t frameCounts[2] = { 0,0 };
+		/// <summary>
+		/// Draw snapshots as they're handed over until stopped. Runs on the render thread, with the context that enabled pipelining current.
+		/// </summary>
+		void runRenderThread(EngineContext* context);
+		/// <summary>
+		/// Copy the Bodies to draw this frame, with their transforms, entities, and Mesh state, into the snapshot
+		/// </summary>
+		void extractSnapshot(RenderSnapshot& snapshot);
+		/// <summary>
+		/// Draw and display the snapshot
+		/// </summary>
+		bool drawSnapshot(RenderSnapshot& snapshot);
+		/// <summary>
+		/// Add the last frame's time to the frame statistics of the current mode
+		/// </summary>
+		void recordFrameTime();
 
 		/// <summary>
 		/// The current render camera. This is set during OpenGL initialization and used to set the view matrix for the shader program.
 		/// </summary>
 		unique_ptr<Camera> currentCamera = nullptr;
 		/// <summary>
-		/// The order in which to draw bodies, with Bodies further back in the vector drawn on top of other Bodies. This is cleared and re-calculated each frame
+		/// The order in which to draw bodies, with Bodies further back in the vector drawn on top of other Bodies, each with the global transform
+		/// it's drawn with. This is cleared and re-calculated each frame
 		/// </summary>
-		vector<id_t> renderOrder;
+		vector<RenderOrderEntry> renderOrder;
 		/// <summary>
 		/// If enabled, Bodies are sorted by their zOrder before rendering each frame.
 		/// </summary>
@@ -234,10 +400,10 @@ namespace CGEngine {
 		glm::mat4 getBodyGlobalTransform(optional<id_t> bodyId);
 
 		// UBOs
-		GLuint materialUBO;
-		GLuint lightUBO;
-		GLuint boneUBO;
-		GLuint transformUBO;
+		GLuint materialUBO = 0;
+		GLuint lightUBO = 0;
+		GLuint boneUBO = 0;
+		GLuint transformUBO = 0;
 
 		void updateMaterialUBO(const MaterialUBO& materialData);
 		void updateLightUBO(const LightUBO& lightData);
@@ -246,9 +412,20 @@ namespace CGEngine {
 		void bindTextureAndSetUniform(Material* material, const string& paramName, Program* program, int materialIndex, int& boundTextures);
 		void setMaterialUBOData(MaterialUBO materialUBOData, vector<id_t> modelMaterials, Program* program);
 		void setLightUBOData(LightUBO lightUBOData);
-		void setBoneUBOData(BoneUBO boneUBOData, Animator* animator);
-		void setTransformUBOData(TransformUBO transformUBOData, glm::mat4 combinedTransform);
-		Animator* updateAnimator(Mesh* mesh);
+		void setBoneUBOData(BoneUBO boneUBOData, const vector<glm::mat4>& transforms);
+		void setTransformUBOData(TransformUBO transformUBOData, glm::mat4 combinedTransform, glm::mat4 camera);
+		/// <summary>
+		/// Draw the MeshData with its materials, model matrix and, if not null, its Model's bone matrices
+		/// </summary>
+		void drawMesh(MeshData* meshData, vector<id_t> modelMaterials, const glm::mat4& model, const vector<glm::mat4>* bones, const glm::mat4& camera, Vector3f cameraPosition, sec_t timeSec);
+		/// <summary>
+		/// Advance the animator of each Model with a rendered Mesh, once per frame
+		/// </summary>
+		void updateAnimators();
+		/// <summary>
+		/// Return the animator of the Mesh's Model, or nullptr if it has none
+		/// </summary>
+		Animator* getAnimator(Mesh* mesh);
 		Program* useRenderProgram(Material* renderMaterial);
 	};
 }
\ No newline at end of file
@@ -89,13 +89,22 @@ namespace CGEngine {
         float viewportSizeY = min(1.f, size.x / size.y);
         float viewportSizeX = min(1.f, size.y / size.x);
         float minDim = min(size.x, size.y);
-        float ratioX = (1-(minDim /window->getSize().x))/2.f;
-        float ratioY = (1-(minDim / window->getSize().y)) / 2.f;
+        //Without a window (headless), the view is laid out over the Screen size
+        Vector2f windowSize = window != nullptr ? Vector2f(window->getSize()) : Vector2f(size);
+        float ratioX = (1-(minDim / windowSize.x))/2.f;
+        float ratioY = (1-(minDim / windowSize.y)) / 2.f;
         //Puts the origin in the view left corner (by default) and squares the view
         currentView = new View({minDim/2,minDim/2}, {minDim, minDim});
         //Squares the viewport and centers it
         currentView->setViewport(FloatRect({ Vector2f({ratioX,ratioY}),{viewportSizeX,viewportSizeY} }));
-        window->setView(*currentView);
+        applyView();
+    }
+
+    void Screen::applyView() {
+        //While rendering is pipelined, the view is copied into each frame's snapshot instead
+        if (window != nullptr && !renderer->getPipelinedEnabled()) {
+            window->setView(*currentView);
+        }
     }
 
     View* Screen::getCurrentView() {
@@ -112,23 +121,31 @@ namespace CGEngine {
 
     void Screen::moveView(Vector2f delta) {
         currentView->move(delta);
-        window->setView(*currentView);
+        applyView();
     }
 
     void Screen::rotateView(Angle delta) {
         currentView->rotate(delta);
-        window->setView(*currentView);
+        applyView();
     }
 
     void Screen::zoomView(float delta) {
         currentView->zoom(delta);
-        window->setView(*currentView);
+        applyView();
     }
 
     Vector2f Screen::viewToGlobal(Vector2i pixels) {
         if (window != nullptr) {
             return window->mapPixelToCoords(pixels);
         }
+        if (currentView != nullptr) {
+            //Map through the view the same way the window would, treating the Screen size as the window size
+            FloatRect viewport = currentView->getViewport();
+            Vector2f viewportPosition = { viewport.position.x * size.x, viewport.position.y * size.y };
+            Vector2f viewportSize = { viewport.size.x * size.x, viewport.size.y * size.y };
+            Vector2f normalized = { -1.f + 2.f * (pixels.x - viewportPosition.x) / viewportSize.x, 1.f - 2.f * (pixels.y - viewportPosition.y) / viewportSize.y };
+            return currentView->getInverseTransform().transformPoint(normalized);
+        }
         return Vector2f();
     }
 }
\ No newline at end of file
@@ -56,5 +56,7 @@ namespace CGEngine {
         //Current View
         View* currentView = nullptr;
         void initView();
+        //Set the current view on the window, if there is one
+        void applyView();
     };
 }
\ No newline at end of file
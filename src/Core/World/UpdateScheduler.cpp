@@ -0,0 +1,167 @@
+#include "UpdateScheduler.h"
+#include "../Engine/Engine.h"
+
+namespace CGEngine {
+    UpdateScheduler::UpdateScheduler() {
+        init();
+        //The engine's update domain keeps running every frame unless it is given another policy
+        domains.push_back({ onUpdateDomain, { UpdatePriority::Critical, 0 }, true, {} });
+    }
+
+    void UpdateScheduler::setPolicy(domainId_t domainId, UpdatePolicy policy) {
+        //Reuse the domain's entry if it was removed
+        for (ScheduledDomain& domain : domains) {
+            if (domain.domainId == domainId) {
+                domain.policy = policy;
+                domain.active = true;
+                return;
+            }
+        }
+        domains.push_back({ domainId, policy, true, {} });
+    }
+
+    void UpdateScheduler::setPolicy(const string& domainName, UpdatePolicy policy) {
+        setPolicy(DomainRegistry::intern(domainName), policy);
+    }
+
+    void UpdateScheduler::removePolicy(domainId_t domainId) {
+        if (ScheduledDomain* domain = findDomain(domainId)) {
+            domain->active = false;
+            domain->lastCalls.clear();
+        }
+    }
+
+    optional<UpdatePolicy> UpdateScheduler::getPolicy(domainId_t domainId) const {
+        const ScheduledDomain* domain = findDomain(domainId);
+        return domain != nullptr ? optional<UpdatePolicy>(domain->policy) : nullopt;
+    }
+
+    bool UpdateScheduler::isScheduled(domainId_t domainId) const {
+        return findDomain(domainId) != nullptr;
+    }
+
+    void UpdateScheduler::setFrameBudget(float budgetMs) {
+        frameBudgetMs = max(budgetMs, 0.f);
+    }
+
+    float UpdateScheduler::getFrameBudget() const {
+        return frameBudgetMs;
+    }
+
+    void UpdateScheduler::setOffscreenRateScale(float scale) {
+        offscreenRateScale = clamp(scale, 0.f, 1.f);
+    }
+
+    float UpdateScheduler::getOffscreenRateScale() const {
+        return offscreenRateScale;
+    }
+
+    void UpdateScheduler::run() {
+        for (size_t i = 0; i < domains.size(); i++) {
+            if (domains[i].active && domains[i].policy.priority == UpdatePriority::Critical) {
+                world->callScripts(domains[i].domainId);
+            }
+        }
+
+        Clock runClock;
+        sec_t now = time->getElapsedSec();
+        optional<FloatRect> viewBounds = getViewBounds();
+        size_t called = 0;
+        size_t deferred = 0;
+        sec_t maxStaleness = 0;
+        for (UpdatePriority priority : { UpdatePriority::High, UpdatePriority::Normal, UpdatePriority::Low }) {
+            collectDue(priority, now, viewBounds);
+            for (const DueCall& due : dueCalls) {
+                maxStaleness = max(maxStaleness, due.staleness);
+                bool budgeted = priority != UpdatePriority::High && frameBudgetMs > 0;
+                if (budgeted && runClock.getElapsedTime().asMicroseconds() / 1000.f >= frameBudgetMs) {
+                    deferred++;
+                    continue;
+                }
+                ScheduledDomain& domain = domains[due.domainIndex];
+                //An earlier call may have deleted or unsubscribed the Body
+                if (!world->shouldCallSubscriber(due.body, domain.domainId)) continue;
+                domain.lastCalls[due.body] = now;
+                due.body->callScripts(domain.domainId);
+                called++;
+            }
+        }
+        lastCalledCount = called;
+        lastDeferredCount = deferred;
+        lastMaxStaleness = maxStaleness;
+        lastRunMs = runClock.getElapsedTime().asMicroseconds() / 1000.f;
+        if (deferred > 0) {
+            log(this, LogDebug, "Deferred {} updates. Most stale was {}s", deferred, maxStaleness);
+        }
+    }
+
+    void UpdateScheduler::collectDue(UpdatePriority priority, sec_t now, const optional<FloatRect>& viewBounds) {
+        dueCalls.clear();
+        for (size_t i = 0; i < domains.size(); i++) {
+            ScheduledDomain& domain = domains[i];
+            if (!domain.active || domain.policy.priority != priority) continue;
+            World::DomainSubscribers* subscribers = world->getSubscribers(domain.domainId);
+            if (subscribers == nullptr) continue;
+            sec_t interval = domain.policy.targetRate > 0 ? 1.f / domain.policy.targetRate : 0;
+            for (Body* body : subscribers->bodies) {
+                if (!world->shouldCallSubscriber(body, domain.domainId)) continue;
+                sec_t bodyInterval = interval;
+                if (viewBounds.has_value() && !viewBounds->findIntersection(body->getGlobalBounds()).has_value()) {
+                    if (offscreenRateScale <= 0) continue;
+                    //Bodies outside the view are due at a fraction of the target rate, or at that fraction of frames when it is 0
+                    bodyInterval = interval > 0 ? interval / offscreenRateScale : time->getDeltaSec() / offscreenRateScale;
+                }
+                auto lastCall = domain.lastCalls.find(body);
+                sec_t staleness = lastCall != domain.lastCalls.end() ? now - lastCall->second : bodyInterval;
+                if (staleness < bodyInterval) continue;
+                dueCalls.push_back({ i, body, staleness, staleness - bodyInterval });
+            }
+        }
+        sort(dueCalls.begin(), dueCalls.end(), [](const DueCall& a, const DueCall& b) { return a.overdue > b.overdue; });
+    }
+
+    optional<FloatRect> UpdateScheduler::getViewBounds() const {
+        View* view = screen != nullptr ? screen->getCurrentView() : nullptr;
+        if (view == nullptr) return nullopt;
+        Vector2f size = view->getSize();
+        float radius = sqrt(size.x * size.x + size.y * size.y) / 2.f;
+        Vector2f center = view->getCenter();
+        return FloatRect({ center.x - radius, center.y - radius }, { radius * 2.f, radius * 2.f });
+    }
+
+    void UpdateScheduler::forget(Body* body) {
+        for (ScheduledDomain& domain : domains) {
+            domain.lastCalls.erase(body);
+        }
+    }
+
+    UpdateScheduler::ScheduledDomain* UpdateScheduler::findDomain(domainId_t domainId) {
+        for (ScheduledDomain& domain : domains) {
+            if (domain.domainId == domainId && domain.active) return &domain;
+        }
+        return nullptr;
+    }
+
+    const UpdateScheduler::ScheduledDomain* UpdateScheduler::findDomain(domainId_t domainId) const {
+        for (const ScheduledDomain& domain : domains) {
+            if (domain.domainId == domainId && domain.active) return &domain;
+        }
+        return nullptr;
+    }
+
+    size_t UpdateScheduler::getLastCalledCount() const {
+        return lastCalledCount;
+    }
+
+    size_t UpdateScheduler::getLastDeferredCount() const {
+        return lastDeferredCount;
+    }
+
+    sec_t UpdateScheduler::getLastMaxStaleness() const {
+        return lastMaxStaleness;
+    }
+
+    float UpdateScheduler::getLastRunMs() const {
+        return lastRunMs;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "SFML/Graphics.hpp"
+#include "../Types/Types.h"
+#include "../Engine/EngineSystem.h"
+#include "../Scripts/DomainRegistry.h"
+using namespace sf;
+using namespace std;
+
+namespace CGEngine {
+    class Body;
+
+    /// <summary>
+    /// Critical update domains are called on every subscriber each frame. High priority domains are called on each subscriber that is due.
+    /// Normal and then low priority domains are called on due subscribers until the frame budget is spent, and the rest are deferred.
+    /// </summary>
+    enum class UpdatePriority { Critical, High, Normal, Low };
+
+    struct UpdatePolicy {
+        UpdatePriority priority = UpdatePriority::Normal;
+        /// <summary>
+        /// Calls per second on each subscriber. If 0, subscribers are due every frame.
+        /// </summary>
+        float targetRate = 0;
+    };
+
+    /// <summary>
+    /// Calls the World's update domains each frame by their UpdatePolicy. The engine's update domain is critical, so it is called every frame
+    /// as before. Other domains given a policy are called at their target rate, with Bodies outside the view called at a fraction of it, and
+    /// normal and low priority calls are spread across frames under a per-frame budget. Subscribers that are the most overdue are called first,
+    /// so a deferred subscriber is only deferred until it becomes the most overdue.
+    /// </summary>
+    class UpdateScheduler : public EngineSystem {
+    public:
+        UpdateScheduler();
+        /// <summary>
+        /// Schedule the domain with the policy. The domain is called by the scheduler from then on.
+        /// </summary>
+        /// <param name="domainId">The interned domain id</param>
+        /// <param name="policy">The domain's priority and target rate</param>
+        void setPolicy(domainId_t domainId, UpdatePolicy policy);
+        void setPolicy(const string& domainName, UpdatePolicy policy);
+        /// <summary>
+        /// Stop scheduling the domain
+        /// </summary>
+        void removePolicy(domainId_t domainId);
+        optional<UpdatePolicy> getPolicy(domainId_t domainId) const;
+        bool isScheduled(domainId_t domainId) const;
+        /// <summary>
+        /// Set the milliseconds of normal and low priority calls run per frame. If 0, the time isn't limited.
+        /// </summary>
+        void setFrameBudget(float budgetMs);
+        float getFrameBudget() const;
+        /// <summary>
+        /// Set the fraction of its target rate a non-critical domain is called at on Bodies outside the view. If 0, they aren't called.
+        /// </summary>
+        void setOffscreenRateScale(float scale);
+        float getOffscreenRateScale() const;
+        /// <summary>
+        /// Call the scheduled domains. Called by the World each frame in place of calling the update domain.
+        /// </summary>
+        void run();
+        /// <summary>
+        /// Forget the Body's last update times. Called when the Body is deleted.
+        /// </summary>
+        void forget(Body* body);
+        /// <summary>
+        /// Return the number of scheduled calls run and deferred by the last frame
+        /// </summary>
+        size_t getLastCalledCount() const;
+        size_t getLastDeferredCount() const;
+        /// <summary>
+        /// Return the longest time, in seconds, a due subscriber had gone without being called in the last frame
+        /// </summary>
+        sec_t getLastMaxStaleness() const;
+        /// <summary>
+        /// Return the milliseconds the last frame's non-critical calls took
+        /// </summary>
+        float getLastRunMs() const;
+    private:
+        struct ScheduledDomain {
+            domainId_t domainId = 0;
+            UpdatePolicy policy;
+            bool active = true;
+            //Time each subscriber was last called
+            unordered_map<Body*, sec_t> lastCalls;
+        };
+        struct DueCall {
+            size_t domainIndex = 0;
+            Body* body = nullptr;
+            sec_t staleness = 0;
+            sec_t overdue = 0;
+        };
+
+        //Removed domains are kept inactive, so indices stay valid while scripts change policies during run
+        vector<ScheduledDomain> domains;
+        vector<DueCall> dueCalls;
+        float frameBudgetMs = 2.f;
+        float offscreenRateScale = 0.25f;
+        size_t lastCalledCount = 0;
+        size_t lastDeferredCount = 0;
+        sec_t lastMaxStaleness = 0;
+        float lastRunMs = 0;
+
+        ScheduledDomain* findDomain(domainId_t domainId);
+        const ScheduledDomain* findDomain(domainId_t domainId) const;
+        //Add the due subscribers of the priority's domains to dueCalls, most overdue first
+        void collectDue(UpdatePriority priority, sec_t now, const optional<FloatRect>& viewBounds);
+        //Return the bounds of the current view, widened to contain it at any rotation
+        optional<FloatRect> getViewBounds() const;
+    };
+}
@@ -1,27 +1,29 @@
 #include "World.h"
 #include "../Engine/Engine.h"
+#include "../Scene/SceneStreamer.h"
 #include "../../Standard/Models/CommonModels.h"
 
 namespace CGEngine {
-    World::World() : root(assets.get<Body>(assets.create<Body>("Root", true).value())) {
+    World::World() : root(assets->get<Body>(assets->create<Body>("Root", true).value())) {
 		if (root == nullptr) {
 			log(this, LogError, "Failed to create root body");
         } else {
 			log(this, LogInfo, "Created root body with ID: {}", root->getId());
         }
+        sceneStreamer = new SceneStreamer();
         init();
     }
 
     void World::initializeConsole() {
         if (!consoleInitialized && consoleFeatureEnabled) {
-            Font* defaultFont = assets.get<FontResource>(assets.getDefaultId<FontResource>().value())->getFont();
+            Font* defaultFont = assets->get<FontResource>(assets->getDefaultId<FontResource>().value())->getFont();
             consoleTextBox = new Body(new Text(*defaultFont), Transformation());
             consoleTextBox->moveToAlignment(Alignment::Bottom_Left);
             consoleTextBox->move({ 20,-35 });
             consoleTextBox->zOrder = 100;
             consoleTextBox->addTextEnteredScript([](ScArgs args) {
                 if (world->consoleInputEnabled) {
-                    TextEnteredInput* evt = args.script->getInput().getDataPtr<TextEnteredInput>("evt");
+                    TextEnteredInput* evt = args.getEvent<TextEnteredInput>();
                     if (evt == nullptr) return;
                     char32_t ch = evt->unicode;
                     if (ch < 128 && ch != 8 && ch != 13 && ch != 96) {
@@ -72,7 +74,7 @@ namespace CGEngine {
                             world->lastConsoleCommand = command;
                             world->lastConsoleInput = inputString;
                             if (target != "") {
-                                Body* targetBody = assets.get<Body>(target);
+                                Body* targetBody = assets->get<Body>(target);
                                 targetBody->callScriptsWithData(command, DataMap(map<string, any>({ { "args",inputStrings} })));
                             }
                         }
@@ -93,8 +95,8 @@ namespace CGEngine {
 
             consoleTextBox->addKeyReleaseScript([](ScArgs args) {
                 world->consoleInputEnabled = !world->consoleInputEnabled;
-                if (world->consoleInputEnabled) {
-                    View* currentView = screen->getCurrentView();
+                View* currentView = screen->getCurrentView();
+                if (world->consoleInputEnabled && currentView != nullptr) {
                     Vector2f viewSize = currentView->getSize();
                     args.caller->setRotation(currentView->getRotation());
                     args.caller->setPosition((currentView->getInverseTransform() * V2f({ -1,1 })));
@@ -109,7 +111,7 @@ namespace CGEngine {
                 vector<string> inputStrings = args.script->getInput().getData<vector<string>>("args");
                 if (inputStrings.size() >= 1) {
                     string objName = inputStrings[0];
-                    foundBody = assets.get<Body>(objName);
+                    foundBody = assets->get<Body>(objName);
                 }
                 if (foundBody != nullptr) {
                     cout << "Drawing bounds for " << foundBody->getName() << "\n";
@@ -120,6 +122,28 @@ namespace CGEngine {
                     world->setBoundsRenderingEnabled(!world->getBoundsRenderingEnabled());
                 }
             }));
+
+            //Profile:on, Profile:off, Profile:reset, Profile:print[,count] or Profile:csv,path
+            addWorldScript("Profile", new Script([](ScArgs args) {
+                if (!ScriptProfiler::isCompiledIn()) {
+                    cout << "The script profiler isn't compiled in. Configure with -DPROFILE_SCRIPTS=ON\n";
+                    return;
+                }
+                vector<string> inputStrings = args.script->getInput().getData<vector<string>>("args");
+                string action = inputStrings.size() >= 1 ? inputStrings[0] : "print";
+                if (action == "on" || action == "off") {
+                    ScriptProfiler::setEnabled(action == "on");
+                    cout << "Script profiling " << (action == "on" ? "enabled" : "disabled") << "\n";
+                } else if (action == "reset") {
+                    ScriptProfiler::reset();
+                } else if (action == "csv" && inputStrings.size() >= 2) {
+                    bool exported = ScriptProfiler::exportCsv(inputStrings[1]);
+                    cout << (exported ? "Exported script profile to " : "Failed to export script profile to ") << inputStrings[1] << "\n";
+                } else {
+                    size_t count = inputStrings.size() >= 2 ? (size_t)max(atoi(inputStrings[1].c_str()), 1) : 20;
+                    cout << ScriptProfiler::formatResults(count);
+                }
+            }));
             consoleInitialized = true;
         }
     }
@@ -136,16 +160,16 @@ namespace CGEngine {
         }
         endWorld(root);
         running = false;
-        window->close();
+        renderer->setPipelinedEnabled(false);
+        if (window != nullptr) {
+            window->close();
+        }
     }
 
     void World::endWorld(Body* body) {
-        if (auto bd = body) {
-            bd->callScripts(onDeleteEvent);
-            for (auto iterator = bd->children.begin(); iterator != bd->children.end(); iterator++) {
-                Body* b = *iterator;
-                endWorld(b);
-            }
+        if (body == nullptr) return;
+        for (Body* bd : getSubtree(body)) {
+            bd->callScripts(onDeleteDomain);
         }
     }
 
@@ -154,8 +178,8 @@ namespace CGEngine {
     }
 
     vector<id_t> World::zRayCast(Vector2f worldPos, optional<int> startZ, int distance, bool backward, bool linecast) {
-        int zMax = renderer.zMax();
-        int zMin = renderer.zMin();
+        int zMax = renderer->zMax();
+        int zMin = renderer->zMin();
 
         //Start at the max or min Z if startZ is nullopt
         int currentZ = 0;
@@ -183,10 +207,11 @@ namespace CGEngine {
         vector<id_t> hits;
         for (int i = 0; i <= zDist; ++i) {
             int index = currentZ + (i * d);
-            vector<id_t> bodies = renderer.getZBodies(index);
+            vector<id_t> bodies = renderer->getZBodies(index);
             if (!backward) {
                 for (int x = bodies.size() - 1; x >= 0; x--) {
-					Body* body = assets.get<Body>(bodies[x]);
+					Body* body = assets->get<Body>(bodies[x]);
+                    if (body == nullptr || body->destroyed) continue;
                     if (body->contains(worldPos)) {
                         if (!linecast) {
                             return { bodies[x] };
@@ -198,7 +223,8 @@ namespace CGEngine {
             }
             else {
                 for (int x = 0; x < bodies.size(); x++) {
-					Body* body = assets.get<Body>(bodies[x]);
+					Body* body = assets->get<Body>(bodies[x]);
+                    if (body == nullptr || body->destroyed) continue;
                     if (body->contains(worldPos)) {
                         if (!linecast) {
                             return { bodies[x] };
@@ -214,10 +240,11 @@ namespace CGEngine {
 
     vector<id_t> World::raycast(Vector2f worldPos, Vector2f castDir, int zIndex, float distance, bool linecast) {
         vector<id_t> hits;
-        vector<id_t> bodies = renderer.getZBodies(zIndex);
+        vector<id_t> bodies = renderer->getZBodies(zIndex);
         Vector2f targetPos = worldPos + (castDir * distance);
         for (int x = bodies.size() - 1; x >= 0; x--) {
-			Body* body = assets.get<Body>(bodies[x]);
+			Body* body = assets->get<Body>(bodies[x]);
+            if (body == nullptr || body->destroyed) continue;
             if (body->lineIntersects(worldPos, targetPos)) {
                 hits.push_back(bodies.at(x));
                 if (!linecast) {
@@ -234,8 +261,10 @@ namespace CGEngine {
 
     void World::loadScene(string sceneName) {
         if (scenes.find(sceneName) != scenes.end()) {
+            Clock loadClock;
             Behavior* scene = scenes[sceneName];
             scene->callDomain(onLoadEvent);
+            log(this, LogInfo, "Loaded scene '{}' in {}ms", sceneName, loadClock.getElapsedTime().asMicroseconds() / 1000.f);
         }
     }
 
@@ -274,6 +303,26 @@ namespace CGEngine {
         return nullopt;
     }
 
+    SceneStreamer* World::getSceneStreamer() {
+        return sceneStreamer;
+    }
+
+    CommandQueue& World::getCommandQueue() {
+        return commands;
+    }
+
+    CoroutineScheduler& World::getCoroutines() {
+        return coroutines;
+    }
+
+    UpdateScheduler& World::getUpdateScheduler() {
+        return updates;
+    }
+
+    TimerWheel& World::getTimerWheel() {
+        return timerWheel;
+    }
+
     void World::startWorld() {
         //Create window (via Screen and using the static WindowParameters) and set InputMap's window
         screen->setWindowParameters(windowParameters);
@@ -281,14 +330,14 @@ namespace CGEngine {
         if(!window->setActive(true)) {
             log(LogLevel::LogError, "World", "Failed to set window as active OpenGL context");
         }
-        renderer.setWindow(window);
-        renderer.initGlew();
+        renderer->setWindow(window);
+        renderer->initGlew();
         input->setWindow(window);
 
-        assets.initialize();
+        assets->initialize();
 
         //Assign the fallback material
-        renderer.fallbackMaterialId = 0;
+        renderer->fallbackMaterialId = 0;
 
         running = true;
     }
@@ -305,14 +354,127 @@ namespace CGEngine {
     }
 
     void World::addUninitialized(Body* body) {
+        if (JobSystem::isInJob()) {
+            defer([this, body]() { addUninitialized(body); });
+            return;
+        }
         uninitialized.push_back(body);
     }
 
+    void World::queueDestroyed(Body* body) {
+        if (JobSystem::isInJob()) {
+            defer([this, body]() { queueDestroyed(body); });
+            return;
+        }
+        destroyQueue.push_back(body);
+    }
+
+    void World::unqueueDestroyed(Body* body) {
+        destroyQueue.erase(remove(destroyQueue.begin(), destroyQueue.end(), body), destroyQueue.end());
+    }
+
+    size_t World::getDestroyQueueSize() const {
+        return destroyQueue.size();
+    }
+
+    void World::flushDestroyed() {
+        if (destroyQueue.empty()) return;
+        Clock flushClock;
+        vector<Body*> queued;
+        queued.swap(destroyQueue);
+
+        //Apply each Body's children termination now that no script is iterating the hierarchy
+        for (size_t i = 0; i < queued.size(); i++) {
+            Body* body = queued[i];
+            for (int c = body->children.size() - 1; c >= 0; --c) {
+                Body* child = body->children[c];
+                if (child->destroyed) continue;
+                switch (body->destroyTermination) {
+                case ChildrenTermination::Inherit: {
+                    //Inherit to the nearest ancestor that isn't also being destroyed
+                    Body* heir = body->parent;
+                    while (heir != nullptr && heir->destroyed) {
+                        heir = heir->parent;
+                    }
+                    if (heir != nullptr) {
+                        child->exchange(heir);
+                        break;
+                    }
+                    [[fallthrough]];
+                }
+                case ChildrenTermination::Orphan:
+                    child->detach();
+                    break;
+                case ChildrenTermination::Terminate:
+                    //Children attached after the Body was destroyed are terminated with it
+                    child->destroyed = true;
+                    child->destroyTermination = ChildrenTermination::Terminate;
+                    queued.push_back(child);
+                    break;
+                }
+            }
+        }
+
+        //Collect every destroyed subtree, starting from Bodies whose parent is still alive
+        vector<Body*> destroyed;
+        destroyed.reserve(queued.size());
+        for (Body* body : queued) {
+            if (body->parent == nullptr || !body->parent->destroyed) {
+                collectDestroyed(body, destroyed);
+            }
+        }
+
+        //Call delete scripts while the hierarchy is still intact, then gather listeners and delete timers
+        map<InputCondition, vector<id_t>> listenerIds;
+        for (Body* body : destroyed) {
+            body->callScripts(onDeleteDomain);
+            for (const auto& [condition, ids] : body->listenerIds) {
+                vector<id_t>& conditionIds = listenerIds[condition];
+                conditionIds.insert(conditionIds.end(), ids.begin(), ids.end());
+            }
+            body->listenerIds.clear();
+            body->timers.deleteTimers();
+        }
+        //Release the input listeners of every destroyed Body in one pass over the input domains
+        if (input != nullptr) {
+            input->eraseActuatorIds(listenerIds);
+        }
+        //Bodies destroyed before they were started must not be started
+        uninitialized.erase(remove_if(uninitialized.begin(), uninitialized.end(), [](Body* body) { return body->destroyed; }), uninitialized.end());
+
+        //Unlink the destroyed subtrees so Bodies can be deleted in any order, then delete them
+        vector<id_t> bodyIds;
+        bodyIds.reserve(destroyed.size());
+        for (Body* body : destroyed) {
+            if (body->parent != nullptr && !body->parent->destroyed) {
+                body->drop();
+            }
+            body->parent = nullptr;
+            body->children.clear();
+            if (body->getId().has_value()) {
+                bodyIds.push_back(body->getId().value());
+            } else {
+                delete body;
+            }
+        }
+        assets->remove<Body>(bodyIds);
+
+        log(this, LogInfo, "Deleted {} destroyed Bodies in {}ms", destroyed.size(), flushClock.getElapsedTime().asMicroseconds() / 1000.f);
+    }
+
+    void World::collectDestroyed(Body* body, vector<Body*>& destroyed) {
+        for (Body* child : body->children) {
+            collectDestroyed(child, destroyed);
+        }
+        destroyed.push_back(body);
+    }
+
     void World::startUninitializedBodies() {
         while (uninitialized.size() > 0) {
             if (auto uninit = uninitialized.back()) {
                 uninit->start();
                 uninitialized.pop_back();
+                trackActivity(uninit);
             }
         }
         if (!consoleInitialized) {
@@ -322,44 +484,593 @@ namespace CGEngine {
 
     void World::runWorld() {
         while (running) {
-            renderer.initializeOpenGL();
+            renderer->initializeOpenGL();
             initSceneList();
 
             while (window->isOpen()) {
-                updateTime();
-                startUninitializedBodies();
-                callScripts(onUpdateEvent);
-                input->gather();
-                
-                if (window->isOpen()) {
-                    if (renderer.setGLWindowState(true)) {
-                        renderer.clearGL(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-                        if (!renderer.processRender()) return;
-                        renderer.setGLWindowState(false);
-                    }
+                if (!runFrame()) return;
+            }
+        }
+    }
+
+    bool World::runFrame() {
+        updateTime();
+        commands.drain();
+        sceneStreamer->update();
+        startUninitializedBodies();
+        runFixedSteps();
+        timerWheel.advance(time->getElapsedSec());
+        updates.run();
+        coroutines.update();
+        //Input is gathered and then dispatched in one batch, after the update scripts and coroutines have run
+        input->gather();
+        input->dispatch();
+        updateActivity();
+
+        if (window != nullptr && window->isOpen()) {
+            if (renderer->getPipelinedEnabled()) {
+                //The render thread draws this frame while the next one is simulated
+                if (!renderer->processPipelinedRender()) return false;
+            } else if (renderer->setGLWindowState(true)) {
+                renderer->clearGL(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                if (!renderer->processRender()) return false;
+                renderer->setGLWindowState(false);
+            }
+        }
+        flushDestroyed();
+        return true;
+    }
+
+    void World::startHeadless(sec_t stepSec) {
+        //No window is created, so the view is laid out over the window parameters' size and input only comes from InputMap::inject
+        headless = true;
+        screen->setWindowParameters(windowParameters);
+        screen->initView();
+        time->setSimulatedStep(stepSec);
+
+        assets->initialize(false);
+
+        running = true;
+        initSceneList();
+        log(this, LogInfo, "Started headless World with a {}s step", stepSec);
+    }
+
+    bool World::step(size_t frames) {
+        if (!headless) {
+            log(this, LogError, "step is only available in a headless World");
+            return false;
+        }
+        for (size_t i = 0; i < frames && running; i++) {
+            runFrame();
+        }
+        return running;
+    }
+
+    size_t World::runHeadless(size_t frames, float frameRate) {
+        Clock runClock;
+        size_t framesRun = 0;
+        while ((frames == 0 || framesRun < frames) && step()) {
+            framesRun++;
+            //Pace the frames against real time, sleeping until the next frame is due
+            if (frameRate > 0) {
+                float waitSec = framesRun / frameRate - runClock.getElapsedTime().asSeconds();
+                if (waitSec > 0) {
+                    sleep(seconds(waitSec));
                 }
             }
         }
+        log(this, LogInfo, "Ran {} headless frames in {}s", framesRun, runClock.getElapsedTime().asSeconds());
+        return framesRun;
+    }
+
+    void World::stopHeadless() {
+        if (running) {
+            endWorld();
+        }
+        flushDestroyed();
+        time->setSimulatedStep(0);
+        headless = false;
+    }
+
+    bool World::isHeadless() const {
+        return headless;
+    }
+
+    bool World::isRunning() const {
+        return running;
+    }
+
+    uint64_t World::getStateChecksum() {
+        uint64_t hash = 14695981039346656037ull;
+        auto combine = [&hash](const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; i++) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+        };
+        for (const BodyTraversalEntry& entry : getTraversalOrder()) {
+            Body* body = entry.body;
+            if (body->destroyed) continue;
+            float state[6] = { body->getPosition().x, body->getPosition().y, body->getRotation().asDegrees(), body->getScale().x, body->getScale().y, (float)body->zOrder };
+            combine(state, sizeof(state));
+        }
+        return hash;
     }
 
     void World::updateTime() {
-        time.updateDeltaTime();
+        time->updateDeltaTime();
     }
 
-    void World::callScripts(string scriptDomain, Body* body) {
+    void World::runFixedSteps() {
+        size_t droppedFrames = time->getDroppedFrameCount();
+        size_t steps = time->accumulateFixedSteps();
+        if (time->getDroppedFrameCount() > droppedFrames) {
+            log(this, LogWarn, "Simulation fell behind. Dropped the time beyond {} fixed steps this frame", time->getMaxCatchUpSteps());
+        }
+        for (size_t i = 0; i < steps; i++) {
+            time->beginFixedStep();
+            //Capture each subscriber's transform before the step so rendering can interpolate between the last two steps
+            DomainSubscribers* subscribers = getSubscribers(onFixedUpdateDomain);
+            if (subscribers == nullptr) continue;
+            for (Body* body : subscribers->bodies) {
+                body->captureSimulationState(time->getFixedStepCount());
+            }
+            callScripts(onFixedUpdateDomain);
+        }
+        time->endFixedStep();
+    }
+
+    void World::callScripts(domainId_t domainId, Body* body) {
+        //Whole-world calls only visit the Bodies that have scripts in the domain
         if (body == nullptr) {
-            body = root;
+            callSubscribers(domainId);
+            return;
+        }
+        //Destroyed Bodies (and their children) are skipped until they are deleted
+        for (Body* subtreeBody : getSubtree(body, true)) {
+            if (subtreeBody->destroyed) continue;
+            if (isSleepSkipped(domainId) && subtreeBody->activity.asleep) continue;
+            if (domainId != onDeleteDomain || subtreeBody != root) {
+                subtreeBody->callScripts(domainId);
+            }
         }
+    }
 
-        if (scriptDomain != "delete" || body != root){
-            body->callScripts(scriptDomain);
+    void World::callScripts(string scriptDomain, Body* body) {
+        //A name that was never interned has no scripts anywhere
+        if (optional<domainId_t> domainId = DomainRegistry::find(scriptDomain)) {
+            callScripts(domainId.value(), body);
         }
+    }
 
-        for (int i = body->children.size() - 1; i >= 0; i--) {
-            callScripts(scriptDomain, body->children[i]);
+    World::DomainSubscribers* World::getSubscribers(domainId_t domainId) {
+        return domainId < subscriptions.size() ? &subscriptions[domainId] : nullptr;
+    }
+
+    void World::callSubscribers(domainId_t domainId) {
+        DomainSubscribers* domainSubscribers = getSubscribers(domainId);
+        if (domainSubscribers == nullptr) return;
+
+        //Scripts may subscribe, unsubscribe, or delete Bodies while the domain is called, so iterate a copy
+        vector<Body*> subscribers = domainSubscribers->bodies;
+        if (domainId == onUpdateDomain && parallelUpdate && jobs->isRunning()) {
+            callUpdateParallel(subscribers);
+            return;
+        }
+        for (Body* body : subscribers) {
+            if (shouldCallSubscriber(body, domainId)) {
+                body->callScripts(domainId);
+            }
         }
     }
 
+    bool World::isSleepSkipped(domainId_t domainId) const {
+        return domainId == onUpdateDomain || domainId == onFixedUpdateDomain || updates.isScheduled(domainId);
+    }
+
+    bool World::shouldCallSubscriber(Body* body, domainId_t domainId) {
+        //Skip Bodies that were unsubscribed (or deleted) by an earlier script
+        DomainSubscribers* domainSubscribers = getSubscribers(domainId);
+        if (domainSubscribers == nullptr) return false;
+        if (domainSubscribers->entries.find(body) == domainSubscribers->entries.end()) return false;
+
+        if (domainId == onDeleteDomain && body == root) return false;
+        if (isSleepSkipped(domainId) && body->activity.asleep) return false;
+        return isActiveInWorld(body);
+    }
+
+    void World::callUpdateParallel(const vector<Body*>& subscribers) {
+        Clock updateClock;
+        vector<Body*> serial;
+        vector<vector<Body*>> waves;
+        vector<unordered_set<Body*>> waveReads;
+        vector<unordered_set<Body*>> waveWrites;
+        size_t parallelCount = 0;
+
+        //Place each parallel Body in the first wave where no other Body writes what it reads or touches what it writes
+        for (Body* body : subscribers) {
+            if (!shouldCallSubscriber(body, onUpdateDomain)) continue;
+            vector<Body*> reads;
+            vector<Body*> writes;
+            if (!body->getUpdateAccess(reads, writes)) {
+                serial.push_back(body);
+                continue;
+            }
+            size_t wave = 0;
+            for (; wave < waves.size(); wave++) {
+                bool conflict = false;
+                for (Body* written : writes) {
+                    if (waveWrites[wave].count(written) > 0 || waveReads[wave].count(written) > 0) {
+                        conflict = true;
+                        break;
+                    }
+                }
+                for (size_t r = 0; r < reads.size() && !conflict; r++) {
+                    conflict = waveWrites[wave].count(reads[r]) > 0;
+                }
+                if (!conflict) break;
+            }
+            if (wave == waves.size()) {
+                waves.emplace_back();
+                waveReads.emplace_back();
+                waveWrites.emplace_back();
+            }
+            waves[wave].push_back(body);
+            waveReads[wave].insert(reads.begin(), reads.end());
+            waveWrites[wave].insert(writes.begin(), writes.end());
+            parallelCount++;
+        }
+
+        for (vector<Body*>& wave : waves) {
+            jobs->parallelFor(wave.size(), parallelGrainSize, [&wave](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    if (!wave[i]->destroyed) {
+                        wave[i]->callScripts(onUpdateDomain);
+                    }
+                }
+            });
+            //Each wave sees the structural changes of the waves before it
+            commitDeferred();
+        }
+
+        for (Body* body : serial) {
+            if (shouldCallSubscriber(body, onUpdateDomain)) {
+                body->callScripts(onUpdateDomain);
+            }
+        }
+        parallelUpdateStats = { waves.size(), parallelCount, serial.size(), updateClock.getElapsedTime().asMicroseconds() / 1000.f };
+    }
+
+    void World::setParallelUpdateEnabled(bool enabled, size_t threadCount) {
+        parallelUpdate = enabled;
+        if (enabled && !jobs->isRunning()) {
+            jobs->start(threadCount);
+        }
+        log(this, LogInfo, "Parallel update {} with {} threads", enabled ? "enabled" : "disabled", jobs->getThreadCount());
+    }
+
+    bool World::getParallelUpdateEnabled() const {
+        return parallelUpdate;
+    }
+
+    tuple<size_t, size_t, size_t, float> World::getParallelUpdateStats() const {
+        return parallelUpdateStats;
+    }
+
+    void World::defer(function<void()> change) {
+        if (!JobSystem::isInJob()) {
+            change();
+            return;
+        }
+        lock_guard<mutex> lock(deferredMutex);
+        deferredChanges.push_back(change);
+    }
+
+    void World::commitDeferred() {
+        vector<function<void()>> changes;
+        {
+            lock_guard<mutex> lock(deferredMutex);
+            changes.swap(deferredChanges);
+        }
+        for (function<void()>& change : changes) {
+            change();
+        }
+    }
+
+    bool World::isActiveInWorld(Body* body) const {
+        while (body != nullptr) {
+            if (body->destroyed) return false;
+            if (body == root) return true;
+            body = body->parent;
+        }
+        return false;
+    }
+
+    void World::subscribe(Body* body, domainId_t domainId) {
+        if (JobSystem::isInJob()) {
+            defer([this, body, domainId]() { subscribe(body, domainId); });
+            return;
+        }
+        if (body == nullptr) return;
+        if (domainId >= subscriptions.size()) {
+            subscriptions.resize((size_t)domainId + 1);
+        }
+        DomainSubscribers& domainSubscribers = subscriptions[domainId];
+        auto found = domainSubscribers.entries.find(body);
+        if (found != domainSubscribers.entries.end()) {
+            found->second.handlerCount++;
+            return;
+        }
+        domainSubscribers.entries[body] = { domainSubscribers.bodies.size(), 1 };
+        domainSubscribers.bodies.push_back(body);
+    }
+
+    void World::subscribe(Body* body, const string& scriptDomain) {
+        subscribe(body, DomainRegistry::intern(scriptDomain));
+    }
+
+    void World::unsubscribe(Body* body, domainId_t domainId) {
+        if (JobSystem::isInJob()) {
+            defer([this, body, domainId]() { unsubscribe(body, domainId); });
+            return;
+        }
+        DomainSubscribers* domainSubscribers = getSubscribers(domainId);
+        if (domainSubscribers == nullptr) return;
+        DomainSubscribers& subscribers = *domainSubscribers;
+        auto found = subscribers.entries.find(body);
+        if (found == subscribers.entries.end()) return;
+        if (--found->second.handlerCount > 0) return;
+
+        //Swap the last subscriber into the removed Body's slot
+        size_t index = found->second.index;
+        Body* last = subscribers.bodies.back();
+        subscribers.bodies[index] = last;
+        subscribers.entries[last].index = index;
+        subscribers.bodies.pop_back();
+        subscribers.entries.erase(body);
+    }
+
+    void World::unsubscribe(Body* body, const string& scriptDomain) {
+        if (optional<domainId_t> domainId = DomainRegistry::find(scriptDomain)) {
+            unsubscribe(body, domainId.value());
+        }
+    }
+
+    void World::unsubscribeAll(Body* body) {
+        for (domainId_t domainId = 0; domainId < subscriptions.size(); domainId++) {
+            auto found = subscriptions[domainId].entries.find(body);
+            if (found == subscriptions[domainId].entries.end()) continue;
+            found->second.handlerCount = 1;
+            unsubscribe(body, domainId);
+        }
+    }
+
+    size_t World::getSubscriberCount(domainId_t domainId) const {
+        return domainId < subscriptions.size() ? subscriptions[domainId].bodies.size() : 0;
+    }
+
+    size_t World::getSubscriberCount(const string& scriptDomain) const {
+        optional<domainId_t> domainId = DomainRegistry::find(scriptDomain);
+        return domainId.has_value() ? getSubscriberCount(domainId.value()) : 0;
+    }
+
+    void World::setSleepThreshold(size_t frames) {
+        sleepThreshold = max(frames, (size_t)1);
+    }
+
+    size_t World::getSleepThreshold() const {
+        return sleepThreshold;
+    }
+
+    size_t World::getAwakeCount() const {
+        return awakeBodies.size();
+    }
+
+    size_t World::getAsleepCount() const {
+        return asleepCount;
+    }
+
+    void World::trackActivity(Body* body) {
+        if (body == nullptr || body == root || body->activity.tracked) return;
+        body->activity.tracked = true;
+        body->activity.asleep = false;
+        body->activity.idleFrames = 0;
+        body->activity.transform = body->getTransform();
+        body->activity.zOrder = body->zOrder;
+        body->activity.awakeIndex = awakeBodies.size();
+        awakeBodies.push_back(body);
+    }
+
+    void World::untrackActivity(Body* body) {
+        if (body == nullptr || !body->activity.tracked) return;
+        if (body->activity.asleep) {
+            asleepCount--;
+        } else {
+            removeAwake(body);
+        }
+        body->activity.tracked = false;
+        body->activity.asleep = false;
+    }
+
+    void World::wakeBody(Body* body) {
+        if (JobSystem::isInJob()) {
+            defer([this, body]() { wakeBody(body); });
+            return;
+        }
+        if (body == nullptr || !body->activity.tracked) return;
+        body->activity.idleFrames = 0;
+        if (!body->activity.asleep) return;
+        body->activity.asleep = false;
+        asleepCount--;
+        body->activity.transform = body->getTransform();
+        body->activity.zOrder = body->zOrder;
+        body->activity.awakeIndex = awakeBodies.size();
+        awakeBodies.push_back(body);
+    }
+
+    void World::removeAwake(Body* body) {
+        size_t index = body->activity.awakeIndex;
+        Body* last = awakeBodies.back();
+        awakeBodies[index] = last;
+        last->activity.awakeIndex = index;
+        awakeBodies.pop_back();
+    }
+
+    void World::updateActivity() {
+        //Iterate backward so Bodies falling asleep can be swapped out without skipping any
+        for (size_t i = awakeBodies.size(); i-- > 0;) {
+            Body* body = awakeBodies[i];
+            //Only Bodies that opted in to auto sleep are checked
+            if (body->destroyed || !body->activity.autoSleep) continue;
+            Body::ActivityState& activity = body->activity;
+            const Transform& transform = body->getTransform();
+            if (transform != activity.transform || body->zOrder != activity.zOrder) {
+                activity.transform = transform;
+                activity.zOrder = body->zOrder;
+                activity.idleFrames = 0;
+                continue;
+            }
+            if (++activity.idleFrames >= sleepThreshold && body->canSleep()) {
+                removeAwake(body);
+                activity.asleep = true;
+                asleepCount++;
+            }
+        }
+    }
+
+    BodyArchetypes& World::getArchetypes() {
+        return archetypes;
+    }
+
+    const vector<BodyTraversalEntry>& World::getTraversalOrder() {
+        if (traversalDirty) {
+            Clock rebuildClock;
+            traversal.clear();
+            appendTraversal(root, traversal);
+            for (size_t i = 0; i < traversal.size(); i++) {
+                traversal[i].body->traversalIndex = i;
+            }
+            traversalDirty = false;
+            dirtyTraversalIndices.clear();
+            traversalRebuildMs = rebuildClock.getElapsedTime().asMicroseconds() / 1000.f;
+        } else if (!dirtyTraversalIndices.empty()) {
+            Clock rebuildClock;
+            //Only the outermost changed subtrees are flattened again, since they contain the others
+            sort(dirtyTraversalIndices.begin(), dirtyTraversalIndices.end());
+            vector<size_t> spliceIndices;
+            size_t coveredEnd = 0;
+            for (size_t index : dirtyTraversalIndices) {
+                if (index < coveredEnd) continue;
+                spliceIndices.push_back(index);
+                coveredEnd = index + traversal[index].subtreeSize;
+            }
+            dirtyTraversalIndices.clear();
+            //Splice from the back, so the indices of earlier subtrees don't move
+            for (auto index = spliceIndices.rbegin(); index != spliceIndices.rend(); ++index) {
+                spliceTraversal(*index);
+            }
+            for (size_t i = spliceIndices.front(); i < traversal.size(); i++) {
+                traversal[i].body->traversalIndex = i;
+            }
+            traversalRebuildMs = rebuildClock.getElapsedTime().asMicroseconds() / 1000.f;
+        }
+        return traversal;
+    }
+
+    void World::markHierarchyDirty(Body* parent) {
+        if (traversalDirty || parent == nullptr) return;
+        //Bodies outside the cached hierarchy are covered by the entry of the ancestor they were attached under
+        size_t index = parent->traversalIndex;
+        if (index < traversal.size() && traversal[index].body == parent) {
+            dirtyTraversalIndices.push_back(index);
+        }
+    }
+
+    void World::spliceTraversal(size_t index) {
+        BodyTraversalEntry& entry = traversal[index];
+        int parentIndex = entry.parentIndex;
+        size_t oldSize = entry.subtreeSize;
+        vector<BodyTraversalEntry> subtree;
+        appendTraversal(entry.body, subtree);
+        //Make the subtree's parent indices relative to the whole hierarchy
+        subtree[0].parentIndex = parentIndex;
+        for (size_t i = 1; i < subtree.size(); i++) {
+            subtree[i].parentIndex += (int)index;
+        }
+
+        ptrdiff_t delta = (ptrdiff_t)subtree.size() - (ptrdiff_t)oldSize;
+        if (delta != 0) {
+            for (int ancestor = parentIndex; ancestor >= 0; ancestor = traversal[ancestor].parentIndex) {
+                traversal[ancestor].subtreeSize += delta;
+            }
+            //Entries after the subtree whose parent also follows it move with it
+            for (size_t i = index + oldSize; i < traversal.size(); i++) {
+                if (traversal[i].parentIndex >= (int)(index + oldSize)) {
+                    traversal[i].parentIndex += (int)delta;
+                }
+            }
+        }
+        if (subtree.size() > oldSize) {
+            traversal.insert(traversal.begin() + index + oldSize, subtree.size() - oldSize, BodyTraversalEntry());
+        } else if (subtree.size() < oldSize) {
+            traversal.erase(traversal.begin() + index + subtree.size(), traversal.begin() + index + oldSize);
+        }
+        copy(subtree.begin(), subtree.end(), traversal.begin() + index);
+    }
+
+    float World::getTraversalRebuildMs() const {
+        return traversalRebuildMs;
+    }
+
+    void World::appendTraversal(Body* body, vector<BodyTraversalEntry>& entries) {
+        if (body == nullptr) return;
+        size_t first = entries.size();
+        //Children are pushed in reverse so they're popped (and flattened) in order
+        vector<pair<Body*, int>> search = { { body, -1 } };
+        while (!search.empty()) {
+            auto [current, parentIndex] = search.back();
+            search.pop_back();
+            int index = (int)entries.size();
+            entries.push_back({ current, parentIndex, 1 });
+            for (int c = current->children.size() - 1; c >= 0; --c) {
+                search.push_back({ current->children[c], index });
+            }
+        }
+        //Every entry follows its parent, so subtree sizes accumulate in a single backward pass
+        for (size_t i = entries.size() - 1; i > first; i--) {
+            entries[entries[i].parentIndex].subtreeSize += entries[i].subtreeSize;
+        }
+    }
+
+    vector<Body*> World::getSubtree(Body* body, bool skipDestroyed) {
+        vector<Body*> subtree;
+        if (body == nullptr) return subtree;
+
+        //Bodies outside of the root's hierarchy are flattened on demand
+        const vector<BodyTraversalEntry>* entries = &getTraversalOrder();
+        vector<BodyTraversalEntry> detached;
+        size_t first = body->traversalIndex;
+        if (first >= entries->size() || (*entries)[first].body != body) {
+            appendTraversal(body, detached);
+            entries = &detached;
+            first = 0;
+        }
+
+        size_t last = first + (*entries)[first].subtreeSize;
+        subtree.reserve(last - first);
+        for (size_t i = first; i < last;) {
+            const BodyTraversalEntry& entry = (*entries)[i];
+            if (skipDestroyed && entry.body->destroyed) {
+                i += entry.subtreeSize;
+                continue;
+            }
+            subtree.push_back(entry.body);
+            i++;
+        }
+        return subtree;
+    }
+
     void World::addDefaultExitActuator() {
         root->addKeyReleaseScript([](ScArgs args) { world->endWorld(); }, Keyboard::Scan::Escape);
     }
@@ -370,10 +1081,8 @@ namespace CGEngine {
     };
 
     void World::setBoundsRenderingEnabled(bool enabled, Body* body) {
-        body->setBoundsRenderingEnabled(enabled);
-
-        for (int i = body->children.size() - 1; i >= 0; i--) {
-            setBoundsRenderingEnabled(enabled, body->children[i]);
+        for (Body* subtreeBody : getSubtree(body)) {
+            subtreeBody->setBoundsRenderingEnabled(enabled);
         }
     };
 
@@ -387,12 +1096,10 @@ namespace CGEngine {
     };
 
     void World::setBoundsColor(Color color, Body* body) {
-        if (body->boundsRect != nullptr) {
-            body->boundsRect->setOutlineColor(color);
-        }
-
-        for (int i = body->children.size() - 1; i >= 0; i--) {
-            setBoundsColor(color, body->children[i]);
+        for (Body* subtreeBody : getSubtree(body)) {
+            if (subtreeBody->boundsRect != nullptr) {
+                subtreeBody->boundsRect->setOutlineColor(color);
+            }
         }
     };
 
@@ -402,12 +1109,10 @@ namespace CGEngine {
     };
 
     void World::setBoundsThickness(float thickness, Body* body) {
-        if (body->boundsRect != nullptr) {
-            body->boundsRect->setOutlineThickness(thickness);
-        }
-
-        for (int i = body->children.size() - 1; i >= 0; i--) {
-            setBoundsThickness(thickness, body->children[i]);
+        for (Body* subtreeBody : getSubtree(body)) {
+            if (subtreeBody->boundsRect != nullptr) {
+                subtreeBody->boundsRect->setOutlineThickness(thickness);
+            }
         }
     }
 
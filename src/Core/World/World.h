@@ -6,13 +6,37 @@
 #include "../Mesh/Mesh.h"
 #include "../Light/Light.h"
 #include "../Engine/EngineSystem.h"
+#include "../Jobs/CommandQueue.h"
+#include "UpdateScheduler.h"
+#include "../Timers/TimerWheel.h"
 #include <sstream>
 #include <memory>
 #include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <tuple>
 using namespace sf;
 using namespace std;
 
 namespace CGEngine {
+    class SceneStreamer;
+
+    /// <summary>
+    /// An entry of the World's depth-first flattened Body hierarchy. A Body's descendants are the subtreeSize - 1 entries that follow it.
+    /// </summary>
+    struct BodyTraversalEntry {
+        Body* body = nullptr;
+        /// <summary>
+        /// Index of the parent's entry, or -1 for the first entry
+        /// </summary>
+        int parentIndex = -1;
+        /// <summary>
+        /// Number of entries in the Body's subtree, including itself
+        /// </summary>
+        size_t subtreeSize = 1;
+    };
+
     class World : public EngineSystem {
     public:
         World();
@@ -20,9 +44,144 @@ namespace CGEngine {
         void runWorld();
         void startWorld();
         void endWorld();
+        /// <summary>
+        /// Start the World without a window or OpenGL context. Scenes, scripts, timers and injected input run as usual, and rendering is skipped.
+        /// Frames are run with step or runHeadless.
+        /// </summary>
+        /// <param name="stepSec">The simulated time each frame advances by. If 0, frames advance by the real time between them.</param>
+        void startHeadless(sec_t stepSec = 1.f / 60.f);
+        /// <summary>
+        /// Run frames of a headless World
+        /// </summary>
+        /// <param name="frames">The number of frames to run</param>
+        /// <returns>Whether the World is still running</returns>
+        bool step(size_t frames = 1);
+        /// <summary>
+        /// Run frames of a headless World until the frame count is reached or the World is ended
+        /// </summary>
+        /// <param name="frames">The number of frames to run. If 0, frames are run until the World is ended.</param>
+        /// <param name="frameRate">The frames per second to run at. If 0, frames are run as fast as possible.</param>
+        /// <returns>The number of frames run</returns>
+        size_t runHeadless(size_t frames = 0, float frameRate = 0);
+        /// <summary>
+        /// End a headless World, calling the delete scripts and deleting destroyed Bodies
+        /// </summary>
+        void stopHeadless();
+        bool isHeadless() const;
+        bool isRunning() const;
+        /// <summary>
+        /// Return an FNV-1a hash of every live Body's transform and Z-Order in hierarchy order. Two runs that produce the same checksum each frame have not diverged.
+        /// </summary>
+        uint64_t getStateChecksum();
 
         //Scripts
+        void callScripts(domainId_t domainId, Body* body = nullptr);
         void callScripts(string scriptDomain, Body* body = nullptr);
+        /// <summary>
+        /// Record that the Body (or one of its Behaviors) has scripts in the domain. Called by ScriptMap when a domain gains its first script.
+        /// </summary>
+        /// <param name="body">The subscribing Body</param>
+        /// <param name="domainId">The interned domain id</param>
+        void subscribe(Body* body, domainId_t domainId);
+        void subscribe(Body* body, const string& scriptDomain);
+        /// <summary>
+        /// Record that one of the Body's ScriptMaps no longer has scripts in the domain. Called by ScriptMap when a domain is emptied.
+        /// </summary>
+        /// <param name="body">The unsubscribing Body</param>
+        /// <param name="domainId">The interned domain id</param>
+        void unsubscribe(Body* body, domainId_t domainId);
+        void unsubscribe(Body* body, const string& scriptDomain);
+        /// <summary>
+        /// Remove the Body from every domain's subscribers
+        /// </summary>
+        /// <param name="body">The Body being deleted</param>
+        void unsubscribeAll(Body* body);
+        /// <summary>
+        /// Return the number of Bodies with scripts in the domain
+        /// </summary>
+        /// <param name="domainId">The interned domain id</param>
+        /// <returns>The number of subscribed Bodies</returns>
+        size_t getSubscriberCount(domainId_t domainId) const;
+        size_t getSubscriberCount(const string& scriptDomain) const;
+
+        //Parallel Update
+        /// <summary>
+        /// Set whether update scripts run across the JobSystem's threads. Bodies whose update scripts are all thread-safe or declare their access
+        /// are grouped into waves of Bodies that don't read or write each other, and each wave runs in parallel. Other Bodies update on the main thread afterward.
+        /// </summary>
+        /// <param name="enabled">Whether parallel update is enabled</param>
+        /// <param name="threadCount">The number of threads to start the JobSystem with, if it isn't running. If 0, the hardware concurrency is used.</param>
+        void setParallelUpdateEnabled(bool enabled, size_t threadCount = 0);
+        bool getParallelUpdateEnabled() const;
+        /// <summary>
+        /// Apply a structural change (spawning, deleting, attaching) after the running parallel update jobs finish. Called outside of a job, the change is applied immediately.
+        /// </summary>
+        /// <param name="change">The change to apply</param>
+        void defer(function<void()> change);
+        /// <summary>
+        /// Return the number of parallel waves, parallel Bodies and main thread Bodies of the last parallel update, and its duration in milliseconds
+        /// </summary>
+        tuple<size_t, size_t, size_t, float> getParallelUpdateStats() const;
+
+        //Activity
+        /// <summary>
+        /// Set the number of frames a Body's transform, Z-Order and scripts must be unchanged before it falls asleep, if it has auto sleep enabled
+        /// </summary>
+        /// <param name="frames">The number of idle frames</param>
+        void setSleepThreshold(size_t frames);
+        size_t getSleepThreshold() const;
+        /// <summary>
+        /// Return the number of started Bodies that are awake
+        /// </summary>
+        /// <returns>The number of awake Bodies</returns>
+        size_t getAwakeCount() const;
+        /// <summary>
+        /// Return the number of started Bodies that are asleep
+        /// </summary>
+        /// <returns>The number of sleeping Bodies</returns>
+        size_t getAsleepCount() const;
+        /// <summary>
+        /// Wake the Body and restart its idle frame count. Called by Body::wake.
+        /// </summary>
+        /// <param name="body">The Body to wake</param>
+        void wakeBody(Body* body);
+        /// <summary>
+        /// Stop tracking the Body's activity. Called when the Body is deleted.
+        /// </summary>
+        /// <param name="body">The Body being deleted</param>
+        void untrackActivity(Body* body);
+
+        //Archetypes
+        /// <summary>
+        /// Return the dense storage of every Body with an entity, grouped by component set
+        /// </summary>
+        /// <returns>The World's BodyArchetypes</returns>
+        BodyArchetypes& getArchetypes();
+
+        //Traversal
+        /// <summary>
+        /// Return the root's hierarchy flattened in depth-first order, rebuilding it first if the hierarchy changed
+        /// </summary>
+        /// <returns>The flattened hierarchy, starting with the root</returns>
+        const vector<BodyTraversalEntry>& getTraversalOrder();
+        /// <summary>
+        /// Mark the parent's subtree of the flattened hierarchy to be flattened again and spliced in before the next pass that needs it.
+        /// Called on the parent whenever a Body is attached, detached, or dropped.
+        /// </summary>
+        /// <param name="parent">The Body whose children changed</param>
+        void markHierarchyDirty(Body* parent);
+        /// <summary>
+        /// Return the Body and its descendants in depth-first order
+        /// </summary>
+        /// <param name="body">The top Body of the subtree</param>
+        /// <param name="skipDestroyed">Whether destroyed Bodies (and their descendants) are skipped</param>
+        /// <returns>The Bodies in the subtree</returns>
+        vector<Body*> getSubtree(Body* body, bool skipDestroyed = false);
+        /// <summary>
+        /// Return the milliseconds taken by the last rebuild or splice of the flattened hierarchy
+        /// </summary>
+        /// <returns>The rebuild time in milliseconds</returns>
+        float getTraversalRebuildMs() const;
         void addDefaultExitActuator();
 
         //Utility
@@ -49,10 +208,50 @@ namespace CGEngine {
         optional<DataMap> getSceneInput(string sceneName);
         optional<DataMap> getSceneOutput(string sceneName);
         optional<DataMap> getSceneProcess(string sceneName);
+        /// <summary>
+        /// Return the SceneStreamer used to build scenes over several frames
+        /// </summary>
+        /// <returns>The World's SceneStreamer</returns>
+        SceneStreamer* getSceneStreamer();
+        /// <summary>
+        /// Return the queue other threads post commands to. The commands are run on the main thread at the start of each frame.
+        /// </summary>
+        /// <returns>The World's CommandQueue</returns>
+        CommandQueue& getCommandQueue();
+        /// <summary>
+        /// Return the scheduler that runs script coroutines. Due coroutines are resumed each frame after the update scripts.
+        /// </summary>
+        /// <returns>The World's CoroutineScheduler</returns>
+        CoroutineScheduler& getCoroutines();
+        /// <summary>
+        /// Return the scheduler that calls the update domains each frame by their priority and target rate, under a per-frame budget
+        /// </summary>
+        /// <returns>The World's UpdateScheduler</returns>
+        UpdateScheduler& getUpdateScheduler();
+        /// <summary>
+        /// Return the wheel that fires every Body's timers. Expired timers are fired each frame before the update scripts.
+        /// </summary>
+        /// <returns>The World's TimerWheel</returns>
+        TimerWheel& getTimerWheel();
 
         //Bodies
         vector<Body*> uninitialized;
         void addUninitialized(Body* body);
+        /// <summary>
+        /// Queue a destroyed Body to be deleted at the end of the frame
+        /// </summary>
+        /// <param name="body">The destroyed Body</param>
+        void queueDestroyed(Body* body);
+        /// <summary>
+        /// Remove a Body from the destroyed Bodies waiting to be deleted, if it is queued
+        /// </summary>
+        /// <param name="body">The Body being deleted</param>
+        void unqueueDestroyed(Body* body);
+        /// <summary>
+        /// Return the number of destroyed Bodies waiting to be deleted at the end of the frame
+        /// </summary>
+        /// <returns>The number of queued Bodies</returns>
+        size_t getDestroyQueueSize() const;
 
         //Root Body
         Body* getRoot();
@@ -104,18 +303,108 @@ namespace CGEngine {
         Body* root = nullptr;
 
         bool running = false;
+        bool headless = false;
         
         //World State
         //Start World
         void initSceneList();
         //Update World
         void updateTime();
+        //Run the fixed update scripts once for each fixed step accumulated since the last frame
+        void runFixedSteps();
+        //Run a single frame, rendering it if there is a window. Returns false if rendering failed.
+        bool runFrame();
         void startUninitializedBodies();
+        //Delete all destroyed Bodies in a single batch at the end of the frame
+        void flushDestroyed();
+        //Collect the destroyed Body and its destroyed descendants, children first
+        void collectDestroyed(Body* body, vector<Body*>& destroyed);
         //End World
         void endWorld(Body* body);
 
+        //Bodies destroyed this frame
+        vector<Body*> destroyQueue;
+
+        //Subscriptions
+        struct Subscriber {
+            //Index of the Body in the domain's subscriber list
+            size_t index = 0;
+            //Number of the Body's ScriptMaps (its own and its Behaviors') with scripts in the domain
+            size_t handlerCount = 0;
+        };
+        struct DomainSubscribers {
+            vector<Body*> bodies;
+            unordered_map<Body*, Subscriber> entries;
+        };
+        //Bodies with scripts in each domain, indexed by domain id, so a domain can be called without walking the whole hierarchy
+        vector<DomainSubscribers> subscriptions;
+        //Return the domain's subscribers, or null if no Body has subscribed to it
+        DomainSubscribers* getSubscribers(domainId_t domainId);
+        //Call the domain on each subscribed Body that is attached to the world and not destroyed
+        void callSubscribers(domainId_t domainId);
+        //Return whether the Body is in the root's hierarchy and neither it nor any of its ancestors are destroyed
+        bool isActiveInWorld(Body* body) const;
+
+        //Parallel Update
+        bool parallelUpdate = false;
+        //Number of Bodies per job
+        size_t parallelGrainSize = 16;
+        mutex deferredMutex;
+        vector<function<void()>> deferredChanges;
+        tuple<size_t, size_t, size_t, float> parallelUpdateStats = { 0, 0, 0, 0.f };
+        //Apply the structural changes deferred by parallel update jobs
+        void commitDeferred();
+        //Call update scripts of the subscribers, running Bodies with thread-safe or declared scripts in parallel waves
+        void callUpdateParallel(const vector<Body*>& subscribers);
+        //Return whether the subscriber should be called for the domain
+        bool shouldCallSubscriber(Body* body, domainId_t domainId);
+        //Return whether asleep Bodies are skipped when the domain is called
+        bool isSleepSkipped(domainId_t domainId) const;
+
+        //Activity
+        //Started Bodies that are awake. Sleeping Bodies are only counted.
+        vector<Body*> awakeBodies;
+        size_t asleepCount = 0;
+        size_t sleepThreshold = 60;
+        //Start tracking the started Body's activity
+        void trackActivity(Body* body);
+        //Put awake Bodies that have been idle for the sleep threshold to sleep
+        void updateActivity();
+        //Remove the Body from the awake Bodies, moving the last awake Body into its place
+        void removeAwake(Body* body);
+
+        //Bodies with entities, grouped by component set
+        BodyArchetypes archetypes;
+
+        //Traversal
+        //The root's hierarchy flattened in depth-first order
+        vector<BodyTraversalEntry> traversal;
+        //Whether the whole hierarchy must be flattened again
+        bool traversalDirty = true;
+        //Entries of the cached hierarchy whose subtrees changed. They stay valid until the next splice, since the cache isn't touched before it.
+        vector<size_t> dirtyTraversalIndices;
+        float traversalRebuildMs = 0;
+        //Append the Body's subtree to entries in depth-first order
+        void appendTraversal(Body* body, vector<BodyTraversalEntry>& entries);
+        //Flatten the subtree of the entry at index again and splice it in place of its old entries
+        void spliceTraversal(size_t index);
+
         //Scenes
         map<string, Behavior*> scenes;
+        SceneStreamer* sceneStreamer = nullptr;
+
+        //Commands posted from other threads
+        CommandQueue commands;
+
+        //Script coroutines
+        CoroutineScheduler coroutines;
+
+        //Update domains by priority and rate
+        friend class UpdateScheduler;
+        UpdateScheduler updates;
+
+        //Timers of every Body
+        TimerWheel timerWheel;
 
         //Console
         bool consoleFeatureEnabled = true;
@@ -3,6 +3,26 @@
 #include "../../Core/Engine/Engine.h"
 
 namespace CGEngine {
+    namespace {
+        //Keys are interned once, so the per-frame lookups compare integers instead of strings
+        const DataKey maxFrameRateKey = "maxFrameRate";
+        const DataKey speedKey = "speed";
+        const DataKey maxFrameKey = "maxFrame";
+        const DataKey loopingKey = "looping";
+        const DataKey startRunningKey = "startRunning";
+        const DataKey sheetSizeKey = "sheetSize";
+        const DataKey rectKey = "rect";
+        const DataKey frameKey = "frame";
+        const DataKey stateKey = "state";
+        const DataKey frameTimeKey = "frameTime";
+        const DataKey animationStartPosKey = "animationStartPos";
+        const DataKey frameLengthKey = "frameLength";
+        const DataKey animUpdateIdKey = "animUpdateId";
+        const DataKey facingKey = "facing";
+        const DataKey lastMoveKey = "lastMove";
+        const DataKey evtKey = "evt";
+    }
+
     AnimationBehavior::AnimationBehavior(Body* owner, AnimationParameters params) : Behavior(owner) {
         setParameters(params);
         resetProcessData();
@@ -46,8 +66,8 @@ namespace CGEngine {
 
     //When the Behavior is started (when the Body is started)
     ScriptEvent AnimationBehavior::animBehaviorStartEvt = [](ScArgs args) {
-        IntRect spriteRect = args.behavior->getProcessData<IntRect>("rect");
-        bool startRunning = args.behavior->getInputData<bool>("startRunning");
+        IntRect spriteRect = args.behavior->getProcessData<IntRect>(rectKey);
+        bool startRunning = args.behavior->getInputData<bool>(startRunningKey);
 
         args.caller->get<Sprite*>()->setTextureRect(spriteRect);
         if (startRunning) {
@@ -57,58 +77,58 @@ namespace CGEngine {
 
     //Animation scripts
     ScriptEvent AnimationBehavior::calculateFrameLengthEvt = [](ScArgs args) {
-        float maxFrameRate = args.behavior->getInputData<float>("maxFrameRate");
-        float speed = args.behavior->getInputData<float>("speed");
+        float maxFrameRate = args.behavior->getInputData<float>(maxFrameRateKey);
+        float speed = args.behavior->getInputData<float>(speedKey);
         float frameRate = maxFrameRate * abs(speed);
         float frameLength = 1.f / frameRate;
-        args.behavior->setProcessData("frameLength", frameLength);
+        args.behavior->setProcessData(frameLengthKey, frameLength);
     };
 
     ScriptEvent AnimationBehavior::pauseAnimEvt = [](ScArgs args) {
-        id_t animationUpdateScriptId = args.behavior->getProcessData<id_t>("animUpdateId");
-        args.behavior->setProcessData("state", AnimationState::Paused);
+        id_t animationUpdateScriptId = args.behavior->getProcessData<id_t>(animUpdateIdKey);
+        args.behavior->setProcessData(stateKey, AnimationState::Paused);
         args.behavior->removeScript(onUpdateEvent, animationUpdateScriptId, true);
     };
 
     ScriptEvent AnimationBehavior::endAnimEvt = [](ScArgs args) {
-        args.behavior->setProcessData("frameTime", 0.f);
+        args.behavior->setProcessData(frameTimeKey, 0.f);
 
-        Vector2i startingPos = args.behavior->getProcessData<Vector2i>("animationStartPos");
-        IntRect spriteRect = args.behavior->getProcessData<IntRect>("rect");
+        Vector2i startingPos = args.behavior->getProcessData<Vector2i>(animationStartPosKey);
+        IntRect spriteRect = args.behavior->getProcessData<IntRect>(rectKey);
         spriteRect.position = startingPos;
-        args.behavior->setProcessData("rect", spriteRect);
+        args.behavior->setProcessData(rectKey, spriteRect);
         args.caller->get<Sprite*>()->setTextureRect(spriteRect);
 
         args.behavior->callDomain("pauseAnimation");
-        args.behavior->setProcessData("state", AnimationState::Ready);
+        args.behavior->setProcessData(stateKey, AnimationState::Ready);
 
-        args.behavior->setProcessData("frame", 0);
+        args.behavior->setProcessData(frameKey, 0);
     };
 
     ScriptEvent AnimationBehavior::startAnimEvt = [](ScArgs args) {
         args.behavior->callDomain("calculateAnimLength");
-        args.behavior->setProcessData("state", AnimationState::Running);
+        args.behavior->setProcessData(stateKey, AnimationState::Running);
 
         id_t animationUpdateScriptId = args.behavior->addScript(onUpdateEvent, new Script([](ScArgs args) {
             args.behavior->callDomain("animate");
             }));
-        args.behavior->setProcessData("animUpdateId", animationUpdateScriptId);
+        args.behavior->setProcessData(animUpdateIdKey, animationUpdateScriptId);
     };
 
     ScriptEvent AnimationBehavior::animateEvt = [](ScArgs args) {
-        int frame = args.behavior->getProcessData<int>("frame");
-        IntRect spriteRect = args.behavior->getProcessData<IntRect>("rect");
-        float frameLength = args.behavior->getProcessData<float>("frameLength");
-        float state = args.behavior->getProcessData<AnimationState>("state");
-        Vector2i animationStartPos = args.behavior->getProcessData<Vector2i>("animationStartPos");
+        int frame = args.behavior->getProcessData<int>(frameKey);
+        IntRect spriteRect = args.behavior->getProcessData<IntRect>(rectKey);
+        float frameLength = args.behavior->getProcessData<float>(frameLengthKey);
+        float state = args.behavior->getProcessData<AnimationState>(stateKey);
+        Vector2i animationStartPos = args.behavior->getProcessData<Vector2i>(animationStartPosKey);
 
-        bool looping = args.behavior->getInputData<bool>("looping");
-        bool startRunning = args.behavior->getInputData<bool>("startRunning");
-        Vector2u spriteSheetSize = args.behavior->getInputData<Vector2u>("sheetSize");
-        int maxFrame = args.behavior->getInputData<int>("maxFrame");
+        bool looping = args.behavior->getInputData<bool>(loopingKey);
+        bool startRunning = args.behavior->getInputData<bool>(startRunningKey);
+        Vector2u spriteSheetSize = args.behavior->getInputData<Vector2u>(sheetSizeKey);
+        int maxFrame = args.behavior->getInputData<int>(maxFrameKey);
 
         if (frameLength <= 0) return;
-        float frameTime = args.behavior->getProcessData<float>("frameTime") + time.getDeltaSec();
+        float frameTime = args.behavior->getProcessData<float>(frameTimeKey) + time->getDeltaSec();
         if (frameTime > frameLength) {
             while ((frameTime -= frameLength) >= 0.f) {
                 if (maxFrame > 0 && frame >= maxFrame) {
@@ -148,44 +168,44 @@ namespace CGEngine {
                 }
             }
             args.caller->get<Sprite*>()->setTextureRect(spriteRect);
-            args.behavior->setProcessData("frame", frame);
-            args.behavior->setProcessData("rect", spriteRect);
+            args.behavior->setProcessData(frameKey, frame);
+            args.behavior->setProcessData(rectKey, spriteRect);
         }
-        args.behavior->setProcessData("frameTime", frameTime);
+        args.behavior->setProcessData(frameTimeKey, frameTime);
     };
 
     ScriptEvent AnimationBehavior::animBehaviorUpdateEvt = [](ScArgs args) {
-        Vector2f facing = args.behavior->getProcessData<Vector2f>("facing");
-        Vector2f lastMove = args.behavior->getProcessData<Vector2f>("lastMove");
+        Vector2f facing = args.behavior->getProcessData<Vector2f>(facingKey);
+        Vector2f lastMove = args.behavior->getProcessData<Vector2f>(lastMoveKey);
 
         if (facing != lastMove && lastMove != V2f({ 0,0 })) {
             if (lastMove == Vector2f({ 0, 1 })) {
-                args.behavior->setProcessData("animationStartPos", Vector2i({ 0,0 }));
+                args.behavior->setProcessData(animationStartPosKey, Vector2i({ 0,0 }));
             }
             else if (lastMove == Vector2f({ 0, -1 })) {
-                args.behavior->setProcessData("animationStartPos", Vector2i({ 0,96 }));
+                args.behavior->setProcessData(animationStartPosKey, Vector2i({ 0,96 }));
             }
             else if (lastMove == Vector2f({ 1, 0 })) {
-                args.behavior->setProcessData("animationStartPos", Vector2i({ 0,32 }));
+                args.behavior->setProcessData(animationStartPosKey, Vector2i({ 0,32 }));
             }
             else {
-                args.behavior->setProcessData("animationStartPos", Vector2i({ 0,64 }));
+                args.behavior->setProcessData(animationStartPosKey, Vector2i({ 0,64 }));
             }
 
             facing = lastMove;
-            args.behavior->setProcessData("facing", facing);
+            args.behavior->setProcessData(facingKey, facing);
             args.behavior->callDomain("endAnimation");
         }
         lastMove = { 0,0 };
-        args.behavior->setProcessData("lastMove", lastMove);
+        args.behavior->setProcessData(lastMoveKey, lastMove);
     };
 
     ScriptEvent AnimationBehavior::onTranslateEvt = [](ScArgs args) {
-        AnimationState animState = args.behavior->getProcessData<AnimationState>("state");
+        AnimationState animState = args.behavior->getProcessData<AnimationState>(stateKey);
         if (animState != AnimationState::Running) {
             args.behavior->callDomain("startAnimation");
         }
-        Vector2f lastMove = args.script->getInput().getData<Vector2f>("evt");
-        args.behavior->setProcessData("lastMove", lastMove);
+        Vector2f lastMove = args.script->getInput().getData<Vector2f>(evtKey);
+        args.behavior->setProcessData(lastMoveKey, lastMove);
     };
 }
\ No newline at end of file
@@ -3,13 +3,13 @@
 
 namespace CGEngine {
     MeshData* getCubeModel(float scale) {
-        optional<id_t> cubeId = assets.create<MeshData>("default_cube", getCubeVertices(scale), getCubeIndices());
-		return assets.get<MeshData>(cubeId.value());
+        optional<id_t> cubeId = assets->create<MeshData>("default_cube", getCubeVertices(scale), getCubeIndices());
+		return assets->get<MeshData>(cubeId.value());
     }
 
     MeshData* getPlaneModel(float scale, float textureId, Vector3f offset) {
-        optional<id_t> planeId = assets.create<MeshData>("default_plane", getPlaneVertices(scale, textureId, offset), getPlaneIndices());
-		return assets.get<MeshData>(planeId.value());
+        optional<id_t> planeId = assets->create<MeshData>("default_plane", getPlaneVertices(scale, textureId, offset), getPlaneIndices());
+		return assets->get<MeshData>(planeId.value());
     }
 
     vector<VertexData> getCubeVertices(float scale) {
@@ -128,8 +128,8 @@ namespace CGEngine {
     }
 
     MeshData* getTilemapModel(float scale, Vector2i size, vector<vector<int>> textureMap) {
-		optional<id_t> tilemapId = assets.create<MeshData>("default_tilemap", getTilemapVertices(scale, size, textureMap), getTilemapIndices(size));
-		return assets.get<MeshData>(tilemapId.value());
+		optional<id_t> tilemapId = assets->create<MeshData>("default_tilemap", getTilemapVertices(scale, size, textureMap), getTilemapIndices(size));
+		return assets->get<MeshData>(tilemapId.value());
     }
 
     vector<VertexData> getTilemapVertices(float scale, Vector2i size, vector<vector<int>> textureMap){
@@ -3,6 +3,13 @@
 #include "../../Core/Engine/Engine.h"
 
 namespace CGEngine {
+    namespace {
+        //Keys are interned once, so the per-frame lookups compare integers instead of strings
+        const DataKey argsKey = "args";
+        const DataKey speedKey = "speed";
+        const DataKey evtKey = "evt";
+    }
+
     struct TranslateArgs {
         TranslateArgs(float spd = 0.f, Vector2f dir = {0,0}, bool view = false) :speed(spd), direction(dir), viewBound(view) {};
         float speed = 0.f;
@@ -19,35 +26,39 @@ namespace CGEngine {
     ScriptEvent translateEvent = [](ScArgs args) {
         if (world->consoleInputEnabled) return;
         //Re-readable input
-        TranslateArgs evtArgs = args.script->getInput().getData<TranslateArgs>("args");
+        TranslateArgs evtArgs = args.script->getInput().getData<TranslateArgs>(argsKey);
 
-        vector<id_t> hits = world->raycast(args.caller->getGlobalPosition() + (args.caller->getGlobalBounds().size / 2.f), evtArgs.direction, 1, (args.caller->getGlobalBounds().size / 2.f).x + evtArgs.speed * time.getDeltaSec());
+        vector<id_t> hits = world->raycast(args.caller->getGlobalPosition() + (args.caller->getGlobalBounds().size / 2.f), evtArgs.direction, 1, (args.caller->getGlobalBounds().size / 2.f).x + evtArgs.speed * time->getDeltaSec());
         if (hits.size() <= 0) {
-            V2f delta = evtArgs.direction * evtArgs.speed * time.getDeltaSec();
+            V2f delta = evtArgs.direction * evtArgs.speed * time->getDeltaSec();
             args.caller->translate(delta, true);
             if (evtArgs.viewBound) {
-                renderer.getCurrentCamera()->move(Vector3f({ delta.x,delta.y,0 }));
+                renderer->getCurrentCamera()->move(Vector3f({ delta.x,delta.y,0 }));
             }
         }
-        args.caller->callScriptsWithData("OnTranslate", map<string, any>({ {"evt",evtArgs.direction} }));
+        DataMap translateData;
+        translateData.setData(evtKey, evtArgs.direction);
+        args.caller->callScriptsWithData("OnTranslate", translateData);
     };
 
     ScriptEvent rotateEvent = [](ScArgs args) {
         if (world->consoleInputEnabled) return;
         //Re-readable input
-        RotateArgs evtArgs = args.script->getInput().getData<RotateArgs>("args");
+        RotateArgs evtArgs = args.script->getInput().getData<RotateArgs>(argsKey);
 
-            Angle delta = degrees(evtArgs.degreesPerSecond * time.getDeltaSec());
+            Angle delta = degrees(evtArgs.degreesPerSecond * time->getDeltaSec());
             args.caller->rotate(delta);
             if (evtArgs.viewBound) {
                 screen->rotateView(delta);
             }
-            args.caller->callScriptsWithData("OnRotate", map<string, any>({ {"evt",evtArgs.degreesPerSecond} }));
+            DataMap rotateData;
+            rotateData.setData(evtKey, evtArgs.degreesPerSecond);
+            args.caller->callScriptsWithData("OnRotate", rotateData);
     };
 
 	ScriptEvent keyboardMovementController = [](ScArgs args) {
             //float moveSpeed = args.script->pullOutInput<float>();
-            float moveSpeed = args.script->getInput().getData<float>("speed");
+            float moveSpeed = args.script->getInput().getData<float>(speedKey);
             InputKeyMap horizonalKeyMap = InputKeyMap(Keyboard::Scan::D, Keyboard::Scan::A);
             InputKeyMap verticalKeyMap = InputKeyMap();
 
@@ -70,7 +81,7 @@ namespace CGEngine {
 
     ScriptEvent keyboardRotationController = [](ScArgs args) {
         //float rotateSpeed = args.script->pullOutInput<float>();
-        float rotateSpeed = args.script->getInput().getData<float>("speed");
+        float rotateSpeed = args.script->getInput().getData<float>(speedKey);
 
         Script* translateRightScript = new Script(rotateEvent);
         translateRightScript->setInput(map<string, any>({ {"args", RotateArgs(rotateSpeed, false) } }));